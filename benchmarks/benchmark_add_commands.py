@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2019 Max Planck Gesellschaft
+# Author : Vincent Berenz
+
+"""
+Measures the number of commands per second a python frontend may
+buffer and send to a standalone (running a synthetic driver), first
+with one call to add_command per command, then with a single call to
+add_commands per batch of commands, the commands being provided as
+numpy arrays (dofs, target values and durations).
+"""
+
+import argparse
+import time
+
+import numpy as np
+
+import o80
+import o80_synthetic
+
+SEGMENT_ID = "o80_benchmark_add_commands"
+NB_ACTUATORS = 8
+
+
+def one_by_one(frontend, rounds, dofs, values, durations):
+    start = time.perf_counter()
+    for _ in range(rounds):
+        for dof, value, duration in zip(dofs, values, durations):
+            frontend.add_command(
+                int(dof),
+                o80.State1d(float(value)),
+                o80.Duration_us.microseconds(int(duration)),
+                o80.Mode.OVERWRITE,
+            )
+        frontend.pulse()
+    return time.perf_counter() - start
+
+
+def bulk(frontend, rounds, dofs, values, durations):
+    start = time.perf_counter()
+    for _ in range(rounds):
+        frontend.add_commands(dofs, values, durations, o80.Mode.OVERWRITE)
+        frontend.pulse()
+    return time.perf_counter() - start
+
+
+def run(rounds, batch, frequency):
+    standalones = o80_synthetic.actuators_8
+    o80.clear_shared_memory(SEGMENT_ID)
+    standalones.start_standalone(
+        SEGMENT_ID, frequency, False, o80.SyntheticDriverConfig()
+    )
+    try:
+        frontend = standalones.FrontEnd(SEGMENT_ID)
+        dofs = np.arange(batch, dtype=np.int32) % NB_ACTUATORS
+        values = np.linspace(0.0, 1.0, batch)
+        durations = np.full(batch, 1000, dtype=np.int64)
+        nb_commands = rounds * batch
+        one_by_one_s = one_by_one(frontend, rounds, dofs, values, durations)
+        bulk_s = bulk(frontend, rounds, dofs, values, durations)
+        print(
+            "\n{} batches of {} commands (standalone at {}Hz)".format(
+                rounds, batch, frequency
+            )
+        )
+        print(
+            "  add_command : {:.0f} commands/s".format(nb_commands / one_by_one_s)
+        )
+        print(
+            "  add_commands: {:.0f} commands/s (speedup: {:.2f})\n".format(
+                nb_commands / bulk_s, one_by_one_s / bulk_s
+            )
+        )
+    finally:
+        standalones.stop_standalone(SEGMENT_ID)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--rounds", type=int, default=100)
+    parser.add_argument("--batch", type=int, default=1000)
+    parser.add_argument("--frequency", type=float, default=500.0)
+    args = parser.parse_args()
+    run(args.rounds, args.batch, args.frequency)
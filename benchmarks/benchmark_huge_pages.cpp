@@ -0,0 +1,114 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "o80/memory_clearing.hpp"
+#include "o80/observation.hpp"
+#include "o80/segment_layout.hpp"
+#include "o80/state1d.hpp"
+#include "o80/time.hpp"
+#include "o80/transport.hpp"
+
+// Per append latency of observations (30 actuators and a 2kB extended
+// state) to a shared region, with and without huge pages and prefaulting
+// (see SegmentLayout::huge_pages and SegmentLayout::prefault). The first
+// pass over the ring includes first touch page faults (unless prefaulted),
+// the second pass overwrites already mapped slots.
+
+#define NB_ACTUATORS 30
+#define QUEUE_SIZE 5000
+#define EXTENDED_SIZE 256
+
+class LargeExtendedState
+{
+public:
+    LargeExtendedState()
+    {
+        values.fill(0);
+    }
+    template <class Archive>
+    void serialize(Archive& archive)
+    {
+        archive(values);
+    }
+    std::array<double, EXTENDED_SIZE> values;
+};
+
+typedef o80::Transport<NB_ACTUATORS, o80::State1d, LargeExtendedState>
+    RegionTransport;
+typedef o80::SharedRegionTransport<NB_ACTUATORS,
+                                   o80::State1d,
+                                   LargeExtendedState>
+    SharedRegionTransport;
+typedef o80::Observation<NB_ACTUATORS, o80::State1d, LargeExtendedState>
+    LargeObservation;
+
+// appends QUEUE_SIZE observations and returns the
+// duration (nanoseconds) of each append
+std::vector<long int> append_pass(RegionTransport& transport,
+                                  const LargeObservation& observation)
+{
+    std::vector<long int> durations;
+    durations.reserve(QUEUE_SIZE);
+    for (int append = 0; append < QUEUE_SIZE; append++)
+    {
+        o80::TimePoint start = o80::time_now();
+        transport.observations().append(observation);
+        o80::TimePoint end = o80::time_now();
+        durations.push_back(o80::time_diff(start, end));
+    }
+    std::sort(durations.begin(), durations.end());
+    return durations;
+}
+
+void print_pass(std::string label, const std::vector<long int>& durations)
+{
+    std::cout << "\t" << label << " (us):\tmedian "
+              << durations[durations.size() / 2] / 1000.0 << "\tp99 "
+              << durations[(durations.size() * 99) / 100] / 1000.0
+              << "\tmax " << durations.back() / 1000.0 << "\n";
+}
+
+void measure(std::string label, bool huge_pages, bool prefault)
+{
+    std::string segment_id("o80_benchmark_huge_pages");
+    o80::clear_shared_memory(segment_id);
+
+    o80::SegmentLayout layout(QUEUE_SIZE, QUEUE_SIZE, QUEUE_SIZE, 0);
+    layout.huge_pages = huge_pages;
+    layout.prefault = prefault;
+    std::shared_ptr<RegionTransport> transport = RegionTransport::create(
+        segment_id, o80::SHARED_REGION, true, layout);
+    const o80::internal::SharedRegion& region =
+        std::dynamic_pointer_cast<SharedRegionTransport>(transport)
+            ->get_region();
+
+    LargeObservation observation;
+    std::vector<long int> first = append_pass(*transport, observation);
+    std::vector<long int> second = append_pass(*transport, observation);
+
+    std::cout << label << "\n"
+              << "\tregion size (MB):\t\t" << region.size() / 1e6 << "\n"
+              << "\thugetlbfs pages:\t\t"
+              << (region.has_huge_pages() ? "yes" : "no") << "\n"
+              << "\tlocked:\t\t\t\t" << (region.is_locked() ? "yes" : "no")
+              << "\n";
+    print_pass("first pass", first);
+    print_pass("second pass", second);
+
+    transport.reset();
+    o80::clear_shared_memory(segment_id);
+}
+
+int main()
+{
+    measure("regular pages", false, false);
+    measure("regular pages, prefaulted", false, true);
+    measure("huge pages", true, false);
+    measure("huge pages, prefaulted", true, true);
+}
@@ -0,0 +1,142 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "o80/driver.hpp"
+#include "o80/memory_clearing.hpp"
+#include "o80/standalone.hpp"
+#include "o80/state1d.hpp"
+#include "o80/time.hpp"
+#include "o80/void_extended_state.hpp"
+
+// Compares a standalone calling the driver sequentially with a
+// standalone running the driver in a pipelined I/O thread.
+// The driver simulates slow bus I/O (sleeping in get and set),
+// and the standalone simulates a costly computation (busy waiting
+// in convert). Reported:
+// - throughput: iterations per second (the standalone runs as fast
+//   as possible)
+// - latency: time between the end of the driver's get and the
+//   start of the driver's set applying the corresponding action
+
+#define NB_ITERATIONS 2000
+#define GET_US 150
+#define SET_US 100
+#define COMPUTE_US 200
+
+void busy_wait(long int us)
+{
+    o80::TimePoint start = o80::time_now();
+    while (o80::time_diff_us(start, o80::time_now()) < us)
+    {
+    }
+}
+
+// sensor readings and actions are time stamps (nanoseconds since
+// the start of the benchmark) of the sensor reading they derive from
+class SlowIODriver : public o80::Driver<long int, long int>
+{
+public:
+    SlowIODriver() : start_(o80::time_now())
+    {
+        latencies_ns.reserve(NB_ITERATIONS + 2);
+    }
+    void start()
+    {
+    }
+    void stop()
+    {
+    }
+    void set(const long int& stamp)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(SET_US));
+        latencies_ns.push_back(o80::time_diff(start_, o80::time_now()) -
+                               stamp);
+    }
+    long int get()
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(GET_US));
+        return o80::time_diff(start_, o80::time_now());
+    }
+
+public:
+    std::vector<long int> latencies_ns;
+
+private:
+    o80::TimePoint start_;
+};
+
+class SlowComputeStandalone : public o80::Standalone<500,
+                                                     1,
+                                                     SlowIODriver,
+                                                     o80::State1d,
+                                                     o80::VoidExtendedState>
+{
+public:
+    SlowComputeStandalone(std::shared_ptr<SlowIODriver> driver_ptr,
+                          std::string segment_id)
+        : o80::Standalone<500,
+                          1,
+                          SlowIODriver,
+                          o80::State1d,
+                          o80::VoidExtendedState>(driver_ptr, 1e9, segment_id),
+          stamp_(0)
+    {
+    }
+    o80::States<1, o80::State1d> convert(const long int& stamp)
+    {
+        stamp_ = stamp;
+        return o80::States<1, o80::State1d>();
+    }
+    long int convert(const o80::States<1, o80::State1d>& /*states*/)
+    {
+        busy_wait(COMPUTE_US);
+        return stamp_;
+    }
+
+private:
+    long int stamp_;
+};
+
+void run(std::string label, bool pipelined)
+{
+    std::string segment_id("o80_benchmark_pipelined_io");
+    o80::clear_shared_memory(segment_id);
+    std::shared_ptr<SlowIODriver> driver = std::make_shared<SlowIODriver>();
+    std::vector<long int> latencies_ns;
+    long int duration_us;
+    {
+        SlowComputeStandalone standalone(driver, segment_id);
+        standalone.set_pipelined_io(pipelined);
+        standalone.start();
+        o80::TimePoint start = o80::time_now();
+        for (int iteration = 0; iteration < NB_ITERATIONS; iteration++)
+        {
+            standalone.spin();
+        }
+        duration_us = o80::time_diff_us(start, o80::time_now());
+        standalone.stop();
+        latencies_ns = driver->latencies_ns;
+    }
+    std::sort(latencies_ns.begin(), latencies_ns.end());
+    std::cout << label << "\n"
+              << "\tthroughput (iterations per second):\t"
+              << (NB_ITERATIONS * 1e6) / static_cast<double>(duration_us)
+              << "\n"
+              << "\tmedian latency (microseconds):\t\t"
+              << latencies_ns[latencies_ns.size() / 2] / 1000.0 << "\n";
+}
+
+int main()
+{
+    std::cout << "driver get: " << GET_US << "us, driver set: " << SET_US
+              << "us, computation: " << COMPUTE_US << "us\n";
+    run("sequential", false);
+    run("pipelined", true);
+}
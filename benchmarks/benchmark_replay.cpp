@@ -0,0 +1,125 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#include <unistd.h>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include "o80/back_end.hpp"
+#include "o80/command_replay.hpp"
+#include "o80/front_end.hpp"
+#include "o80/state1d.hpp"
+#include "o80/void_extended_state.hpp"
+
+// Records a session of a backend (8 actuators, a frontend in the same
+// process sending a mix of direct, duration, speed and iteration commands
+// in queue and overwrite modes), then replays the recording into a new
+// backend as fast as possible: reports the number of iterations per
+// second of the backend in isolation, and checks the replayed desired
+// states are identical to the recorded ones.
+// usage: o80_benchmark_replay [nb_iterations] [path of the recording]
+
+#define QUEUE_SIZE 20000
+#define NB_ACTUATORS 8
+#define PERIOD_US 1000
+#define SEGMENT_ID "o80_benchmark_replay"
+
+typedef o80::BackEnd<QUEUE_SIZE,
+                     NB_ACTUATORS,
+                     o80::State1d,
+                     o80::VoidExtendedState>
+    Backend;
+typedef o80::FrontEnd<QUEUE_SIZE,
+                      NB_ACTUATORS,
+                      o80::State1d,
+                      o80::VoidExtendedState>
+    Frontend;
+
+void add_commands(Frontend& frontend, long int iteration)
+{
+    o80::Mode mode = (iteration / 100) % 2 ? o80::QUEUE : o80::OVERWRITE;
+    for (int dof = 0; dof < NB_ACTUATORS; dof++)
+    {
+        o80::State1d target(static_cast<double>((iteration + dof) % 17));
+        switch ((iteration / 10 + dof) % 4)
+        {
+            case 0:
+                frontend.add_command(dof, target, mode);
+                break;
+            case 1:
+                frontend.add_command(dof,
+                                     target,
+                                     o80::Duration_us::milliseconds(5 + dof),
+                                     mode);
+                break;
+            case 2:
+                frontend.add_command(
+                    dof, target, o80::Speed::per_second(200 + dof), mode);
+                break;
+            case 3:
+                frontend.add_command(
+                    dof, target, o80::Iteration(10 + dof, true), mode);
+                break;
+        }
+    }
+}
+
+void record(const std::string& path, long int nb_iterations)
+{
+    Backend backend(SEGMENT_ID, false, PERIOD_US, o80::IN_PROCESS);
+    Frontend frontend(SEGMENT_ID, o80::IN_PROCESS);
+    // iterations run faster than the file is written: the ring
+    // buffers all of them
+    backend.start_recording(path, nb_iterations);
+    o80::States<NB_ACTUATORS, o80::State1d> states;
+    o80::VoidExtendedState extended_state;
+    for (long int iteration = 0; iteration < nb_iterations; iteration++)
+    {
+        // a new batch of commands every 10 iterations
+        if (iteration % 10 == 0)
+        {
+            add_commands(frontend, iteration);
+            frontend.pulse();
+        }
+        o80::TimePoint now(static_cast<long int>(iteration * PERIOD_US * 1e3));
+        // the robot reaching the desired states
+        states = backend.pulse(now, states, extended_state);
+    }
+    long int nb_dropped = backend.stop_recording();
+    if (nb_dropped > 0)
+    {
+        std::cout << nb_dropped << " iterations not recorded" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    long int nb_iterations = 100000;
+    std::string path = std::string("/tmp/o80_benchmark_replay_") +
+                       std::to_string(getpid()) + std::string(".rec");
+    if (argc > 1)
+    {
+        nb_iterations = std::stol(argv[1]);
+    }
+    if (argc > 2)
+    {
+        path = argv[2];
+    }
+
+    std::cout << "\nrecording " << nb_iterations << " iterations to " << path
+              << "\n";
+    record(path, nb_iterations);
+
+    o80::ReplayReport report =
+        o80::replay_commands<QUEUE_SIZE,
+                             NB_ACTUATORS,
+                             o80::State1d,
+                             o80::VoidExtendedState>(path);
+    std::cout << "replay: " << report.to_string() << "\n\n";
+
+    if (argc <= 2)
+    {
+        std::remove(path.c_str());
+    }
+    return report.nb_mismatches == 0 ? 0 : 1;
+}
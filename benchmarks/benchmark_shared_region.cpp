@@ -0,0 +1,204 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "o80/back_end.hpp"
+#include "o80/front_end.hpp"
+#include "o80/memory_clearing.hpp"
+#include "o80/observer_front_end.hpp"
+#include "o80/state1d.hpp"
+#include "o80/time.hpp"
+#include "o80/void_extended_state.hpp"
+
+// Compares the shared memory transport (one segment per time series)
+// and the shared region transport (a single segment) for:
+// - the time required by a frontend (and by an observer frontend)
+//   to attach to a running backend
+// - the number of memory mappings created by the process
+// - the dTLB read misses (if performance counters are available) and
+//   the duration of reading observation histories
+
+#define QUEUE_SIZE 5000
+#define NB_ACTUATORS 30
+#define NB_ATTACHES 200
+#define NB_READS 200
+#define HISTORY 1000
+
+typedef o80::BackEnd<QUEUE_SIZE,
+                     NB_ACTUATORS,
+                     o80::State1d,
+                     o80::VoidExtendedState>
+    Backend;
+typedef o80::FrontEnd<QUEUE_SIZE,
+                      NB_ACTUATORS,
+                      o80::State1d,
+                      o80::VoidExtendedState>
+    Frontend;
+typedef o80::ObserverFrontEnd<NB_ACTUATORS, o80::State1d, o80::VoidExtendedState>
+    Observer;
+
+// number of lines of /proc/self/maps
+int count_mappings()
+{
+    std::ifstream maps("/proc/self/maps");
+    std::string line;
+    int nb_mappings = 0;
+    while (std::getline(maps, line))
+    {
+        nb_mappings++;
+    }
+    return nb_mappings;
+}
+
+// median attach time (in nanoseconds) and number of mappings
+// created by an instance of Reader
+template <class Reader>
+std::pair<long int, int> attach(std::string segment_id,
+                                o80::TransportType transport)
+{
+    std::vector<long int> attach_ns;
+    int nb_mappings = 0;
+    for (int attach = 0; attach < NB_ATTACHES; attach++)
+    {
+        int mappings_before = count_mappings();
+        o80::TimePoint start = o80::time_now();
+        Reader reader(segment_id, transport);
+        o80::TimePoint end = o80::time_now();
+        nb_mappings = count_mappings() - mappings_before;
+        attach_ns.push_back(o80::time_diff(start, end));
+    }
+    std::sort(attach_ns.begin(), attach_ns.end());
+    return std::make_pair(attach_ns[attach_ns.size() / 2], nb_mappings);
+}
+
+// dTLB read misses of the calling thread, or -1 if performance
+// counters are not available
+class TlbMisses
+{
+public:
+    TlbMisses()
+    {
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+        attributes.type = PERF_TYPE_HW_CACHE;
+        attributes.size = sizeof(attributes);
+        attributes.config = PERF_COUNT_HW_CACHE_DTLB |
+                            (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attributes.disabled = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        fd_ = syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0);
+    }
+
+    ~TlbMisses()
+    {
+        if (fd_ >= 0)
+        {
+            close(fd_);
+        }
+    }
+
+    void start()
+    {
+        if (fd_ >= 0)
+        {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    long long stop()
+    {
+        if (fd_ < 0)
+        {
+            return -1;
+        }
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        long long count;
+        if (read(fd_, &count, sizeof(count)) != sizeof(count))
+        {
+            return -1;
+        }
+        return count;
+    }
+
+private:
+    int fd_;
+};
+
+void measure(std::string label,
+             std::string segment_id,
+             o80::TransportType transport)
+{
+    o80::clear_shared_memory(segment_id);
+    Backend backend(segment_id, false, -1, transport);
+
+    // filling the observations history
+    o80::States<NB_ACTUATORS, o80::State1d> states;
+    o80::VoidExtendedState extended_state;
+    for (int iteration = 0; iteration < HISTORY; iteration++)
+    {
+        backend.pulse(o80::time_now(), states, extended_state);
+    }
+
+    std::pair<long int, int> frontend_attach =
+        attach<Frontend>(segment_id, transport);
+    std::pair<long int, int> observer_attach =
+        attach<Observer>(segment_id, transport);
+
+    // reading observations
+    Frontend frontend(segment_id, transport);
+    TlbMisses tlb_misses;
+    tlb_misses.start();
+    o80::TimePoint start = o80::time_now();
+    std::size_t nb_read = 0;
+    for (int read = 0; read < NB_READS; read++)
+    {
+        nb_read += frontend.get_latest_observations(HISTORY).size();
+    }
+    o80::TimePoint end = o80::time_now();
+    long long misses = tlb_misses.stop();
+
+    std::cout << label << "\n"
+              << "\tfrontend attach (median, us):\t"
+              << frontend_attach.first / 1000.0 << "\n"
+              << "\tmappings per frontend:\t\t" << frontend_attach.second
+              << "\n"
+              << "\tobserver attach (median, us):\t"
+              << observer_attach.first / 1000.0 << "\n"
+              << "\tmappings per observer:\t\t" << observer_attach.second
+              << "\n"
+              << "\tobservation read (us):\t\t"
+              << o80::time_diff(start, end) / 1000.0 / nb_read << "\n"
+              << "\tdTLB misses per observation:\t";
+    if (misses < 0)
+    {
+        std::cout << "(performance counters not available)\n";
+    }
+    else
+    {
+        std::cout << static_cast<double>(misses) / nb_read << "\n";
+    }
+}
+
+int main()
+{
+    measure("shared memory",
+            "o80_benchmark_shared_region_sm",
+            o80::SHARED_MEMORY);
+    measure("shared region",
+            "o80_benchmark_shared_region_sr",
+            o80::SHARED_REGION);
+}
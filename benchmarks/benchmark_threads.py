@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2019 Max Planck Gesellschaft
+# Author : Vincent Berenz
+
+"""
+Measures the concurrency of python threads using o80 frontends of
+several segments. One standalone (running a synthetic driver) is
+started per segment. For each segment, a frontend sends duration
+commands and waits for their completion (pulse_and_wait), first for all
+the segments one after the other in a single thread, then with one
+thread per segment. As the blocking methods of the frontends release
+the GIL, the threads wait concurrently, and the duration of the threaded
+run should be close to the one of a single segment.
+"""
+
+import argparse
+import threading
+import time
+
+import o80
+import o80_synthetic
+
+SEGMENT_ID = "o80_benchmark_threads_"
+
+
+def command_and_wait(frontend, rounds, duration_ms):
+    for r in range(rounds):
+        frontend.add_command(
+            0,
+            o80.State1d(float(r % 2)),
+            o80.Duration_us.milliseconds(duration_ms),
+            o80.Mode.OVERWRITE,
+        )
+        frontend.pulse_and_wait()
+
+
+def sequential(frontends, rounds, duration_ms):
+    start = time.perf_counter()
+    for frontend in frontends:
+        command_and_wait(frontend, rounds, duration_ms)
+    return time.perf_counter() - start
+
+
+def threaded(frontends, rounds, duration_ms):
+    threads = [
+        threading.Thread(
+            target=command_and_wait, args=(frontend, rounds, duration_ms)
+        )
+        for frontend in frontends
+    ]
+    start = time.perf_counter()
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    return time.perf_counter() - start
+
+
+def run(nb_segments, rounds, duration_ms, frequency):
+    standalones = o80_synthetic.actuators_1
+    segment_ids = [SEGMENT_ID + str(index) for index in range(nb_segments)]
+    for segment_id in segment_ids:
+        o80.clear_shared_memory(segment_id)
+        standalones.start_standalone(
+            segment_id, frequency, False, o80.SyntheticDriverConfig()
+        )
+    try:
+        frontends = [standalones.FrontEnd(segment_id) for segment_id in segment_ids]
+        expected = rounds * duration_ms / 1000.0
+        sequential_s = sequential(frontends, rounds, duration_ms)
+        threaded_s = threaded(frontends, rounds, duration_ms)
+        print(
+            "\n{} segments, {} commands of {}ms per segment "
+            "(standalones at {}Hz)".format(
+                nb_segments, rounds, duration_ms, frequency
+            )
+        )
+        print("  single segment (expected): {:.3f}s".format(expected))
+        print("  sequential               : {:.3f}s".format(sequential_s))
+        print(
+            "  one thread per segment   : {:.3f}s (speedup: {:.2f})\n".format(
+                threaded_s, sequential_s / threaded_s
+            )
+        )
+    finally:
+        for segment_id in segment_ids:
+            standalones.stop_standalone(segment_id)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--segments", type=int, default=4)
+    parser.add_argument("--rounds", type=int, default=20)
+    parser.add_argument("--duration-ms", type=int, default=20)
+    parser.add_argument("--frequency", type=float, default=500.0)
+    args = parser.parse_args()
+    run(args.segments, args.rounds, args.duration_ms, args.frequency)
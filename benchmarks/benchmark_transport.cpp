@@ -0,0 +1,102 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "o80/back_end.hpp"
+#include "o80/front_end.hpp"
+#include "o80/memory_clearing.hpp"
+#include "o80/state1d.hpp"
+#include "o80/time.hpp"
+#include "o80/void_extended_state.hpp"
+
+// Measures the end to end latency of a frontend / backend round trip
+// (frontend shares a command, backend executes it, frontend receives
+// the corresponding completion report) for all transport types.
+// The backend iterates as fast as possible in a dedicated thread, so
+// that the measured latency is dominated by the transport.
+
+#define QUEUE_SIZE 5000
+#define NB_ACTUATORS 2
+#define NB_ROUND_TRIPS 2000
+
+typedef o80::BackEnd<QUEUE_SIZE,
+                     NB_ACTUATORS,
+                     o80::State1d,
+                     o80::VoidExtendedState>
+    Backend;
+typedef o80::FrontEnd<QUEUE_SIZE,
+                      NB_ACTUATORS,
+                      o80::State1d,
+                      o80::VoidExtendedState>
+    Frontend;
+
+std::vector<long int> measure(std::string segment_id,
+                              o80::TransportType transport)
+{
+    o80::clear_shared_memory(segment_id);
+
+    std::vector<long int> latencies_ns;
+    latencies_ns.reserve(NB_ROUND_TRIPS);
+
+    Backend backend(segment_id, false, -1, transport);
+    std::atomic<bool> running(true);
+    std::thread backend_thread([&backend, &running]() {
+        o80::States<NB_ACTUATORS, o80::State1d> states;
+        o80::VoidExtendedState extended_state;
+        while (running)
+        {
+            backend.pulse(o80::time_now(), states, extended_state);
+        }
+    });
+
+    Frontend frontend(segment_id, transport);
+    for (int round_trip = 0; round_trip < NB_ROUND_TRIPS; round_trip++)
+    {
+        o80::TimePoint start = o80::time_now();
+        frontend.add_command(
+            0, o80::State1d(static_cast<double>(round_trip)), o80::OVERWRITE);
+        frontend.pulse_and_wait();
+        o80::TimePoint end = o80::time_now();
+        latencies_ns.push_back(o80::time_diff(start, end));
+    }
+
+    running = false;
+    backend_thread.join();
+
+    std::sort(latencies_ns.begin(), latencies_ns.end());
+    return latencies_ns;
+}
+
+void report(std::string label, const std::vector<long int>& latencies_ns)
+{
+    long int total = 0;
+    for (long int latency : latencies_ns)
+    {
+        total += latency;
+    }
+    auto percentile = [&latencies_ns](double p) {
+        return latencies_ns[static_cast<std::size_t>(
+            p * static_cast<double>(latencies_ns.size() - 1))];
+    };
+    std::cout << label << " (" << latencies_ns.size()
+              << " round trips, microseconds)\n"
+              << "\tmean:\t" << (total / latencies_ns.size()) / 1000.0 << "\n"
+              << "\tmedian:\t" << percentile(0.5) / 1000.0 << "\n"
+              << "\tp99:\t" << percentile(0.99) / 1000.0 << "\n"
+              << "\tmax:\t" << latencies_ns.back() / 1000.0 << "\n";
+}
+
+int main()
+{
+    report("shared memory",
+           measure("o80_benchmark_transport_sm", o80::SHARED_MEMORY));
+    report("in process",
+           measure("o80_benchmark_transport_ip", o80::IN_PROCESS));
+    report("shared region",
+           measure("o80_benchmark_transport_sr", o80::SHARED_REGION));
+}
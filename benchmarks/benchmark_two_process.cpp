@@ -0,0 +1,429 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "o80/command_trace.hpp"
+#include "o80/driver.hpp"
+#include "o80/front_end.hpp"
+#include "o80/memory_clearing.hpp"
+#include "o80/standalone.hpp"
+#include "o80/state1d.hpp"
+#include "o80/time.hpp"
+#include "o80/void_extended_state.hpp"
+#include "o80_internal/segment_status.hpp"
+
+// Measures the full path of a command between two processes: the
+// frontend adds commands and pulses in this process, the backend of
+// a standalone (running a dummy driver in a forked process) picks them
+// up and applies the corresponding desired states, and the frontend
+// sees the corresponding observation. Swept: frequency of the
+// standalone, number of actuators, commands per pulse and wait
+// strategy of the frontend:
+// - completion: pulse_and_wait (returns once the backend reported
+//   the completion of the commands)
+// - next: pulse, then wait_for_next until the observation applying
+//   the commands
+// - poll: pulse, then busy reading of the latest observation until
+//   the one applying the commands
+// Reported (microseconds):
+// - pickup: from the frontend sharing the commands to the start of the
+//   backend iteration applying them (next and poll only)
+// - visible: from the frontend adding the commands to the frontend
+//   seeing their effect
+// The transport (shared memory by default, or shared region) is
+// passed as argument.
+// Then, for each frequency and number of actuators, the rate of
+// commands sent by the frontend (pulsing every millisecond) is doubled
+// until it can not be sustained, either because the commands exchange
+// is full (i.e. size_check throws) or because the frontend can not
+// send commands faster.
+
+#define QUEUE_SIZE 10000
+#define NB_ROUNDS 200
+// duration of each step of the throughput ramp
+#define RAMP_STEP_S 0.5
+#define RAMP_PULSE_PERIOD_US 1000
+#define MAX_RATE 1e8
+
+static const std::vector<double> FREQUENCIES = {1000, 4000};
+static const std::vector<int> COMMANDS_PER_PULSE = {1, 16};
+static const std::vector<std::string> STRATEGIES = {
+    "completion", "next", "poll"};
+
+template <int NB_ACTUATORS>
+class EchoDriver : public o80::Driver<std::vector<double>, std::vector<double>>
+{
+public:
+    EchoDriver() : values_(NB_ACTUATORS, 0.)
+    {
+    }
+    void start()
+    {
+    }
+    void stop()
+    {
+    }
+    void set(const std::vector<double>& values)
+    {
+        values_ = values;
+    }
+    std::vector<double> get()
+    {
+        return values_;
+    }
+
+private:
+    std::vector<double> values_;
+};
+
+template <int NB_ACTUATORS>
+class EchoStandalone : public o80::Standalone<QUEUE_SIZE,
+                                              NB_ACTUATORS,
+                                              EchoDriver<NB_ACTUATORS>,
+                                              o80::State1d,
+                                              o80::VoidExtendedState>
+{
+public:
+    EchoStandalone(std::shared_ptr<EchoDriver<NB_ACTUATORS>> driver_ptr,
+                   double frequency,
+                   std::string segment_id,
+                   o80::TransportType transport)
+        : o80::Standalone<QUEUE_SIZE,
+                          NB_ACTUATORS,
+                          EchoDriver<NB_ACTUATORS>,
+                          o80::State1d,
+                          o80::VoidExtendedState>(
+              driver_ptr, frequency, segment_id, transport)
+    {
+    }
+    o80::States<NB_ACTUATORS, o80::State1d> convert(
+        const std::vector<double>& values)
+    {
+        o80::States<NB_ACTUATORS, o80::State1d> states;
+        for (int dof = 0; dof < NB_ACTUATORS; dof++)
+        {
+            states.values[dof].value = values[dof];
+        }
+        return states;
+    }
+    std::vector<double> convert(
+        const o80::States<NB_ACTUATORS, o80::State1d>& states)
+    {
+        std::vector<double> values(NB_ACTUATORS);
+        for (int dof = 0; dof < NB_ACTUATORS; dof++)
+        {
+            values[dof] = states.values[dof].value;
+        }
+        return values;
+    }
+};
+
+// runs the standalone in a child process, until please_stop is called
+template <int NB_ACTUATORS>
+pid_t fork_standalone(const std::string& segment_id,
+                      double frequency,
+                      o80::TransportType transport)
+{
+    pid_t pid = fork();
+    if (pid != 0)
+    {
+        return pid;
+    }
+    int status = 0;
+    try
+    {
+        auto driver = std::make_shared<EchoDriver<NB_ACTUATORS>>();
+        EchoStandalone<NB_ACTUATORS> standalone(
+            driver, frequency, segment_id, transport);
+        standalone.start();
+        while (standalone.spin())
+        {
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "standalone: " << e.what() << "\n";
+        status = 1;
+    }
+    _exit(status);
+}
+
+// waits for the backend of the child process to iterate
+void wait_for_backend(const std::string& segment_id, pid_t pid)
+{
+    o80::TimePoint start = o80::time_now();
+    while (o80::time_diff_us(start, o80::time_now()) < 10000000)
+    {
+        try
+        {
+            o80::internal::SegmentStatus status(segment_id, true);
+            if (status.record().pid == pid &&
+                status.record().iteration.load() > 0)
+            {
+                return;
+            }
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+        usleep(1000);
+    }
+    throw std::runtime_error("the standalone did not start");
+}
+
+std::string stats(const o80::LatencyStats& s)
+{
+    char line[128];
+    std::snprintf(line,
+                  sizeof(line),
+                  "%8.1f %8.1f %8.1f %8.1f",
+                  s.median,
+                  s.p90,
+                  s.p99,
+                  s.max);
+    return std::string(line);
+}
+
+template <int NB_ACTUATORS>
+void measure_latencies(const std::string& segment_id,
+                       o80::TransportType transport,
+                       double frequency,
+                       int commands_per_pulse,
+                       const std::string& strategy)
+{
+    typedef o80::FrontEnd<QUEUE_SIZE,
+                          NB_ACTUATORS,
+                          o80::State1d,
+                          o80::VoidExtendedState>
+        Frontend;
+    Frontend frontend(segment_id, transport);
+    std::vector<double> pickup_us;
+    std::vector<double> visible_us;
+    // the last command of a pulse is applied once all the
+    // others have been
+    int last_dof = (commands_per_pulse - 1) % NB_ACTUATORS;
+    for (int round = 0; round < NB_ROUNDS; round++)
+    {
+        double base = static_cast<double>((round + 1) * commands_per_pulse);
+        double last_value = base + commands_per_pulse - 1;
+        if (strategy == "next")
+        {
+            frontend.reset_next_index();
+        }
+        o80::TimePoint start = o80::time_now();
+        for (int command = 0; command < commands_per_pulse; command++)
+        {
+            frontend.add_command(command % NB_ACTUATORS,
+                                 o80::State1d(base + command),
+                                 o80::QUEUE);
+        }
+        if (strategy == "completion")
+        {
+            frontend.pulse_and_wait();
+            visible_us.push_back(
+                o80::time_diff(start, o80::time_now()) / 1000.);
+            continue;
+        }
+        // pickup is measured from the sharing of the commands,
+        // excluding their buffering
+        o80::TimePoint shared = o80::time_now();
+        frontend.pulse();
+        while (true)
+        {
+            auto observation = strategy == "next" ? frontend.wait_for_next()
+                                                  : frontend.read();
+            if (observation.get_desired_states().values[last_dof].value ==
+                last_value)
+            {
+                o80::TimePoint seen = o80::time_now();
+                pickup_us.push_back((observation.get_time_stamp() -
+                                     shared.count()) /
+                                    1000.);
+                visible_us.push_back(o80::time_diff(start, seen) / 1000.);
+                break;
+            }
+        }
+    }
+    char line[256];
+    std::snprintf(line,
+                  sizeof(line),
+                  "%8.0f %9d %9d %-10s ",
+                  frequency,
+                  NB_ACTUATORS,
+                  commands_per_pulse,
+                  strategy.c_str());
+    std::string pickup = pickup_us.empty()
+                             ? std::string(35, ' ')
+                             : stats(o80::LatencyStats(pickup_us));
+    std::cout << line << pickup << "   "
+              << stats(o80::LatencyStats(visible_us)) << std::endl;
+}
+
+template <int NB_ACTUATORS>
+void measure_throughput(const std::string& segment_id,
+                        o80::TransportType transport,
+                        double frequency)
+{
+    typedef o80::FrontEnd<QUEUE_SIZE,
+                          NB_ACTUATORS,
+                          o80::State1d,
+                          o80::VoidExtendedState>
+        Frontend;
+    Frontend frontend(segment_id, transport);
+    double sustained = 0;
+    std::string limit("max rate reached");
+    const double pulses_per_second = 1e6 / RAMP_PULSE_PERIOD_US;
+    for (double rate = pulses_per_second; rate <= MAX_RATE; rate *= 2)
+    {
+        long int per_pulse = static_cast<long int>(rate / pulses_per_second);
+        long int nb_pulses =
+            static_cast<long int>(RAMP_STEP_S * pulses_per_second);
+        long int nb_sent = 0;
+        o80::TimePoint start = o80::time_now();
+        try
+        {
+            for (long int pulse = 0; pulse < nb_pulses; pulse++)
+            {
+                for (long int command = 0; command < per_pulse; command++)
+                {
+                    // overwriting, so that the queues of the
+                    // controllers do not grow
+                    frontend.add_command(command % NB_ACTUATORS,
+                                         o80::State1d(command),
+                                         o80::OVERWRITE);
+                }
+                frontend.pulse();
+                nb_sent += per_pulse;
+                long int next_us = (pulse + 1) * RAMP_PULSE_PERIOD_US;
+                long int elapsed_us =
+                    o80::time_diff_us(start, o80::time_now());
+                if (next_us > elapsed_us)
+                {
+                    usleep(next_us - elapsed_us);
+                }
+            }
+        }
+        catch (const std::runtime_error& e)
+        {
+            limit = std::string("size_check: ") + e.what();
+            break;
+        }
+        double achieved =
+            nb_sent / (o80::time_diff(start, o80::time_now()) / 1e9);
+        if (achieved < 0.9 * rate)
+        {
+            limit = "frontend saturated";
+            sustained = std::max(sustained, achieved);
+            break;
+        }
+        sustained = achieved;
+    }
+    char line[256];
+    std::snprintf(line,
+                  sizeof(line),
+                  "%8.0f %9d %14.0f   %s",
+                  frequency,
+                  NB_ACTUATORS,
+                  sustained,
+                  limit.c_str());
+    std::cout << line << std::endl;
+}
+
+template <int NB_ACTUATORS>
+void run(o80::TransportType transport, double frequency, bool throughput)
+{
+    std::string segment_id("o80_benchmark_two_process");
+    o80::clear_shared_memory(segment_id);
+    pid_t pid =
+        fork_standalone<NB_ACTUATORS>(segment_id, frequency, transport);
+    try
+    {
+        wait_for_backend(segment_id, pid);
+        if (throughput)
+        {
+            measure_throughput<NB_ACTUATORS>(
+                segment_id, transport, frequency);
+        }
+        else
+        {
+            for (int commands_per_pulse : COMMANDS_PER_PULSE)
+            {
+                for (const std::string& strategy : STRATEGIES)
+                {
+                    measure_latencies<NB_ACTUATORS>(segment_id,
+                                                    transport,
+                                                    frequency,
+                                                    commands_per_pulse,
+                                                    strategy);
+                }
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << "\n";
+    }
+    o80::please_stop(segment_id);
+    waitpid(pid, nullptr, 0);
+    o80::clear_shared_memory(segment_id);
+}
+
+void run_all(o80::TransportType transport, bool throughput)
+{
+    for (double frequency : FREQUENCIES)
+    {
+        run<1>(transport, frequency, throughput);
+        run<8>(transport, frequency, throughput);
+        run<32>(transport, frequency, throughput);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    o80::TransportType transport = o80::SHARED_MEMORY;
+    std::string arg = argc > 1 ? argv[1] : "shared_memory";
+    if (argc > 2 || (arg != "shared_memory" && arg != "shared_region"))
+    {
+        std::cout << "usage: o80_benchmark_two_process "
+                     "[shared_memory|shared_region]\n";
+        return 1;
+    }
+    if (arg == "shared_region")
+    {
+        transport = o80::SHARED_REGION;
+    }
+    std::cout << "latencies (microseconds, " << NB_ROUNDS
+              << " rounds per line)\n";
+    char header[256];
+    std::snprintf(header,
+                  sizeof(header),
+                  "%-40s%-38s%s\n%8s %9s %9s %-10s %8s %8s %8s %8s   %8s "
+                  "%8s %8s %8s\n",
+                  "",
+                  "pickup",
+                  "visible",
+                  "freq",
+                  "actuators",
+                  "commands",
+                  "strategy",
+                  "p50",
+                  "p90",
+                  "p99",
+                  "max",
+                  "p50",
+                  "p90",
+                  "p99",
+                  "max");
+    std::cout << header;
+    run_all(transport, false);
+    std::cout << "\nsustained throughput (commands per second)\n";
+    std::cout << "    freq actuators     commands/s   limit" << std::endl;
+    run_all(transport, true);
+}
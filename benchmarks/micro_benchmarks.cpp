@@ -0,0 +1,685 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#include <time.h>
+#include <unistd.h>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "o80/back_end.hpp"
+#include "o80/front_end.hpp"
+#include "o80/interpolation.hpp"
+#include "o80/item3d_state.hpp"
+#include "o80/memory_clearing.hpp"
+#include "o80/observation.hpp"
+#include "o80/state1d.hpp"
+#include "o80/state6d.hpp"
+#include "o80/statend.hpp"
+#include "o80/time.hpp"
+#include "o80/transport.hpp"
+#include "o80/void_extended_state.hpp"
+#include "o80_internal/command.hpp"
+#include "o80_internal/controller.hpp"
+#include "o80_internal/controllers_manager.hpp"
+#include "shared_memory/serializer.hpp"
+#include "time_series/time_series.hpp"
+
+// Microbenchmarks of the hot paths of o80: serialization of commands
+// and observations, interpolation, controllers and backend iterations.
+//
+// usage: o80_benchmarks [--filter substring] [--min-time seconds]
+//                       [--json path] [--list]
+//
+// Each benchmark is run with an increasing number of iterations until
+// it lasts at least min-time seconds (default 0.5), and the mean time
+// per iteration is reported. With --json, the results are also written
+// in the JSON format of Google Benchmark (so that its tools, e.g.
+// compare.py, can be used to track regressions across releases).
+
+// measures the real (steady clock) and cpu (thread) time
+// spent between calls to start and stop
+class Timer
+{
+public:
+    Timer() : real_ns(0), cpu_ns(0), real_start_(0), cpu_start_(0)
+    {
+    }
+    void start()
+    {
+        cpu_start_ = cpu_time();
+        real_start_ = o80::time_now().count();
+    }
+    void stop()
+    {
+        real_ns += o80::time_now().count() - real_start_;
+        cpu_ns += cpu_time() - cpu_start_;
+    }
+    long int real_ns;
+    long int cpu_ns;
+
+private:
+    static long int cpu_time()
+    {
+        struct timespec t;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+        return t.tv_sec * 1000000000L + t.tv_nsec;
+    }
+    long int real_start_;
+    long int cpu_start_;
+};
+
+// a benchmark runs the measured code nb_iterations times, calling
+// start and stop of the timer around it (setup excluded)
+typedef std::function<void(long int nb_iterations, Timer& timer)> Measure;
+
+class Benchmark
+{
+public:
+    std::string name;
+    Measure measure;
+};
+
+class Result
+{
+public:
+    std::string name;
+    long int iterations;
+    double real_ns;
+    double cpu_ns;
+};
+
+// prevents the compiler from optimizing away the computation of value
+template <class T>
+void keep(const T& value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+Result run(const Benchmark& benchmark, double min_time_s)
+{
+    const long int min_time_ns = static_cast<long int>(min_time_s * 1e9);
+    const long int max_iterations = 1000000000;
+    long int nb_iterations = 1;
+    while (true)
+    {
+        Timer timer;
+        benchmark.measure(nb_iterations, timer);
+        if (timer.real_ns >= min_time_ns || nb_iterations >= max_iterations)
+        {
+            return Result{benchmark.name,
+                          nb_iterations,
+                          static_cast<double>(timer.real_ns) / nb_iterations,
+                          static_cast<double>(timer.cpu_ns) / nb_iterations};
+        }
+        // aiming slightly above min time, growing at most 10 times
+        double multiplier =
+            1.4 * min_time_ns / std::max(timer.real_ns, long(1));
+        multiplier = std::min(multiplier, 10.);
+        nb_iterations = std::max(
+            static_cast<long int>(nb_iterations * multiplier),
+            nb_iterations + 1);
+        nb_iterations = std::min(nb_iterations, max_iterations);
+    }
+}
+
+/* ----- serialization ----- */
+
+template <class T>
+void serialize(long int nb_iterations, Timer& timer, const T& value)
+{
+    shared_memory::Serializer<T> serializer;
+    timer.start();
+    for (long int i = 0; i < nb_iterations; i++)
+    {
+        const std::string& data = serializer.serialize(value);
+        keep(data);
+    }
+    timer.stop();
+}
+
+template <class T>
+void deserialize(long int nb_iterations, Timer& timer, const T& value)
+{
+    shared_memory::Serializer<T> serializer;
+    std::string data = serializer.serialize(value);
+    T deserialized;
+    timer.start();
+    for (long int i = 0; i < nb_iterations; i++)
+    {
+        serializer.deserialize(data, deserialized);
+        keep(deserialized);
+    }
+    timer.stop();
+}
+
+#define NB_OBSERVED_ACTUATORS 8
+
+template <class STATE>
+o80::Observation<NB_OBSERVED_ACTUATORS, STATE, o80::VoidExtendedState>
+observation(const STATE& state)
+{
+    o80::States<NB_OBSERVED_ACTUATORS, STATE> states;
+    for (int dof = 0; dof < NB_OBSERVED_ACTUATORS; dof++)
+    {
+        states.values[dof] = state;
+    }
+    return o80::Observation<NB_OBSERVED_ACTUATORS,
+                            STATE,
+                            o80::VoidExtendedState>(
+        states, states, o80::VoidExtendedState(), 0, 0, 1000.);
+}
+
+template <class STATE>
+void add_serialization(std::vector<Benchmark>& benchmarks,
+                       const std::string& state_name,
+                       const STATE& state)
+{
+    o80::Command<STATE> command(
+        1, state, o80::Duration_us::milliseconds(10), 0, o80::QUEUE);
+    auto obs = observation(state);
+    benchmarks.push_back(
+        {"serialize/Command<" + state_name + ">",
+         [command](long int n, Timer& t) { serialize(n, t, command); }});
+    benchmarks.push_back(
+        {"deserialize/Command<" + state_name + ">",
+         [command](long int n, Timer& t) { deserialize(n, t, command); }});
+    std::string observation_name = "Observation<" +
+                                   std::to_string(NB_OBSERVED_ACTUATORS) +
+                                   "," + state_name + ">";
+    benchmarks.push_back(
+        {"serialize/" + observation_name,
+         [obs](long int n, Timer& t) { serialize(n, t, obs); }});
+    benchmarks.push_back(
+        {"deserialize/" + observation_name,
+         [obs](long int n, Timer& t) { deserialize(n, t, obs); }});
+}
+
+/* ----- interpolation ----- */
+
+// same values as State6d(first, 2*first, ..., 6*first)
+o80::StateNd<double, 6> state6nd(double first)
+{
+    return o80::StateNd<double, 6>({first,
+                                    2. * first,
+                                    3. * first,
+                                    4. * first,
+                                    5. * first,
+                                    6. * first});
+}
+
+void add_interpolation(std::vector<Benchmark>& benchmarks)
+{
+    // 1 ms per iteration
+    const long int step_ns = 1000000;
+    benchmarks.push_back(
+        {"interpolation/double/speed", [](long int n, Timer& timer) {
+             o80::Speed speed = o80::Speed::per_second(1.);
+             timer.start();
+             for (long int i = 0; i < n; i++)
+             {
+                 o80::TimePoint now(i * step_ns);
+                 double desired = o80::intermediate_state(
+                     o80::TimePoint(0), now, 0., 0., 1e6, speed);
+                 keep(desired);
+             }
+             timer.stop();
+         }});
+    benchmarks.push_back(
+        {"interpolation/double/duration", [](long int n, Timer& timer) {
+             o80::Duration_us duration = o80::Duration_us::seconds(1000000);
+             timer.start();
+             for (long int i = 0; i < n; i++)
+             {
+                 o80::TimePoint now(i * step_ns);
+                 double desired = o80::intermediate_state(
+                     o80::TimePoint(0), now, 0., 0., 1., duration);
+                 keep(desired);
+             }
+             timer.stop();
+         }});
+    benchmarks.push_back(
+        {"interpolation/double/iteration", [](long int n, Timer& timer) {
+             o80::Iteration iteration(1000000000);
+             timer.start();
+             for (long int i = 0; i < n; i++)
+             {
+                 double desired =
+                     o80::intermediate_state(0L, i, 0., 0., 1., iteration);
+                 keep(desired);
+             }
+             timer.stop();
+         }});
+    benchmarks.push_back(
+        {"interpolation/double/finished", [](long int n, Timer& timer) {
+             o80::Speed speed = o80::Speed::per_second(1.);
+             timer.start();
+             for (long int i = 0; i < n; i++)
+             {
+                 o80::TimePoint now(i * step_ns);
+                 bool finished = o80::finished(
+                     o80::TimePoint(0), now, 0., 0., 1e6, speed);
+                 keep(finished);
+             }
+             timer.stop();
+         }});
+}
+
+// interpolation of 6 doubles, to compare State6d (tuple, interpolated
+// attribute per attribute) and StateNd<double, 6> (array)
+template <class STATE>
+void add_state_interpolation(std::vector<Benchmark>& benchmarks,
+                             const std::string& state_name,
+                             const STATE& start,
+                             const STATE& target)
+{
+    // 1 ms per iteration
+    const long int step_ns = 1000000;
+    benchmarks.push_back(
+        {"interpolation/" + state_name + "/speed",
+         [start, target](long int n, Timer& timer) {
+             o80::Speed speed = o80::Speed::per_second(1e-6);
+             timer.start();
+             for (long int i = 0; i < n; i++)
+             {
+                 o80::TimePoint now(i * step_ns);
+                 STATE desired = target.intermediate_state(
+                     o80::TimePoint(0), now, start, start, start, target,
+                     speed);
+                 keep(desired);
+             }
+             timer.stop();
+         }});
+    benchmarks.push_back(
+        {"interpolation/" + state_name + "/duration",
+         [start, target](long int n, Timer& timer) {
+             o80::Duration_us duration = o80::Duration_us::seconds(1000000);
+             timer.start();
+             for (long int i = 0; i < n; i++)
+             {
+                 o80::TimePoint now(i * step_ns);
+                 STATE desired = target.intermediate_state(
+                     o80::TimePoint(0), now, start, start, start, target,
+                     duration);
+                 keep(desired);
+             }
+             timer.stop();
+         }});
+    benchmarks.push_back(
+        {"interpolation/" + state_name + "/iteration",
+         [start, target](long int n, Timer& timer) {
+             o80::Iteration iteration(1000000000);
+             timer.start();
+             for (long int i = 0; i < n; i++)
+             {
+                 STATE desired = target.intermediate_state(
+                     0L, i, start, start, start, target, iteration);
+                 keep(desired);
+             }
+             timer.stop();
+         }});
+}
+
+/* ----- controller ----- */
+
+// steady state of a controller with depth commands queued: at each
+// iteration a direct command is queued and the oldest one is executed
+template <class STATE>
+void controller_queue(long int nb_iterations,
+                      Timer& timer,
+                      int depth,
+                      const STATE& target)
+{
+    time_series::TimeSeries<int> completed(1000);
+    o80::Controller<STATE> controller;
+    controller.set_completed_commands(completed);
+    controller.set_starting_commands(nullptr);
+    o80::Command<STATE> command(1, target, 0, o80::QUEUE);
+    for (int i = 0; i < depth; i++)
+    {
+        controller.set_command(command);
+    }
+    STATE current;
+    STATE previous;
+    o80::TimePoint now(0);
+    timer.start();
+    for (long int i = 0; i < nb_iterations; i++)
+    {
+        controller.set_command(command);
+        const STATE& desired =
+            controller.get_desired_state(i, current, previous, now);
+        keep(desired);
+    }
+    timer.stop();
+}
+
+// controller interpolating a (never ending) duration command,
+// with depth commands queued
+template <class STATE>
+void controller_running(long int nb_iterations,
+                        Timer& timer,
+                        int depth,
+                        const STATE& target)
+{
+    time_series::TimeSeries<int> completed(1000);
+    o80::Controller<STATE> controller;
+    controller.set_completed_commands(completed);
+    controller.set_starting_commands(nullptr);
+    o80::Command<STATE> command(
+        1, target, o80::Duration_us::seconds(1000000), 0, o80::QUEUE);
+    for (int i = 0; i <= depth; i++)
+    {
+        controller.set_command(command);
+    }
+    STATE current;
+    STATE previous;
+    const long int step_ns = 1000000;
+    timer.start();
+    for (long int i = 0; i < nb_iterations; i++)
+    {
+        o80::TimePoint now(i * step_ns);
+        const STATE& desired =
+            controller.get_desired_state(i, current, previous, now);
+        keep(desired);
+    }
+    timer.stop();
+}
+
+template <class STATE>
+void add_controller(std::vector<Benchmark>& benchmarks,
+                    const std::string& state_name,
+                    const STATE& target)
+{
+    for (int depth : {0, 1, 10, 100, 1000})
+    {
+        std::string suffix =
+            state_name + "/depth:" + std::to_string(depth);
+        benchmarks.push_back(
+            {"controller_get_desired_state/queue/" + suffix,
+             [depth, target](long int n, Timer& t) {
+                 controller_queue(n, t, depth, target);
+             }});
+        benchmarks.push_back(
+            {"controller_get_desired_state/running/" + suffix,
+             [depth, target](long int n, Timer& t) {
+                 controller_running(n, t, depth, target);
+             }});
+    }
+}
+
+/* ----- controllers manager ----- */
+
+#define MANAGER_ACTUATORS 8
+#define MANAGER_QUEUE_SIZE 20000
+
+// the manager reads batch_size new (direct) commands, dispatched
+// over all actuators, at each iteration
+void process_commands(long int nb_iterations, Timer& timer, int batch_size)
+{
+    typedef o80::InProcessTransport<MANAGER_ACTUATORS,
+                                    o80::State1d,
+                                    o80::VoidExtendedState>
+        ManagerTransport;
+    ManagerTransport transport(o80::SegmentLayout(MANAGER_QUEUE_SIZE));
+    o80::ControllersManager<MANAGER_ACTUATORS,
+                            MANAGER_QUEUE_SIZE,
+                            o80::State1d>
+        manager(transport, -1);
+    std::vector<o80::Command<o80::State1d>> commands;
+    for (int i = 0; i < batch_size; i++)
+    {
+        commands.push_back(o80::Command<o80::State1d>(
+            0, o80::State1d(i), i % MANAGER_ACTUATORS, o80::QUEUE));
+    }
+    for (long int iteration = 0; iteration < nb_iterations; iteration++)
+    {
+        for (const o80::Command<o80::State1d>& command : commands)
+        {
+            transport.commands().append(command);
+        }
+        transport.set_pulse_id(iteration + 1);
+        timer.start();
+        manager.process_commands(iteration);
+        timer.stop();
+        manager.purge();
+    }
+}
+
+void add_controllers_manager(std::vector<Benchmark>& benchmarks)
+{
+    for (int batch_size : {1, 10, 100, 1000, 10000})
+    {
+        benchmarks.push_back(
+            {"controllers_manager_process_commands/batch:" +
+                 std::to_string(batch_size),
+             [batch_size](long int n, Timer& t) {
+                 process_commands(n, t, batch_size);
+             }});
+    }
+}
+
+/* ----- backend ----- */
+
+#define BACKEND_QUEUE_SIZE 1000
+
+// backend iterations while each actuator interpolates a
+// (never ending) duration command
+template <int NB_ACTUATORS>
+void backend_pulse(long int nb_iterations,
+                   Timer& timer,
+                   o80::TransportType transport)
+{
+    typedef o80::BackEnd<BACKEND_QUEUE_SIZE,
+                         NB_ACTUATORS,
+                         o80::State1d,
+                         o80::VoidExtendedState>
+        Backend;
+    typedef o80::FrontEnd<BACKEND_QUEUE_SIZE,
+                          NB_ACTUATORS,
+                          o80::State1d,
+                          o80::VoidExtendedState>
+        Frontend;
+    std::string segment_id =
+        "o80_benchmarks_" + std::to_string(NB_ACTUATORS);
+    o80::clear_shared_memory(segment_id);
+    {
+        Backend backend(segment_id, false, -1, transport);
+        Frontend frontend(segment_id, transport);
+        o80::States<NB_ACTUATORS, o80::State1d> states;
+        o80::VoidExtendedState extended_state;
+        for (int dof = 0; dof < NB_ACTUATORS; dof++)
+        {
+            frontend.add_command(dof,
+                                 o80::State1d(1.),
+                                 o80::Duration_us::seconds(1000000),
+                                 o80::QUEUE);
+        }
+        frontend.pulse();
+        backend.pulse(o80::time_now(), states, extended_state);
+        timer.start();
+        for (long int i = 0; i < nb_iterations; i++)
+        {
+            const o80::States<NB_ACTUATORS, o80::State1d>& desired =
+                backend.pulse(o80::time_now(), states, extended_state);
+            keep(desired);
+        }
+        timer.stop();
+    }
+    o80::clear_shared_memory(segment_id);
+}
+
+template <int NB_ACTUATORS>
+void add_backend(std::vector<Benchmark>& benchmarks)
+{
+    std::string suffix = "/actuators:" + std::to_string(NB_ACTUATORS);
+    benchmarks.push_back(
+        {"backend_pulse/shared_memory" + suffix, [](long int n, Timer& t) {
+             backend_pulse<NB_ACTUATORS>(n, t, o80::SHARED_MEMORY);
+         }});
+    benchmarks.push_back(
+        {"backend_pulse/in_process" + suffix, [](long int n, Timer& t) {
+             backend_pulse<NB_ACTUATORS>(n, t, o80::IN_PROCESS);
+         }});
+}
+
+/* ----- report ----- */
+
+std::string json_escape(const std::string& s)
+{
+    std::string escaped;
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+void write_json(const std::string& path,
+                const std::string& executable,
+                const std::vector<Result>& results)
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        throw std::runtime_error("o80_benchmarks: failed to open " + path);
+    }
+    char date[64];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%FT%T%z", std::localtime(&now));
+    char host[256] = {0};
+    gethostname(host, sizeof(host) - 1);
+#ifdef NDEBUG
+    std::string build_type("release");
+#else
+    std::string build_type("debug");
+#endif
+    file << "{\n"
+         << "  \"context\": {\n"
+         << "    \"date\": \"" << date << "\",\n"
+         << "    \"host_name\": \"" << json_escape(host) << "\",\n"
+         << "    \"executable\": \"" << json_escape(executable) << "\",\n"
+         << "    \"num_cpus\": " << std::thread::hardware_concurrency()
+         << ",\n"
+         << "    \"library_build_type\": \"" << build_type << "\"\n"
+         << "  },\n"
+         << "  \"benchmarks\": [";
+    for (std::size_t i = 0; i < results.size(); i++)
+    {
+        const Result& result = results[i];
+        file << (i == 0 ? "\n" : ",\n") << "    {\n"
+             << "      \"name\": \"" << json_escape(result.name) << "\",\n"
+             << "      \"run_name\": \"" << json_escape(result.name)
+             << "\",\n"
+             << "      \"run_type\": \"iteration\",\n"
+             << "      \"iterations\": " << result.iterations << ",\n"
+             << "      \"real_time\": " << result.real_ns << ",\n"
+             << "      \"cpu_time\": " << result.cpu_ns << ",\n"
+             << "      \"time_unit\": \"ns\"\n"
+             << "    }";
+    }
+    file << "\n  ]\n}\n";
+}
+
+void usage()
+{
+    std::cout << "usage: o80_benchmarks [--filter substring] "
+                 "[--min-time seconds] [--json path] [--list]\n";
+}
+
+int main(int argc, char* argv[])
+{
+    std::string filter;
+    std::string json_path;
+    double min_time_s = 0.5;
+    bool list = false;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg(argv[i]);
+        if (arg == "--list")
+        {
+            list = true;
+        }
+        else if (i + 1 < argc && arg == "--filter")
+        {
+            filter = argv[++i];
+        }
+        else if (i + 1 < argc && arg == "--json")
+        {
+            json_path = argv[++i];
+        }
+        else if (i + 1 < argc && arg == "--min-time")
+        {
+            min_time_s = std::stod(argv[++i]);
+        }
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+
+    std::vector<Benchmark> benchmarks;
+    add_serialization(benchmarks, "State1d", o80::State1d(1.));
+    add_serialization(
+        benchmarks, "State6d", o80::State6d(1., 2., 3., 4., 5., 6.));
+    add_serialization(benchmarks, "StateNd<double,6>", state6nd(1.));
+    add_serialization(
+        benchmarks, "Item3dState", o80::Item3dState(1., 2., 3., 4., 5., 6.));
+    add_interpolation(benchmarks);
+    add_state_interpolation(benchmarks,
+                            "State6d",
+                            o80::State6d(0., 0., 0., 0., 0., 0.),
+                            o80::State6d(1., 2., 3., 4., 5., 6.));
+    add_state_interpolation(
+        benchmarks, "StateNd<double,6>", state6nd(0.), state6nd(1.));
+    add_controller(benchmarks, "State1d", o80::State1d(1.));
+    add_controller(
+        benchmarks, "State6d", o80::State6d(1., 2., 3., 4., 5., 6.));
+    add_controller(benchmarks, "StateNd<double,6>", state6nd(1.));
+    add_controllers_manager(benchmarks);
+    add_backend<1>(benchmarks);
+    add_backend<4>(benchmarks);
+    add_backend<16>(benchmarks);
+    add_backend<64>(benchmarks);
+    add_backend<128>(benchmarks);
+
+    std::vector<Result> results;
+    for (const Benchmark& benchmark : benchmarks)
+    {
+        if (benchmark.name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+        if (list)
+        {
+            std::cout << benchmark.name << "\n";
+            continue;
+        }
+        Result result = run(benchmark, min_time_s);
+        char line[256];
+        std::snprintf(line,
+                      sizeof(line),
+                      "%-60s %12ld %14.1f ns %14.1f ns\n",
+                      result.name.c_str(),
+                      result.iterations,
+                      result.real_ns,
+                      result.cpu_ns);
+        std::cout << line << std::flush;
+        results.push_back(result);
+    }
+
+    if (!json_path.empty() && !list)
+    {
+        write_json(json_path, argv[0], results);
+        std::cout << "results written to " << json_path << "\n";
+    }
+}
@@ -0,0 +1,40 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "o80/command_trace.hpp"
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        std::cout << "usage: o80_latencies segment_id [duration_s]\n"
+                  << "(the backend must be started with a segment layout "
+                     "with a non zero trace size)\n";
+        return 1;
+    }
+    std::string segment_id{argv[1]};
+    double duration_s = 10;
+    if (argc == 3)
+    {
+        duration_s = std::stod(argv[2]);
+    }
+    try
+    {
+        o80::TraceReader reader(segment_id);
+        std::cout << "collecting the traces of segment id " << segment_id
+                  << " for " << duration_s << " seconds\n";
+        o80::CommandLatencies latencies(reader.collect(duration_s));
+        std::cout << latencies.to_string() << "\n";
+        if (reader.nb_dropped() > 0)
+        {
+            std::cout << "(" << reader.nb_dropped()
+                      << " traces dropped, consider increasing the trace "
+                         "size of the segment layout)\n";
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+}
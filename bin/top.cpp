@@ -0,0 +1,192 @@
+#include <unistd.h>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include "o80/time.hpp"
+#include "o80/transport.hpp"
+#include "o80_internal/segment_status.hpp"
+
+// max number of queue depths displayed per segment
+static const int MAX_DISPLAYED_ACTUATORS = 8;
+// a backend not iterating for longer is displayed as stalled
+static const std::int64_t STALLED_NS = 1e9;
+
+// a segment displayed by o80_top, and the values read at the
+// previous refresh (to compute rates)
+class Monitored
+{
+public:
+    Monitored(const std::string& segment_id)
+        : status(segment_id, true),
+          previous_iteration(-1),
+          previous_nb_commands(-1),
+          previous_stamp_ns(-1)
+    {
+    }
+    o80::internal::SegmentStatus status;
+    long int previous_iteration;
+    long int previous_nb_commands;
+    std::int64_t previous_stamp_ns;
+};
+
+std::string transport_name(int transport)
+{
+    switch (transport)
+    {
+        case o80::SHARED_MEMORY:
+            return "shm";
+        case o80::IN_PROCESS:
+            return "process";
+        case o80::SHARED_REGION:
+            return "region";
+    }
+    return "?";
+}
+
+std::string state(const o80::internal::StatusRecord& record,
+                  bool alive,
+                  std::int64_t now)
+{
+    if (record.stopped.load())
+    {
+        return "stopped";
+    }
+    if (!alive)
+    {
+        return "dead";
+    }
+    if (record.iteration.load() < 0 ||
+        now - record.stamp_ns.load() > STALLED_NS)
+    {
+        return "stalled";
+    }
+    return record.active.load() ? "active" : "idle";
+}
+
+std::string queue_depths(const o80::internal::StatusRecord& record)
+{
+    std::ostringstream s;
+    int nb_actuators = record.nb_actuators;
+    for (int dof = 0; dof < nb_actuators && dof < MAX_DISPLAYED_ACTUATORS;
+         dof++)
+    {
+        s << record.queue_depths[dof].load() << " ";
+    }
+    if (nb_actuators > MAX_DISPLAYED_ACTUATORS)
+    {
+        s << "...";
+    }
+    return s.str();
+}
+
+void refresh(std::map<std::string, std::unique_ptr<Monitored>>& monitored)
+{
+    // new segments, and segments whose backend exited
+    std::map<std::string, std::unique_ptr<Monitored>> current;
+    for (const std::string& segment_id : o80::internal::SegmentStatus::list())
+    {
+        auto it = monitored.find(segment_id);
+        if (it != monitored.end())
+        {
+            current[segment_id] = std::move(it->second);
+            continue;
+        }
+        try
+        {
+            current[segment_id].reset(new Monitored(segment_id));
+        }
+        catch (const std::runtime_error&)
+        {
+            // not (yet) an o80 status, or no read access
+            current.erase(segment_id);
+        }
+    }
+    monitored = std::move(current);
+
+    std::int64_t now = o80::time_now().count();
+    char line[256];
+    // clearing the terminal
+    std::cout << "\033[2J\033[H";
+    std::snprintf(line,
+                  sizeof(line),
+                  "%-20s %8s %-8s %-8s %10s %10s %9s %9s %5s  %s\n",
+                  "segment",
+                  "pid",
+                  "channel",
+                  "state",
+                  "rate (Hz)",
+                  "jitter(us)",
+                  "overruns",
+                  "cmds/s",
+                  "front",
+                  "queue depths");
+    std::cout << line;
+    for (auto& item : monitored)
+    {
+        Monitored& m = *item.second;
+        const o80::internal::StatusRecord& record = m.status.record();
+        long int iteration = record.iteration.load();
+        long int nb_commands = record.nb_commands.load();
+        std::int64_t stamp = record.stamp_ns.load();
+        double rate = 0;
+        double commands_rate = 0;
+        if (m.previous_stamp_ns >= 0 && stamp > m.previous_stamp_ns)
+        {
+            double duration_s = (stamp - m.previous_stamp_ns) / 1e9;
+            rate = (iteration - m.previous_iteration) / duration_s;
+            commands_rate = (nb_commands - m.previous_nb_commands) / duration_s;
+        }
+        m.previous_iteration = iteration;
+        m.previous_nb_commands = nb_commands;
+        m.previous_stamp_ns = stamp;
+        std::snprintf(line,
+                      sizeof(line),
+                      "%-20.20s %8ld %-8s %-8s %10.1f %10.1f %9ld %9.1f %5d  "
+                      "%s\n",
+                      item.first.c_str(),
+                      static_cast<long int>(record.pid),
+                      transport_name(record.transport).c_str(),
+                      state(record, m.status.is_alive(), now).c_str(),
+                      rate,
+                      record.jitter_ns.load() / 1e3,
+                      static_cast<long int>(record.overruns.load()),
+                      commands_rate,
+                      m.status.nb_frontends(),
+                      queue_depths(record).c_str());
+        std::cout << line;
+    }
+    if (monitored.empty())
+    {
+        std::cout << "(no running backend)\n";
+    }
+    std::cout << std::flush;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 2)
+    {
+        std::cout << "usage: o80_top [refresh_hz]\n";
+        return 1;
+    }
+    double refresh_hz = 2;
+    if (argc == 2)
+    {
+        refresh_hz = std::stod(argv[1]);
+    }
+    if (refresh_hz <= 0)
+    {
+        std::cout << "the refresh frequency should be positive\n";
+        return 1;
+    }
+    std::map<std::string, std::unique_ptr<Monitored>> monitored;
+    while (true)
+    {
+        refresh(monitored);
+        usleep(static_cast<useconds_t>(1e6 / refresh_hz));
+    }
+}
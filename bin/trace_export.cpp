@@ -0,0 +1,31 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "o80/tracer.hpp"
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        std::cout << "usage: o80_trace_export output.json trace_file "
+                     "[trace_file ...]\n"
+                  << "(trace files are written by o80::Tracer, the output "
+                     "can be opened in chrome://tracing or "
+                     "https://ui.perfetto.dev)\n";
+        return 1;
+    }
+    std::string json_path{argv[1]};
+    std::vector<std::string> paths(argv + 2, argv + argc);
+    try
+    {
+        long int nb_events = o80::Tracer::export_chrome_trace(paths, json_path);
+        std::cout << "exported " << nb_events << " events to " << json_path
+                  << "\n";
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+}
@@ -4,14 +4,19 @@
 #pragma once
 
 #include <type_traits>
+#include "o80/command_recording.hpp"
 #include "o80/frequency_measure.hpp"
 #include "o80/logger.hpp"
+#include "o80/tracer.hpp"
 #include "o80/memory_clearing.hpp"
 #include "o80/observation.hpp"
+#include "o80/readiness.hpp"
 #include "o80/sensor_state.hpp"
 #include "o80/states.hpp"
+#include "o80/transport.hpp"
 #include "o80_internal/controllers_manager.hpp"
-#include "time_series/multiprocess_time_series.hpp"
+#include "o80_internal/readiness.hpp"
+#include "o80_internal/segment_status.hpp"
 
 namespace o80
 
@@ -32,16 +37,31 @@ template <int QUEUE_SIZE, int NB_ACTUATORS, class STATE, class EXTENDED_STATE>
 class BackEnd
 {
 public:
-    /*! Multiprocess time series hosting observations*/
-    typedef time_series::MultiprocessTimeSeries<
-        Observation<NB_ACTUATORS, STATE, EXTENDED_STATE>>
+    /*! channels shared with the frontends*/
+    typedef Transport<NB_ACTUATORS, STATE, EXTENDED_STATE> BackendTransport;
+
+    /*! time series hosting observations*/
+    typedef typename BackendTransport::ObservationsTimeSeries
         ObservationsTimeSeries;
 
-    /*! multiprocess times series hosting the commands id that have been
+    /*! times series hosting the commands id that have been
         processed by the backend*/
-    typedef time_series::MultiprocessTimeSeries<int>
+    typedef typename BackendTransport::CompletedCommandsTimeSeries
         CompletedCommandsTimeSeries;
 
+    /*! complete state of the backend, as returned by snapshot*/
+    class Snapshot
+    {
+    public:
+        typename ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::Snapshot
+            controllers;
+        States<NB_ACTUATORS, STATE> desired_states;
+        States<NB_ACTUATORS, STATE> initial_states;
+        bool first_iteration;
+        long int iteration;
+        bool reapplied_desired_states;
+    };
+
 public:
     /**
      * @param segment_id should be the same for the
@@ -55,8 +75,19 @@ public:
      *        iterate method will be called. It will help improve speed and 
      *        duration to be more accurate (by relying on the number of iterations
      *        rather than the computer clock).
+     * @param transport (default shared memory)
+     *        If IN_PROCESS, commands and observations are exchanged via
+     *        time series living in the process memory (no serialization),
+     *        i.e. only frontends running in the same process may connect.
+     * @param layout (default: all time series of size QUEUE_SIZE)
+     *        capacities of the time series of the segment. Frontends
+     *        read it when connecting.
      */
-  BackEnd(std::string segment_id, bool new_commands_observations = false, double period_us=-1);
+    BackEnd(std::string segment_id,
+            bool new_commands_observations = false,
+            double period_us = -1,
+            TransportType transport = SHARED_MEMORY,
+            const SegmentLayout& layout = SegmentLayout(QUEUE_SIZE));
 
     /**
      * @brief delete the shared memory segments
@@ -102,6 +133,68 @@ public:
      */
     const States<NB_ACTUATORS, STATE>& initial_states() const;
 
+    /**
+     * returns the channels shared with the frontends (used by
+     * Standalone for bursting)
+     */
+    BackendTransport& get_transport();
+
+    /**
+     * returns a copy of the state of the backend: queued and current
+     * commands of each actuator (including their execution status),
+     * previous desired states, iteration counter and base of relative
+     * iterations. Commands shared by frontends but not yet read by the
+     * backend are not part of the snapshot.
+     * Should not be called while another thread calls pulse.
+     */
+    Snapshot snapshot() const;
+
+    /**
+     * sets the state of the backend to the one of the snapshot (which
+     * may be restored any number of times, e.g. for resetting episodes
+     * or branching rollouts). Commands shared by frontends before the
+     * call and not yet read by the backend will still be executed.
+     * As the iteration counter is restored, frontends should not
+     * access observations per iteration across a restore.
+     * Should not be called while another thread calls pulse.
+     */
+    void restore(const Snapshot& snapshot);
+
+    /**
+     * ! starts writing to the file, at each iteration, the commands
+     *   read from the frontends, the current states and the desired
+     *   states (see CommandRecorder). The file can be replayed
+     *   offline into a new backend (see replay_commands).
+     *   pulse only copies the records into a ring, written to the file
+     *   by a dedicated thread (see AsyncCommandRecorder).
+     *   A restore performed during the recording is not recorded.
+     *   Throws a runtime_error if the file can not be created.
+     *   May be called while another thread calls pulse: the recording
+     *   starts at the next iteration.
+     *   @param ring_size number of iterations buffered until written.
+     *          Iterations are not recorded if the ring is full (see
+     *          stop_recording)
+     */
+    void start_recording(const std::string& path,
+                         std::size_t ring_size = 4096);
+
+    /**
+     * ! stops the recording (if any) and closes the file, once the
+     *   current iteration (if any) ended and all records have been
+     *   written. Returns the number of iterations which were not
+     *   recorded because the ring was full. Throws a runtime_error
+     *   if writing to the file failed.
+     *   May be called while another thread calls pulse.
+     */
+    long int stop_recording();
+
+    /**
+     * ! notifies the frontends which requested it (see
+     *   ObserverFrontEnd::enable_readiness) that a burst ended.
+     *   Called by the standalone at the end of each burst.
+     */
+    void notify_burst_end();
+
 private:
     // performing on iteration. Called internally by "pulse"
     bool iterate(const TimePoint& time_now,
@@ -113,9 +206,19 @@ private:
     // id of shared memory segments
     std::string segment_id_;
 
-    // multiprocess time series, the backend write in it,
+    // as passed to the constructor
+    double period_us_;
+
+    // shared memory or in process
+    TransportType transport_type_;
+
+    // channels shared with the frontends (time series of commands
+    // and observations, control data)
+    std::shared_ptr<BackendTransport> transport_;
+
+    // time series (hosted by the transport), the backend write in it,
     // the frontends read from it
-    ObservationsTimeSeries observations_;
+    ObservationsTimeSeries& observations_;
 
     // host controllers (one per actuator), each controller compute
     // the current desired state based commands read from a commands
@@ -149,17 +252,21 @@ private:
     // true: no command was active)
     bool reapplied_desired_states_;
 
-    // everytime a frontend will wait for the completion of a
-    // command (pulse_and_wait method), it will write the corresponding id in
-    // this time series. For debug and introspection. The backend creates the
-    // leader time series, but do not use it.
-    CompletedCommandsTimeSeries waiting_for_completion_;
-
-    // everytime a frontend will process the information that a
-    // command has been completed by the backend, its id will be
-    // written in this time series. For debug and introspection. The
-    // backend creates the leader time series but do not use it.
-    CompletedCommandsTimeSeries completion_reported_;
+    // segment id as written in the records of Tracer
+    std::uint32_t trace_segment_;
+
+    // health of the backend, as displayed by o80_top
+    std::unique_ptr<internal::SegmentStatus> status_;
+
+    // notifies new observations and completions to the frontends
+    // which requested it (via the status)
+    internal::ReadinessNotifier readiness_;
+    time_series::Index completed_index_;
+
+    // see start_recording
+    AsyncCommandRecorder<NB_ACTUATORS, STATE> recorder_;
+    // filled during the current iteration (nullptr if not recorded)
+    CommandRecord<NB_ACTUATORS, STATE>* record_;
 };
 
 #include "back_end.hxx"
@@ -10,11 +10,18 @@
 #define BACKEND BackEnd<QUEUE_SIZE, NB_ACTUATORS, STATE, EXTENDED_STATE>
 
 TEMPLATE_BACKEND
-BACKEND::BackEnd(std::string segment_id, bool new_commands_observations, double period_us)
+BACKEND::BackEnd(std::string segment_id,
+                 bool new_commands_observations,
+                 double period_us,
+                 TransportType transport,
+                 const SegmentLayout& layout)
     : segment_id_(segment_id),
-      observations_{ObservationsTimeSeries::create_leader(
-          segment_id + "_observations", QUEUE_SIZE)},
-      controllers_manager_(segment_id,period_us),
+      period_us_(period_us),
+      transport_type_(transport),
+      transport_{
+          BackendTransport::create(segment_id, transport, true, layout)},
+      observations_(transport_->observations()),
+      controllers_manager_(*transport_, period_us),
       desired_states_(),
       initial_states_(),
       first_iteration_{true},
@@ -22,25 +29,30 @@ BACKEND::BackEnd(std::string segment_id, bool new_commands_observations, double
       observed_frequency_(-1),
       new_commands_observations_(new_commands_observations),
       reapplied_desired_states_{true},
-      waiting_for_completion_{CompletedCommandsTimeSeries::create_leader(
-          segment_id + "_waiting_for_completion", QUEUE_SIZE)},
-      completion_reported_{CompletedCommandsTimeSeries::create_leader(
-          segment_id + "_completion_reported", QUEUE_SIZE)}
-
+      trace_segment_(Tracer::register_segment(segment_id)),
+      status_(new internal::SegmentStatus(
+          segment_id, NB_ACTUATORS, transport, period_us)),
+      completed_index_(-1),
+      record_(nullptr)
 {
     frequency_measure_.tick();
     // this will be set to true when iterations do not reapply desired
     // states (i.e. at least one command is active), to false when
     // desired states is reapplied (no command is active)
-    shared_memory::set<bool>(segment_id, "active", false);
+    transport_->set_active(false);
     // frontend(s) may set this value to "true" to trigger
     // the purge of all commands
-    shared_memory::set<bool>(segment_id, "purge", false);
+    transport_->set_purge(false);
 }
 
 TEMPLATE_BACKEND
 BACKEND::~BackEnd()
 {
+    if (transport_type_ == IN_PROCESS)
+    {
+        internal::unregister_in_process_segment(segment_id_);
+        return;
+    }
     clear_shared_memory(segment_id_);
 }
 
@@ -48,7 +60,7 @@ TEMPLATE_BACKEND
 void BACKEND::purge()
 {
     // will trigger purge at the next call to iterate
-    shared_memory::set<bool>(segment_id_, "purge", true);
+    transport_->set_purge(true);
 }
 
 TEMPLATE_BACKEND
@@ -57,6 +69,49 @@ const States<NB_ACTUATORS, STATE>& BACKEND::initial_states() const
     return initial_states_;
 }
 
+TEMPLATE_BACKEND
+typename BACKEND::BackendTransport& BACKEND::get_transport()
+{
+    return *transport_;
+}
+
+TEMPLATE_BACKEND
+typename BACKEND::Snapshot BACKEND::snapshot() const
+{
+    Snapshot snapshot;
+    snapshot.controllers = controllers_manager_.snapshot();
+    snapshot.desired_states = desired_states_;
+    snapshot.initial_states = initial_states_;
+    snapshot.first_iteration = first_iteration_;
+    snapshot.iteration = iteration_;
+    snapshot.reapplied_desired_states = reapplied_desired_states_;
+    return snapshot;
+}
+
+TEMPLATE_BACKEND
+void BACKEND::restore(const Snapshot& snapshot)
+{
+    controllers_manager_.restore(snapshot.controllers);
+    desired_states_ = snapshot.desired_states;
+    initial_states_ = snapshot.initial_states;
+    first_iteration_ = snapshot.first_iteration;
+    iteration_ = snapshot.iteration;
+    reapplied_desired_states_ = snapshot.reapplied_desired_states;
+    transport_->set_active(!reapplied_desired_states_);
+}
+
+TEMPLATE_BACKEND
+void BACKEND::start_recording(const std::string& path, std::size_t ring_size)
+{
+    recorder_.start(path, period_us_, ring_size);
+}
+
+TEMPLATE_BACKEND
+long int BACKEND::stop_recording()
+{
+    return recorder_.stop();
+}
+
 TEMPLATE_BACKEND
 bool BACKEND::iterate(const TimePoint& time_now,
                       const States<NB_ACTUATORS, STATE>& current_states,
@@ -69,12 +124,15 @@ bool BACKEND::iterate(const TimePoint& time_now,
     }
 
     // checking if a frontend requested the purge of commands
-    bool must_purge;
-    shared_memory::get<bool>(segment_id_, "purge", must_purge);
+    bool must_purge = transport_->get_purge();
     if (must_purge)
     {
         controllers_manager_.purge();
-        shared_memory::set<bool>(segment_id_, "purge", false);
+        transport_->set_purge(false);
+    }
+    if (record_ != nullptr)
+    {
+        record_->purge = must_purge;
     }
 
     controllers_manager_.process_commands(iteration_);
@@ -110,26 +168,43 @@ const States<NB_ACTUATORS, STATE>& BACKEND::pulse(
     bool iteration_update,
     long int current_iteration)
 {
+    Tracer::trace(trace_segment_, BACKEND_READ);
+
     if (first_iteration_)
     {
         initial_states_ = current_states;
         first_iteration_ = false;
-        shared_memory::serialize(
-            segment_id_, "initial_states", initial_states_);
+        transport_->set_initial_states(initial_states_);
     }
 
-    reapplied_desired_states_ =
-        iterate(time_now, current_states, iteration_update, current_iteration);
-
-    // for the sake of frontend::backend_is_active
-    if (reapplied_desired_states_)
+    // the recording is started / stopped (see start_recording)
+    // at the start of an iteration
+    record_ = recorder_.begin_iteration();
+    controllers_manager_.set_recorded_commands(
+        record_ != nullptr ? &record_->commands : nullptr);
+    try
+    {
+        reapplied_desired_states_ = iterate(
+            time_now, current_states, iteration_update, current_iteration);
+    }
+    catch (...)
     {
-        shared_memory::set<bool>(segment_id_, "active", false);
+        recorder_.cancel_iteration();
+        throw;
     }
-    else
+
+    // for the sake of frontend::backend_is_active
+    transport_->set_active(!reapplied_desired_states_);
+
+    if (record_ != nullptr)
     {
-        shared_memory::set<bool>(segment_id_, "active", true);
+        record_->time_now = time_now.count();
+        record_->iteration = iteration_;
+        record_->pulse_id = controllers_manager_.get_pulse_id();
+        record_->current_states = current_states;
+        record_->desired_states = desired_states_;
     }
+    recorder_.end_iteration();
 
     bool print_obs = true;
     if (new_commands_observations_)
@@ -158,5 +233,41 @@ const States<NB_ACTUATORS, STATE>& BACKEND::pulse(
         iteration_++;
     }
 
+    // for the sake of o80_top
+    status_->update(iteration_,
+                    !reapplied_desired_states_,
+                    controllers_manager_.nb_received_commands());
+    for (int dof = 0; dof < NB_ACTUATORS; dof++)
+    {
+        status_->set_queue_depth(dof,
+                                 controllers_manager_.get_queue_depth(dof));
+    }
+
+    // for the sake of the frontends waiting on their readiness
+    // file descriptor
+    int events = print_obs ? READY_OBSERVATION : 0;
+    if (readiness_.subscribed(status_->record()) & READY_COMPLETION)
+    {
+        time_series::Index completed_index =
+            controllers_manager_.get_completed_commands_time_series()
+                .newest_timeindex(false);
+        if (completed_index != completed_index_)
+        {
+            completed_index_ = completed_index;
+            events |= READY_COMPLETION;
+        }
+    }
+    readiness_.notify(status_->record(), events);
+
+    Tracer::trace(trace_segment_,
+                  reapplied_desired_states_ ? BACKEND_WRITE_REAPPLY
+                                            : BACKEND_WRITE_NEW);
+
     return desired_states_;
 }
+
+TEMPLATE_BACKEND
+void BACKEND::notify_burst_end()
+{
+    readiness_.notify(status_->record(), READY_BURST);
+}
@@ -0,0 +1,203 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <typeinfo>
+#include <vector>
+#include "o80/states.hpp"
+#include "o80_internal/command.hpp"
+#include "shared_memory/serializer.hpp"
+
+namespace o80
+{
+/**
+ * ! What a BackEnd consumed during one iteration: the batch of commands
+ *   read from the frontends (as shared by the frontends), the purge
+ *   request and the current states passed to BackEnd::pulse, as well as
+ *   the desired states it returned (see BackEnd::start_recording and
+ *   replay_commands).
+ */
+template <int NB_ACTUATORS, class STATE>
+class CommandRecord
+{
+public:
+    CommandRecord();
+
+public:
+    /*! time stamp passed to pulse (nanoseconds)*/
+    long int time_now;
+    /*! iteration of the backend*/
+    long int iteration;
+    /*! pulse id of the batch of commands (if any)*/
+    long int pulse_id;
+    /*! true if a frontend requested a purge of the commands*/
+    bool purge;
+    std::vector<Command<STATE>> commands;
+    States<NB_ACTUATORS, STATE> current_states;
+    States<NB_ACTUATORS, STATE> desired_states;
+};
+
+/**
+ * ! Writes instances of CommandRecord to a binary file. The file starts
+ *   with a header (magic string, number of actuators, name of the
+ *   STATE type and period of the backend), followed by the records:
+ *   time stamp, iteration and pulse id (8 bytes each), purge flag
+ *   (1 byte), number of commands (4 bytes), then each command, the
+ *   current states and the desired states serialized, preceded by their
+ *   size (4 bytes).
+ */
+template <int NB_ACTUATORS, class STATE>
+class CommandRecorder
+{
+public:
+    /**
+     * Throws a runtime_error if the file can not be created.
+     * @param period_us period passed to the constructor of the
+     *        recorded BackEnd
+     */
+    CommandRecorder(const std::string& path, double period_us);
+
+    void write(const CommandRecord<NB_ACTUATORS, STATE>& record);
+
+    /*! number of records written since construction*/
+    long int nb_records() const;
+
+private:
+    template <class T>
+    void write_value(const T& value);
+    void write_data(const std::string& data);
+
+private:
+    std::string path_;
+    std::ofstream file_;
+    shared_memory::Serializer<Command<STATE>> command_serializer_;
+    shared_memory::Serializer<States<NB_ACTUATORS, STATE>> states_serializer_;
+    long int nb_records_;
+};
+
+/**
+ * ! Records the iterations of a BackEnd without writing to the file
+ *   from the thread calling pulse: this thread fills records
+ *   preallocated in a lock free single producer / single consumer ring
+ *   (see begin_iteration and end_iteration), which a dedicated thread
+ *   writes to the file (see CommandRecorder). An iteration is not
+ *   recorded if the ring is full (see nb_dropped). Each record
+ *   has capacity for NB_ACTUATORS commands: an iteration reading more
+ *   commands allocates memory (once, as the records are reused).
+ *   start and stop may be called while another thread calls
+ *   begin_iteration and end_iteration.
+ */
+template <int NB_ACTUATORS, class STATE>
+class AsyncCommandRecorder
+{
+public:
+    AsyncCommandRecorder();
+    ~AsyncCommandRecorder();
+
+    /**
+     * ! stops the current recording (if any), creates the file and
+     *   spawns the thread writing to it. The iterations starting after
+     *   the call are recorded. Throws a runtime_error if the file can
+     *   not be created.
+     * @param period_us period of the recorded BackEnd
+     * @param ring_size capacity (in records) of the ring
+     */
+    void start(const std::string& path,
+               double period_us,
+               std::size_t ring_size);
+
+    /**
+     * ! waits for the current iteration (if any) to end, writes
+     *   the remaining records and closes the file. Returns the number of
+     *   iterations which were not recorded because the ring was full.
+     *   Throws a runtime_error if writing to the file failed.
+     */
+    long int stop();
+
+    /*! (thread calling pulse) returns the record to fill during this
+        iteration, or nullptr if not recording (or if the ring is full)*/
+    CommandRecord<NB_ACTUATORS, STATE>* begin_iteration();
+
+    /*! (thread calling pulse) hands the record returned by
+        begin_iteration (if any) over to the writing thread*/
+    void end_iteration();
+
+    /*! (thread calling pulse) ends the iteration without
+        recording it (e.g. if an exception was thrown)*/
+    void cancel_iteration();
+
+private:
+    // stop, with mutex_ locked
+    long int close();
+    // writing thread
+    void run();
+
+private:
+    std::vector<CommandRecord<NB_ACTUATORS, STATE>> ring_;
+    std::size_t mask_;
+    std::atomic<std::uint64_t> head_;
+    std::atomic<std::uint64_t> tail_;
+    // the record being filled by the thread calling pulse
+    CommandRecord<NB_ACTUATORS, STATE>* record_;
+    // see stop
+    std::atomic<bool> recording_;
+    std::atomic<bool> in_iteration_;
+    std::atomic<long int> nb_iterations_;
+    std::atomic<long int> nb_dropped_;
+    // start and stop
+    std::mutex mutex_;
+    std::unique_ptr<CommandRecorder<NB_ACTUATORS, STATE>> recorder_;
+    std::unique_ptr<std::thread> thread_;
+    std::atomic<bool> running_;
+    std::string error_;
+};
+
+/**
+ * ! Reads the files written by CommandRecorder
+ */
+template <int NB_ACTUATORS, class STATE>
+class CommandRecordReader
+{
+public:
+    /**
+     * Throws a runtime_error if the file can not be read, or has not been
+     * written by a recorder of the same number of actuators and STATE.
+     */
+    CommandRecordReader(const std::string& path);
+
+    /*! period of the recorded BackEnd*/
+    double get_period_us() const;
+
+    /**
+     * ! reads the next record. Returns false if the end of the file
+     *   has been reached. Throws a runtime_error if the file is
+     *   truncated.
+     */
+    bool read(CommandRecord<NB_ACTUATORS, STATE>& record);
+
+private:
+    template <class T>
+    void read_value(T& value);
+    void read_data(std::string& data);
+
+private:
+    std::string path_;
+    std::ifstream file_;
+    double period_us_;
+    std::string data_;
+    shared_memory::Serializer<Command<STATE>> command_serializer_;
+    shared_memory::Serializer<States<NB_ACTUATORS, STATE>> states_serializer_;
+};
+
+#include "command_recording.hxx"
+}  // namespace o80
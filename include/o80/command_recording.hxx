@@ -0,0 +1,355 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#define TEMPLATE_RECORDING template <int NB_ACTUATORS, class STATE>
+
+static const char COMMAND_RECORD_MAGIC[8] = "o80rec1";
+
+TEMPLATE_RECORDING
+CommandRecord<NB_ACTUATORS, STATE>::CommandRecord()
+    : time_now(0), iteration(0), pulse_id(0), purge(false)
+{
+}
+
+TEMPLATE_RECORDING
+CommandRecorder<NB_ACTUATORS, STATE>::CommandRecorder(const std::string& path,
+                                                      double period_us)
+    : path_(path), file_(path, std::ios::binary), nb_records_(0)
+{
+    if (!file_)
+    {
+        throw std::runtime_error("o80 command recorder: failed to create " +
+                                 path);
+    }
+    file_.write(COMMAND_RECORD_MAGIC, sizeof(COMMAND_RECORD_MAGIC));
+    write_value(static_cast<std::int32_t>(NB_ACTUATORS));
+    write_data(std::string(typeid(STATE).name()));
+    write_value(period_us);
+}
+
+TEMPLATE_RECORDING
+template <class T>
+void CommandRecorder<NB_ACTUATORS, STATE>::write_value(const T& value)
+{
+    file_.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+TEMPLATE_RECORDING
+void CommandRecorder<NB_ACTUATORS, STATE>::write_data(const std::string& data)
+{
+    write_value(static_cast<std::uint32_t>(data.size()));
+    file_.write(data.data(), data.size());
+}
+
+TEMPLATE_RECORDING
+void CommandRecorder<NB_ACTUATORS, STATE>::write(
+    const CommandRecord<NB_ACTUATORS, STATE>& record)
+{
+    write_value(static_cast<std::int64_t>(record.time_now));
+    write_value(static_cast<std::int64_t>(record.iteration));
+    write_value(static_cast<std::int64_t>(record.pulse_id));
+    write_value(static_cast<std::uint8_t>(record.purge));
+    write_value(static_cast<std::uint32_t>(record.commands.size()));
+    for (const Command<STATE>& command : record.commands)
+    {
+        write_data(command_serializer_.serialize(command));
+    }
+    write_data(states_serializer_.serialize(record.current_states));
+    write_data(states_serializer_.serialize(record.desired_states));
+    if (!file_)
+    {
+        throw std::runtime_error("o80 command recorder: failed to write to " +
+                                 path_);
+    }
+    nb_records_++;
+}
+
+TEMPLATE_RECORDING
+long int CommandRecorder<NB_ACTUATORS, STATE>::nb_records() const
+{
+    return nb_records_;
+}
+
+TEMPLATE_RECORDING
+AsyncCommandRecorder<NB_ACTUATORS, STATE>::AsyncCommandRecorder()
+    : mask_(0),
+      head_(0),
+      tail_(0),
+      record_(nullptr),
+      recording_(false),
+      in_iteration_(false),
+      nb_iterations_(0),
+      nb_dropped_(0),
+      running_(false)
+{
+}
+
+TEMPLATE_RECORDING
+AsyncCommandRecorder<NB_ACTUATORS, STATE>::~AsyncCommandRecorder()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    try
+    {
+        close();
+    }
+    catch (const std::exception&)
+    {
+        // the file may be incomplete, but a destructor should not throw
+    }
+}
+
+TEMPLATE_RECORDING
+void AsyncCommandRecorder<NB_ACTUATORS, STATE>::start(const std::string& path,
+                                                      double period_us,
+                                                      std::size_t ring_size)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    close();
+    // the ring is (re)allocated only while not recording, i.e. while
+    // the thread calling pulse does not access it
+    std::size_t size = 1;
+    while (size < ring_size)
+    {
+        size *= 2;
+    }
+    if (ring_.size() != size)
+    {
+        ring_.assign(size, CommandRecord<NB_ACTUATORS, STATE>());
+        for (CommandRecord<NB_ACTUATORS, STATE>& record : ring_)
+        {
+            record.commands.reserve(NB_ACTUATORS);
+        }
+        mask_ = size - 1;
+    }
+    recorder_.reset(new CommandRecorder<NB_ACTUATORS, STATE>(path, period_us));
+    head_ = 0;
+    tail_ = 0;
+    nb_dropped_ = 0;
+    error_.clear();
+    running_ = true;
+    thread_.reset(
+        new std::thread(&AsyncCommandRecorder<NB_ACTUATORS, STATE>::run, this));
+    recording_ = true;
+}
+
+TEMPLATE_RECORDING
+long int AsyncCommandRecorder<NB_ACTUATORS, STATE>::stop()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return close();
+}
+
+TEMPLATE_RECORDING
+long int AsyncCommandRecorder<NB_ACTUATORS, STATE>::close()
+{
+    if (!thread_)
+    {
+        return 0;
+    }
+    // sequentially consistent with in_iteration_ (see begin_iteration):
+    // an iteration starting after this store does not record. Waiting
+    // for the end of the iteration which may have started before.
+    recording_ = false;
+    if (in_iteration_)
+    {
+        long int nb_iterations = nb_iterations_;
+        while (in_iteration_ && nb_iterations_ == nb_iterations)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+    // the writing thread writes the remaining records, then exits
+    running_ = false;
+    thread_->join();
+    thread_.reset();
+    recorder_.reset();
+    if (!error_.empty())
+    {
+        std::string error = error_;
+        error_.clear();
+        throw std::runtime_error(error);
+    }
+    return nb_dropped_;
+}
+
+TEMPLATE_RECORDING
+CommandRecord<NB_ACTUATORS, STATE>*
+AsyncCommandRecorder<NB_ACTUATORS, STATE>::begin_iteration()
+{
+    in_iteration_ = true;
+    record_ = nullptr;
+    if (!recording_)
+    {
+        return nullptr;
+    }
+    std::uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) >= ring_.size())
+    {
+        nb_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    record_ = &ring_[head & mask_];
+    record_->commands.clear();
+    return record_;
+}
+
+TEMPLATE_RECORDING
+void AsyncCommandRecorder<NB_ACTUATORS, STATE>::end_iteration()
+{
+    if (record_ != nullptr)
+    {
+        head_.store(head_.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_release);
+    }
+    cancel_iteration();
+}
+
+TEMPLATE_RECORDING
+void AsyncCommandRecorder<NB_ACTUATORS, STATE>::cancel_iteration()
+{
+    record_ = nullptr;
+    nb_iterations_.store(nb_iterations_.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_release);
+    in_iteration_.store(false, std::memory_order_release);
+}
+
+TEMPLATE_RECORDING
+void AsyncCommandRecorder<NB_ACTUATORS, STATE>::run()
+{
+    while (true)
+    {
+        // loaded before the records, so that all the records
+        // are written before exiting
+        bool running = running_;
+        std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+        std::uint64_t head = head_.load(std::memory_order_acquire);
+        for (std::uint64_t index = tail; index < head; index++)
+        {
+            // after a failure, the records are discarded
+            // (see stop, which throws)
+            if (error_.empty())
+            {
+                try
+                {
+                    recorder_->write(ring_[index & mask_]);
+                }
+                catch (const std::exception& e)
+                {
+                    error_ = e.what();
+                }
+            }
+            tail_.store(index + 1, std::memory_order_release);
+        }
+        if (!running)
+        {
+            return;
+        }
+        if (head == tail)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+TEMPLATE_RECORDING
+CommandRecordReader<NB_ACTUATORS, STATE>::CommandRecordReader(
+    const std::string& path)
+    : path_(path), file_(path, std::ios::binary), period_us_(-1)
+{
+    if (!file_)
+    {
+        throw std::runtime_error("o80 command recording: failed to open " +
+                                 path);
+    }
+    char magic[sizeof(COMMAND_RECORD_MAGIC)];
+    file_.read(magic, sizeof(magic));
+    if (!file_ ||
+        std::string(magic, sizeof(magic)) !=
+            std::string(COMMAND_RECORD_MAGIC, sizeof(COMMAND_RECORD_MAGIC)))
+    {
+        throw std::runtime_error("o80 command recording: " + path +
+                                 " is not a command recording");
+    }
+    std::int32_t nb_actuators;
+    std::string state_name;
+    read_value(nb_actuators);
+    read_data(state_name);
+    read_value(period_us_);
+    if (nb_actuators != NB_ACTUATORS || state_name != typeid(STATE).name())
+    {
+        throw std::runtime_error(
+            "o80 command recording: " + path + " has been recorded with " +
+            std::to_string(nb_actuators) + " actuators of type " + state_name +
+            " (expected: " + std::to_string(NB_ACTUATORS) + " of type " +
+            typeid(STATE).name() + ")");
+    }
+}
+
+TEMPLATE_RECORDING
+double CommandRecordReader<NB_ACTUATORS, STATE>::get_period_us() const
+{
+    return period_us_;
+}
+
+TEMPLATE_RECORDING
+template <class T>
+void CommandRecordReader<NB_ACTUATORS, STATE>::read_value(T& value)
+{
+    file_.read(reinterpret_cast<char*>(&value), sizeof(T));
+    if (!file_)
+    {
+        throw std::runtime_error("o80 command recording: " + path_ +
+                                 " is truncated");
+    }
+}
+
+TEMPLATE_RECORDING
+void CommandRecordReader<NB_ACTUATORS, STATE>::read_data(std::string& data)
+{
+    std::uint32_t size;
+    read_value(size);
+    data.resize(size);
+    if (size > 0)
+    {
+        file_.read(&data[0], size);
+    }
+    if (!file_)
+    {
+        throw std::runtime_error("o80 command recording: " + path_ +
+                                 " is truncated");
+    }
+}
+
+TEMPLATE_RECORDING
+bool CommandRecordReader<NB_ACTUATORS, STATE>::read(
+    CommandRecord<NB_ACTUATORS, STATE>& record)
+{
+    // end of file (not truncated)
+    if (file_.peek() == std::ifstream::traits_type::eof())
+    {
+        return false;
+    }
+    std::int64_t time_now, iteration, pulse_id;
+    std::uint8_t purge;
+    std::uint32_t nb_commands;
+    read_value(time_now);
+    read_value(iteration);
+    read_value(pulse_id);
+    read_value(purge);
+    read_value(nb_commands);
+    record.time_now = time_now;
+    record.iteration = iteration;
+    record.pulse_id = pulse_id;
+    record.purge = purge != 0;
+    record.commands.resize(nb_commands);
+    for (Command<STATE>& command : record.commands)
+    {
+        read_data(data_);
+        command_serializer_.deserialize(data_, command);
+    }
+    read_data(data_);
+    states_serializer_.deserialize(data_, record.current_states);
+    read_data(data_);
+    states_serializer_.deserialize(data_, record.desired_states);
+    return true;
+}
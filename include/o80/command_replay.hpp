@@ -0,0 +1,62 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "o80/back_end.hpp"
+#include "o80/command_recording.hpp"
+#include "o80/time.hpp"
+
+namespace o80
+{
+/**
+ * ! Result of replay_commands
+ */
+class ReplayReport
+{
+public:
+    ReplayReport();
+
+    /*! iterations of the backend per second of replay*/
+    double iterations_per_second() const;
+
+    std::string to_string() const;
+
+public:
+    /*! number of records replayed (i.e. iterations of the backend)*/
+    long int nb_iterations;
+    /*! total number of commands fed to the backend*/
+    long int nb_commands;
+    /*! number of iterations for which the desired states differ
+        (bitwise) from the recorded ones*/
+    long int nb_mismatches;
+    /*! iteration of the first mismatch (-1 if none)*/
+    long int first_mismatch;
+    /*! duration of the replay (nanoseconds)*/
+    long int duration_ns;
+};
+
+namespace internal
+{
+// unique id of the (in process) segment of a replay
+std::string new_replay_segment_id();
+}  // namespace internal
+
+/**
+ * ! Feeds the commands and current states written by
+ *   BackEnd::start_recording into a new BackEnd (running over the
+ *   in process transport), as fast as possible, and checks the desired
+ *   states it computes are bitwise identical to the recorded ones.
+ *   The records are read from the file before the replay starts, so the
+ *   duration of the replay is the time spent writing the commands to the
+ *   transport and in BackEnd::pulse.
+ *   Throws a runtime_error if the file can not be read, or has not been
+ *   recorded by a backend of the same number of actuators and STATE.
+ */
+template <int QUEUE_SIZE, int NB_ACTUATORS, class STATE, class EXTENDED_STATE>
+ReplayReport replay_commands(const std::string& path);
+
+#include "command_replay.hxx"
+}  // namespace o80
@@ -0,0 +1,70 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+template <int QUEUE_SIZE, int NB_ACTUATORS, class STATE, class EXTENDED_STATE>
+ReplayReport replay_commands(const std::string& path)
+{
+    typedef CommandRecord<NB_ACTUATORS, STATE> Record;
+
+    CommandRecordReader<NB_ACTUATORS, STATE> reader(path);
+    std::vector<Record> records;
+    Record record;
+    while (reader.read(record))
+    {
+        records.push_back(record);
+    }
+
+    BackEnd<QUEUE_SIZE, NB_ACTUATORS, STATE, EXTENDED_STATE> backend(
+        internal::new_replay_segment_id(),
+        false,
+        reader.get_period_us(),
+        IN_PROCESS);
+    typename BackEnd<QUEUE_SIZE, NB_ACTUATORS, STATE, EXTENDED_STATE>::
+        BackendTransport& transport = backend.get_transport();
+    EXTENDED_STATE extended_state;
+    std::vector<States<NB_ACTUATORS, STATE>> desired_states(records.size());
+
+    ReplayReport report;
+    TimePoint start = time_now();
+    for (std::size_t index = 0; index < records.size(); index++)
+    {
+        const Record& r = records[index];
+        // as a frontend would do
+        if (!r.commands.empty())
+        {
+            for (const Command<STATE>& command : r.commands)
+            {
+                transport.commands().append(command);
+            }
+            transport.set_pulse_id(r.pulse_id);
+        }
+        if (r.purge)
+        {
+            transport.set_purge(true);
+        }
+        desired_states[index] = backend.pulse(TimePoint(r.time_now),
+                                              r.current_states,
+                                              extended_state,
+                                              false,
+                                              r.iteration);
+        report.nb_commands += r.commands.size();
+    }
+    report.duration_ns = time_diff(start, time_now());
+    report.nb_iterations = records.size();
+
+    // comparing the serialized states, i.e. bitwise
+    shared_memory::Serializer<States<NB_ACTUATORS, STATE>> serializer;
+    for (std::size_t index = 0; index < records.size(); index++)
+    {
+        std::string replayed = serializer.serialize(desired_states[index]);
+        if (replayed != serializer.serialize(records[index].desired_states))
+        {
+            if (report.nb_mismatches == 0)
+            {
+                report.first_mismatch = records[index].iteration;
+            }
+            report.nb_mismatches++;
+        }
+    }
+    return report;
+}
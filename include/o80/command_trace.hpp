@@ -0,0 +1,157 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "o80/introspection_event.hpp"
+#include "time_series/interface.hpp"
+
+namespace o80
+{
+/**
+ * ! An event of the lifecycle of a command (see CommandEvent), time
+ *   stamped by the process it occurred in. The time stamps are read from
+ *   the steady clock (see time_now), which is shared by all the processes
+ *   of the machine, so the traces written by the frontends and by the
+ *   backend can be compared.
+ */
+class CommandTrace
+{
+public:
+    CommandTrace();
+
+    /*! time stamped with the current time*/
+    CommandTrace(int command_id, CommandEvent event, long int iteration);
+
+    CommandTrace(int command_id,
+                 CommandEvent event,
+                 long int iteration,
+                 long int stamp_ns);
+
+    CommandEvent get_event() const;
+
+    std::string to_string() const;
+
+    template <class Archive>
+    void serialize(Archive& archive)
+    {
+        archive(command_id, event, iteration, stamp_ns);
+    }
+
+public:
+    int command_id;
+    // a CommandEvent
+    int event;
+    /*! iteration of the backend, or -1 for the events
+        occurring in the frontends*/
+    long int iteration;
+    /*! time stamp (nanoseconds, steady clock)*/
+    long int stamp_ns;
+};
+
+typedef time_series::TimeSeriesInterface<CommandTrace> TracesTimeSeries;
+
+/**
+ * ! Distribution of durations, in microseconds
+ */
+class LatencyStats
+{
+public:
+    LatencyStats();
+
+    /*! durations: in microseconds*/
+    LatencyStats(std::vector<double> durations);
+
+    std::string to_string() const;
+
+public:
+    std::size_t count;
+    double min;
+    double mean;
+    double median;
+    double p90;
+    double p99;
+    double max;
+};
+
+/**
+ * ! Latencies of the commands, computed from their traces:
+ *   - pickup: from the frontend sharing the command to the
+ *     backend receiving it
+ *   - queueing: from the backend receiving the command to the controller
+ *     starting its execution (i.e. the time spent waiting for the
+ *     previous commands of the same actuator)
+ *   - start: from the frontend sharing the command to the controller
+ *     starting its execution (i.e. pickup + queueing: the first desired
+ *     state computed from the command is applied at this iteration)
+ *   - execution: from the controller starting the execution of the command
+ *     to its completion
+ *   - total: from the frontend sharing the command to its completion
+ *   Commands with missing traces (e.g. overwritten in the traces time
+ *   series, or purged before starting) are ignored by the latencies they
+ *   miss an event of.
+ */
+class CommandLatencies
+{
+public:
+    CommandLatencies(const std::vector<CommandTrace>& traces);
+
+    /*! number of commands with at least one trace*/
+    std::size_t nb_commands() const;
+
+    const LatencyStats& pickup() const;
+    const LatencyStats& queueing() const;
+    const LatencyStats& start() const;
+    const LatencyStats& execution() const;
+    const LatencyStats& total() const;
+
+    std::string to_string() const;
+
+private:
+    std::size_t nb_commands_;
+    LatencyStats pickup_;
+    LatencyStats queueing_;
+    LatencyStats start_;
+    LatencyStats execution_;
+    LatencyStats total_;
+};
+
+namespace internal
+{
+class SharedRegion;
+}
+
+/**
+ * ! Reads the traces written by the backend of a segment id and by its
+ *   frontends (possibly running in other processes), for the shared
+ *   memory and the shared region transports. Throws a runtime_error at
+ *   construction if no backend is running, or if its layout disables
+ *   the traces (see SegmentLayout::trace_size).
+ */
+class TraceReader
+{
+public:
+    TraceReader(const std::string& segment_id);
+
+    /*! the traces written since the previous call (or since
+        construction). Traces overwritten in the time series before
+        being read are skipped (see nb_dropped).*/
+    std::vector<CommandTrace> read();
+
+    /*! reads the traces for duration_s seconds*/
+    std::vector<CommandTrace> collect(double duration_s);
+
+    long int nb_dropped() const;
+
+private:
+    std::shared_ptr<internal::SharedRegion> region_;
+    std::shared_ptr<TracesTimeSeries> traces_;
+    time_series::Index next_;
+    long int nb_dropped_;
+};
+
+}  // namespace o80
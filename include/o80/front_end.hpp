@@ -9,16 +9,18 @@
 #include "burster.hpp"
 #include "o80_internal/command.hpp"
 #include "observation.hpp"
+#include "observer_front_end.hpp"
 #include "shared_memory/shared_memory.hpp"
-#include "synchronizer/leader.hpp"
 #include "time_series/multiprocess_time_series.hpp"
 #include "time_series/time_series.hpp"
+#include "transport.hpp"
 
 namespace o80
 
 {
 /*! A frontend sends commands to a related backend and
- *  read observations writen by this same backend.
+ *  read observations writen by this same backend (see ObserverFrontEnd
+ *  for the methods reading observations).
  * @tparam QUEUE_SIZE size of the commands and observations
            time series
  * @tparam NB_ACTUATORS number of actuators of the robot
@@ -32,96 +34,45 @@ template <int QUEUE_SIZE,
           class ROBOT_STATE,
           class EXTENDED_STATE>
 class FrontEnd
+    : public ObserverFrontEnd<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>
 {
 public:
-    /*! multiprocess time series hosting commands shared with the backend*/
-    typedef time_series::MultiprocessTimeSeries<Command<ROBOT_STATE>>
-        CommandsTimeSeries;
+    /*! reading observations*/
+    typedef ObserverFrontEnd<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>
+        Observer;
+    /*! channels shared with the backend*/
+    typedef typename Observer::FrontendTransport FrontendTransport;
+    /*! time series hosting commands shared with the backend*/
+    typedef typename FrontendTransport::CommandsTimeSeries CommandsTimeSeries;
     /*! time series buffering commands before their transfer
         to the commands time series*/
     typedef time_series::TimeSeries<Command<ROBOT_STATE>>
         BufferCommandsTimeSeries;
-    /*! multiprocess times series hosting the commands id that have been
+    /*! times series hosting the commands id that have been
         processed by the backend*/
-    typedef time_series::MultiprocessTimeSeries<int>
+    typedef typename FrontendTransport::CompletedCommandsTimeSeries
         CompletedCommandsTimeSeries;
-    /*! multprocess time series hosting the observations writen by the backend*/
-    typedef time_series::MultiprocessTimeSeries<
-        Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>>
-        ObservationsTimeSeries;
+    /*! time series hosting the observations writen by the backend*/
+    typedef typename Observer::ObservationsTimeSeries ObservationsTimeSeries;
     /*! vector of observations*/
-    typedef std::vector<Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>>
-        Observations;
-    /*! for bursting mode support */
-    typedef std::shared_ptr<BursterClient> BursterClientPtr;
+    typedef typename Observer::Observations Observations;
 
 public:
     /**
      * @param segment_id should be the same for the
      *        backend and the frontend
+     * @param transport (default shared memory) should be the
+     *        same as the one used by the backend. IN_PROCESS
+     *        requires the backend to run in the same process.
      */
-    FrontEnd(std::string segment_id);
+    FrontEnd(std::string segment_id, TransportType transport = SHARED_MEMORY);
 
     ~FrontEnd();
 
-    // TODO: to revive
-    // void start_logging(std::string logger_segment_id);
-
-    /*! Returns the frequency at which the backend is set to run.
-      This will return a value only if the backend has been instantiated
-      by a standalone. Otherwise, throws a runtime_error
-    */
-    float get_frequency() const;
-
-    /*!returns the number of actuators*/
-    int get_nb_actuators() const;
-
-    /*! Read from the shared memory all the observations
-        starting from the specified iteration until the newest
-        iteration and update the observations vector with them.
-     *  @param[in] iteration: iteration number of the backend
-     *  @param[out] push_back_to: vector of observations to be updated.
-     */
-    bool observations_since(time_series::Index iteration,
-                            Observations& push_back_to);
-
-    /*! Read from the shared memory
-        the latest nb_items observations
-        update the observations vector with them.
-     *  @param[in] iteration: iteration number of the backend
-     *  @param[out] push_back_to: vector of observations to be updated.
-     */
-    bool update_latest_observations(size_t nb_items,
-                                    Observations& push_back_to);
-
-    /*! Returns a vector of observations containing all observations
-     *  starting from the specified iteration until the latest iteration
-     *  @param iteration: iteration number
-     */
-    Observations get_observations_since(time_series::Index iteration);
-
-    /*! Returns a vector of observations containing the nb_items
-     *  latest  observations.
-     *  @param iteration: number of observations to read
-     */
-    Observations get_latest_observations(size_t nb_items);
-
-    /*! waiting for the next observation to be writen by the backend, then
-     *  returning it. During the first call to this method, the current
-     *  iteration is initialized as reference iteration, then the reference
-     *  iteration will be increase by one at each call*/
-    Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE> wait_for_next();
-
-    /*! if returns true: during its latest iteration, the backend did not
-     * reapply the previous desired states (i.e. at least one command was
-     * active), if false, the backend reapplied the previous desired state (no
-     * active command)
-     */
-    bool backend_is_active();
-
-    /*! reset the reference iteration used by the "wait_for_next" method
-     *  to the current iteration number*/
-    void reset_next_index();
+    /*! same as ObserverFrontEnd::reattach. Commands buffered but not
+        shared yet are shared with the new backend at the next pulse,
+        commands already shared with the previous backend are lost.*/
+    bool reattach();
 
     /*! add a command to the buffer commands time series.*/
     void add_command(int nb_actuator,
@@ -144,6 +95,26 @@ public:
                      Speed speed,
                      Mode mode);
 
+    /*! add commands to the buffer commands time series, in a single
+     *  call: the command at index i targets the actuator dofs[i], with
+     *  the state target_states[i], to reach over durations[i].
+     *  Throws a std::runtime_error if the vectors are not of the same size.
+     */
+    void add_commands(const std::vector<int>& dofs,
+                      const std::vector<ROBOT_STATE>& target_states,
+                      const std::vector<Duration_us>& durations,
+                      Mode mode);
+
+    /*! add commands to the buffer commands time series, in a single
+     *  call: the command at index i targets the actuator dofs[i], with
+     *  the state target_states[i], to reach at iterations[i].
+     *  Throws a std::runtime_error if the vectors are not of the same size.
+     */
+    void add_commands(const std::vector<int>& dofs,
+                      const std::vector<ROBOT_STATE>& target_states,
+                      const std::vector<Iteration>& iterations,
+                      Mode mode);
+
     /*! add to each actuator an overwriting command with
      *  the initial state (as returned by the initial_states method)
      *  as target state  */
@@ -199,54 +170,57 @@ public:
      */
     Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE> wait();
 
-    /*! write all buffered commands to the multiprocess time series commands
-     *  (i.e. the related backend will read and execute them), then wait for the
-     *  backend to finish executation of all commands, then return the latest
-     *  observation.
-     */
-    Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE> read(
-        long int iteration = -1);
-
-    /*!
-     * returns the first states ever observed by the backend
-     */
-    States<NB_ACTUATORS, ROBOT_STATE> initial_states() const;
-
 public:
     /*! returns the time series of commands shared between the
-     *   frontend and the backend*/
-    static auto get_introspection_commands(std::string segment_id);
+     *  frontend and the backend of the segment (via the transport
+     *  used by the backend, which should be running)*/
+    static std::shared_ptr<CommandsTimeSeries> get_introspection_commands(
+        std::string segment_id, TransportType transport = SHARED_MEMORY);
 
     /*! returns the time series of (completed) command ids
      *  shared between the frontend and the backend*/
-    static auto get_introspection_completed_commands(std::string segment_id);
+    static std::shared_ptr<CompletedCommandsTimeSeries>
+    get_introspection_completed_commands(
+        std::string segment_id, TransportType transport = SHARED_MEMORY);
 
     /*! returns the time series of command ids the frontend
-     *  waits completion of */
-    static auto get_introspection_waiting_for_completion(
-        std::string segment_id);
+     *  waits completion of. Throws a runtime_error if disabled
+     *  by the layout of the segment.*/
+    static std::shared_ptr<CompletedCommandsTimeSeries>
+    get_introspection_waiting_for_completion(
+        std::string segment_id, TransportType transport = SHARED_MEMORY);
 
     /*! returns the time series of command ids the frontend
-     *  processed reports of completion */
-    static auto get_introspection_completion_reported(std::string segment_id);
+     *  processed reports of completion. Throws a runtime_error if
+     *  disabled by the layout of the segment.*/
+    static std::shared_ptr<CompletedCommandsTimeSeries>
+    get_introspection_completion_reported(
+        std::string segment_id, TransportType transport = SHARED_MEMORY);
 
 private:
     void size_check();
+    template <class TARGET>
+    void add_commands_(const std::vector<int>& dofs,
+                       const std::vector<ROBOT_STATE>& target_states,
+                       const std::vector<TARGET>& targets,
+                       Mode mode);
     time_series::Index last_index_read_by_backend();
     void share_commands(std::set<int>& command_ids, bool store);
     void wait_for_completion(std::set<int>& command_ids,
                              time_series::Index completed_index);
 
 private:
+    using Observer::observations_;
+    using Observer::segment_id_;
+    using Observer::transport_;
+
     // to delete !
     void _print(CommandsTimeSeries* time_series);
 
-    std::string segment_id_;
-
     time_series::Index history_index_;
 
     // used to write commands to the shared memory
-    CommandsTimeSeries commands_;
+    CommandsTimeSeries* commands_;
     // tracking ids of commands shared by this frontend.
     // used by the "pulse_and_wait" method.
     std::set<int> sent_command_ids_;
@@ -261,31 +235,30 @@ private:
     BufferCommandsTimeSeries buffer_commands_;
     time_series::Index buffer_index_;
 
-    // backend will write observation into it
-    ObservationsTimeSeries observations_;
-    time_series::Index observations_index_;
-
     // backend will write into it completed commands
     // used by the method "pulse_and_wait" (i.e. waiting
     // for shared commands to be completed)
-    CompletedCommandsTimeSeries completed_commands_;
+    CompletedCommandsTimeSeries* completed_commands_;
 
     // everytime the frontend will wait for the completion of a
     // command (pulse_and_wait method), it will write the corresponding id in
-    // this time series. For debug and introspection.
-    CompletedCommandsTimeSeries waiting_for_completion_;
+    // this time series. For debug and introspection
+    // (nullptr if disabled by the segment layout).
+    CompletedCommandsTimeSeries* waiting_for_completion_;
 
     // everytime the frontend will process the information that a
     // command has been completed by the backend, its id will be
-    // written in this time series. For debug and introspection.
-    CompletedCommandsTimeSeries completion_reported_;
+    // written in this time series. For debug and introspection
+    // (nullptr if disabled by the segment layout).
+    CompletedCommandsTimeSeries* completion_reported_;
+
+    // lifecycle events of the commands shared and waited for by this
+    // frontend (nullptr if disabled by the segment layout)
+    TracesTimeSeries* traces_;
 
     // for the use of prepare_wait
     int completed_index_;
     bool wait_prepared_;
-
-    // for bursting mode support
-    BursterClientPtr burster_client_;
 };
 
 #include "front_end.hxx"
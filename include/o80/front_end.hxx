@@ -9,26 +9,20 @@
 #define FRONTEND FrontEnd<QUEUE_SIZE, NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>
 
 TEMPLATE_FRONTEND
-FRONTEND::FrontEnd(std::string segment_id)
-    : segment_id_(segment_id),
-      commands_{CommandsTimeSeries::create_follower(segment_id + "_commands")},
-      buffer_commands_(QUEUE_SIZE),
+FRONTEND::FrontEnd(std::string segment_id, TransportType transport)
+    : Observer(segment_id, transport),
+      commands_(&transport_->commands()),
+      buffer_commands_(transport_->get_layout().commands_size),
       buffer_index_(0),
-      observations_{ObservationsTimeSeries::create_follower(segment_id +
-                                                            "_observations")},
-      completed_commands_{CompletedCommandsTimeSeries::create_follower(
-          segment_id + "_completed")},
+      completed_commands_(&transport_->completed()),
+      waiting_for_completion_(transport_->waiting_for_completion()),
+      completion_reported_(transport_->completion_reported()),
+      traces_(transport_->traces()),
       completed_index_(-1),
-      wait_prepared_(false),
-      waiting_for_completion_{CompletedCommandsTimeSeries::create_follower(
-          segment_id + "_waiting_for_completion")},
-      completion_reported_{CompletedCommandsTimeSeries::create_follower(
-          segment_id + "_completion_reported")},
-      burster_client_{nullptr}
+      wait_prepared_(false)
 {
-    shared_memory::get<long int>(segment_id_, "pulse_id", pulse_id_);
+    pulse_id_ = transport_->get_pulse_id();
     pulse_id_++;
-    observations_index_ = observations_.newest_timeindex(false);
 }
 
 TEMPLATE_FRONTEND
@@ -37,122 +31,27 @@ FRONTEND::~FrontEnd()
 }
 
 TEMPLATE_FRONTEND
-float FRONTEND::get_frequency() const
+bool FRONTEND::reattach()
 {
-    float value;
-    try
-    {
-        shared_memory::get<float>(segment_id_, "frequency", value);
-    }
-    catch (const shared_memory::Allocation_exception& e)
-    {
-        std::string error =
-            std::string("failed to read the frequency of o80 backend ") +
-            segment_id_ +
-            std::string(
-                ": only backend instantiated via a standalone provide "
-                "their frequency.");
-        throw std::runtime_error(error);
-    }
-    return value;
-}
-
-TEMPLATE_FRONTEND
-int FRONTEND::get_nb_actuators() const
-{
-    return NB_ACTUATORS;
-}
-
-TEMPLATE_FRONTEND
-Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE> FRONTEND::wait_for_next()
-{
-    observations_index_ += 1;
-    time_series::Index newest = observations_.newest_timeindex(false);
-    while (newest < observations_index_)
-    {
-        usleep(10);
-        newest = observations_.newest_timeindex(false);
-    }
-    Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE> obs =
-        observations_[observations_index_];
-    return obs;
-}
-
-TEMPLATE_FRONTEND
-void FRONTEND::reset_next_index()
-{
-    observations_index_ = observations_.newest_timeindex(false);
-}
-
-TEMPLATE_FRONTEND
-bool FRONTEND::observations_since(
-    time_series::Index time_index,
-    std::vector<Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>>& v)
-{
-    time_series::Index oldest = observations_.oldest_timeindex();
-    time_series::Index newest = observations_.newest_timeindex();
-    if (time_index > newest || time_index < oldest)
+    if (!Observer::reattach())
     {
         return false;
     }
-    for (time_series::Index index = time_index; index <= newest; index++)
-    {
-        v.push_back(observations_[index]);
-    }
+    commands_ = &transport_->commands();
+    completed_commands_ = &transport_->completed();
+    waiting_for_completion_ = transport_->waiting_for_completion();
+    completion_reported_ = transport_->completion_reported();
+    traces_ = transport_->traces();
+    sent_command_ids_.clear();
+    completed_index_ = -1;
+    wait_prepared_ = false;
     return true;
 }
 
-TEMPLATE_FRONTEND
-std::vector<Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>>
-FRONTEND::get_observations_since(time_series::Index time_index)
-{
-    std::vector<Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>> v;
-    observations_since(time_index, v);
-    return v;
-}
-
-TEMPLATE_FRONTEND
-bool FRONTEND::update_latest_observations(
-    size_t nb_items,
-    std::vector<Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>>& v)
-{
-    bool r = true;
-    time_series::Index oldest = observations_.oldest_timeindex();
-    time_series::Index newest = observations_.newest_timeindex();
-    time_series::Index target = newest - nb_items + 1;
-    if (target < oldest)
-    {
-        target = oldest;
-        r = false;
-    }
-    for (time_series::Index index = target; index <= newest; index++)
-    {
-        v.push_back(observations_[index]);
-    }
-    return r;
-}
-
-TEMPLATE_FRONTEND
-std::vector<Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>>
-FRONTEND::get_latest_observations(size_t nb_items)
-{
-    std::vector<Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>> v;
-    update_latest_observations(nb_items, v);
-    return v;
-}
-
-TEMPLATE_FRONTEND
-bool FRONTEND::backend_is_active()
-{
-    bool active;
-    shared_memory::get<bool>(segment_id_, "active", active);
-    return active;
-}
-
 TEMPLATE_FRONTEND
 void FRONTEND::purge() const
 {
-    shared_memory::set<bool>(segment_id_, "purge", true);
+    transport_->set_purge(true);
 }
 
 TEMPLATE_FRONTEND
@@ -195,10 +94,59 @@ void FRONTEND::add_command(int nb_actuator, ROBOT_STATE target_state, Mode mode)
     buffer_commands_.append(command);
 }
 
+TEMPLATE_FRONTEND
+template <class TARGET>
+void FRONTEND::add_commands_(const std::vector<int>& dofs,
+                             const std::vector<ROBOT_STATE>& target_states,
+                             const std::vector<TARGET>& targets,
+                             Mode mode)
+{
+    if (dofs.size() != target_states.size() || dofs.size() != targets.size())
+    {
+        throw std::runtime_error(
+            "add_commands: dofs, target states and durations (or "
+            "iterations) should be of the same size");
+    }
+    for (std::size_t index = 0; index < dofs.size(); index++)
+    {
+        if (dofs[index] < 0 || dofs[index] >= NB_ACTUATORS)
+        {
+            throw std::runtime_error("add_commands: invalid dof " +
+                                     std::to_string(dofs[index]));
+        }
+    }
+    for (std::size_t index = 0; index < dofs.size(); index++)
+    {
+        buffer_commands_.append(Command<ROBOT_STATE>(pulse_id_,
+                                                     target_states[index],
+                                                     targets[index],
+                                                     dofs[index],
+                                                     mode));
+    }
+}
+
+TEMPLATE_FRONTEND
+void FRONTEND::add_commands(const std::vector<int>& dofs,
+                            const std::vector<ROBOT_STATE>& target_states,
+                            const std::vector<Duration_us>& durations,
+                            Mode mode)
+{
+    add_commands_(dofs, target_states, durations, mode);
+}
+
+TEMPLATE_FRONTEND
+void FRONTEND::add_commands(const std::vector<int>& dofs,
+                            const std::vector<ROBOT_STATE>& target_states,
+                            const std::vector<Iteration>& iterations,
+                            Mode mode)
+{
+    add_commands_(dofs, target_states, iterations, mode);
+}
+
 TEMPLATE_FRONTEND
 void FRONTEND::add_reinit_command()
 {
-    States<NB_ACTUATORS, ROBOT_STATE> init_states = initial_states();
+    States<NB_ACTUATORS, ROBOT_STATE> init_states = this->initial_states();
     for (int actuator = 0; actuator < NB_ACTUATORS; actuator++)
     {
         add_command(actuator, init_states.get(actuator), Mode::OVERWRITE);
@@ -208,9 +156,7 @@ void FRONTEND::add_reinit_command()
 TEMPLATE_FRONTEND
 time_series::Index FRONTEND::last_index_read_by_backend()
 {
-    time_series::Index index;
-    shared_memory::get<time_series::Index>(segment_id_, "command_read", index);
-    return index;
+    return transport_->get_command_read();
 }
 
 TEMPLATE_FRONTEND
@@ -222,18 +168,18 @@ void FRONTEND::size_check()
     {
         throw std::runtime_error("shared memory commands buffer too large");
     }
-    if (nb_new_commands > commands_.max_length())
+    if (nb_new_commands > commands_->max_length())
     {
         throw std::runtime_error("shared memory commands exchange full");
     }
-    if (commands_.is_empty())
+    if (commands_->is_empty())
     {
         return;
     }
     time_series::Index latest_read = last_index_read_by_backend();
     std::size_t nb_not_read_yet =
-        commands_.newest_timeindex(false) - latest_read;
-    std::size_t nb_free_slots = commands_.max_length() - nb_not_read_yet;
+        commands_->newest_timeindex(false) - latest_read;
+    std::size_t nb_free_slots = commands_->max_length() - nb_not_read_yet;
     if (nb_new_commands > nb_free_slots)
     {
         throw std::runtime_error("shared memory commands exchange full");
@@ -260,6 +206,8 @@ void FRONTEND::share_commands(std::set<int>& command_ids, bool store)
         return;
     }
 
+    Tracer::trace(this->trace_segment_, FRONTEND_COMMUNICATE);
+
     // sharing new commands
     for (time_series::Index index = buffer_index_; index <= last_index; index++)
     {
@@ -268,11 +216,15 @@ void FRONTEND::share_commands(std::set<int>& command_ids, bool store)
         {
             command_ids.insert(command.get_id());
         }
-        commands_.append(command);
+        if (traces_ != nullptr)
+        {
+            traces_->append(CommandTrace(command.get_id(), COMMAND_SHARED, -1));
+        }
+        commands_->append(command);
     }
 
     // sync with backend
-    shared_memory::set<long int>(segment_id_, "pulse_id", pulse_id_);
+    transport_->set_pulse_id(pulse_id_);
     pulse_id_++;
 
     buffer_index_ = last_index + 1;
@@ -282,21 +234,37 @@ TEMPLATE_FRONTEND
 void FRONTEND::wait_for_completion(std::set<int>& command_ids,
                                    time_series::Index completed_index)
 {
+    Tracer::trace(this->trace_segment_, FRONTEND_COMPLETION_WAIT_START);
     for (int command_id : command_ids)
     {
         // for debug and introspection
-        waiting_for_completion_.append(command_id);
+        if (waiting_for_completion_ != nullptr)
+        {
+            waiting_for_completion_->append(command_id);
+        }
+        if (traces_ != nullptr)
+        {
+            traces_->append(CommandTrace(command_id, COMMAND_WAITED_FOR, -1));
+        }
     }
     completed_index++;
     while (true)
     {
-        time_series::Index command_id = completed_commands_[completed_index];
-        command_ids.erase(command_id);
+        time_series::Index command_id = (*completed_commands_)[completed_index];
+        bool waited_for = command_ids.erase(command_id) > 0;
         // for debug and introspection
-        completion_reported_.append(command_id);
+        if (completion_reported_ != nullptr)
+        {
+            completion_reported_->append(command_id);
+        }
+        if (traces_ != nullptr && waited_for)
+        {
+            traces_->append(CommandTrace(command_id, COMMAND_REPORTED, -1));
+        }
         if (command_ids.empty())
         {
-	  return;
+            Tracer::trace(this->trace_segment_, FRONTEND_COMPLETION_WAIT_END);
+            return;
         }
         completed_index++;
         usleep(1);
@@ -307,37 +275,42 @@ TEMPLATE_FRONTEND
 Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE> FRONTEND::pulse(
     Iteration iteration)
 {
+    reattach();
     wait_prepared_ = false;
     share_commands(sent_command_ids_, false);
-    observations_.wait_for_timeindex(iteration.value);
-    return observations_[iteration.value];
+    Tracer::trace(this->trace_segment_, FRONTEND_WAIT_START);
+    observations_->wait_for_timeindex(iteration.value);
+    Tracer::trace(this->trace_segment_, FRONTEND_WAIT_END);
+    return (*observations_)[iteration.value];
 }
 
 TEMPLATE_FRONTEND
 Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE> FRONTEND::pulse()
 {
+    reattach();
     wait_prepared_ = false;
     share_commands(sent_command_ids_, false);
-    if (observations_.is_empty())
+    if (observations_->is_empty())
     {
         return Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>();
     }
-    return observations_.newest_element();
+    return observations_->newest_element();
 }
 
 TEMPLATE_FRONTEND
 Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>
 FRONTEND::pulse_prepare_wait()
 {
+    reattach();
     sent_command_ids_.clear();
     completed_index_ = -1;
-    if (!completed_commands_.is_empty())
+    if (!completed_commands_->is_empty())
     {
-        completed_index_ = completed_commands_.newest_timeindex();
+        completed_index_ = completed_commands_->newest_timeindex();
     }
     share_commands(sent_command_ids_, true);
     wait_prepared_ = true;
-    return observations_.newest_element();
+    return observations_->newest_element();
 }
 
 TEMPLATE_FRONTEND
@@ -355,103 +328,93 @@ TEMPLATE_FRONTEND
 Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>
 FRONTEND::pulse_and_wait()
 {
+    reattach();
     sent_command_ids_.clear();
     int completed_index = -1;
-    if (!completed_commands_.is_empty())
+    if (!completed_commands_->is_empty())
     {
-        completed_index = completed_commands_.newest_timeindex();
+        completed_index = completed_commands_->newest_timeindex();
     }
     share_commands(sent_command_ids_, true);
     wait_for_completion(sent_command_ids_, completed_index);
-    return observations_.newest_element();
+    return observations_->newest_element();
 }
 
 TEMPLATE_FRONTEND
 Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE> FRONTEND::burst(
     int nb_iterations)
 {
+    reattach();
     share_commands(sent_command_ids_, false);
-    if (burster_client_ == nullptr)
-    {
-        burster_client_.reset(new BursterClient(segment_id_));
-    }
-    burster_client_->burst(nb_iterations);
-    if (observations_.is_empty())
+    Tracer::trace(this->trace_segment_, FRONTEND_WAIT_START);
+    transport_->burst(nb_iterations);
+    Tracer::trace(this->trace_segment_, FRONTEND_WAIT_END);
+    if (observations_->is_empty())
     {
         return Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>();
     }
-    return observations_.newest_element();
+    return observations_->newest_element();
 }
 
 TEMPLATE_FRONTEND
 void FRONTEND::final_burst()
 {
-    if (burster_client_ != nullptr)
-    {
-        burster_client_->final_burst();
-    }
-}
-
-TEMPLATE_FRONTEND
-Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE> FRONTEND::read(
-    long int iteration)
-{
-    // no observation yet, throwing error
-    if (observations_.is_empty())
-    {
-        return Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>();
-    }
-
-    // current observation
-    if (iteration < 0)
-    {
-        return observations_.newest_element();
-    }
-
-    // past observations
-    time_series::Index oldest = observations_.oldest_timeindex();
-    if (iteration < oldest)
-    {
-        std::string error = "o80 frontend read: can not return iteration ";
-        error += std::to_string(iteration);
-        error += "(oldest iteration available: " + std::to_string(oldest) + ")";
-        throw std::range_error(error);
-    }
-
-    return observations_[iteration];
-}
-
-TEMPLATE_FRONTEND
-States<NB_ACTUATORS, ROBOT_STATE> FRONTEND::initial_states() const
-{
-    States<NB_ACTUATORS, ROBOT_STATE> r;
-    shared_memory::deserialize(segment_id_, "initial_states", r);
-    return r;
+    transport_->final_burst();
 }
 
 TEMPLATE_FRONTEND
-auto FRONTEND::get_introspection_commands(std::string segment_id)
+std::shared_ptr<typename FRONTEND::CommandsTimeSeries>
+FRONTEND::get_introspection_commands(std::string segment_id,
+                                     TransportType transport)
 {
-    return CommandsTimeSeries::create_follower_ptr(segment_id + "_commands");
+    std::shared_ptr<FrontendTransport> t = FrontendTransport::create(
+        segment_id, transport, false, SegmentLayout());
+    // the returned pointer keeps the transport alive
+    return std::shared_ptr<CommandsTimeSeries>(t, &t->commands());
 }
 
 TEMPLATE_FRONTEND
-auto FRONTEND::get_introspection_completed_commands(std::string segment_id)
+std::shared_ptr<typename FRONTEND::CompletedCommandsTimeSeries>
+FRONTEND::get_introspection_completed_commands(std::string segment_id,
+                                               TransportType transport)
 {
-    return CompletedCommandsTimeSeries::create_follower_ptr(segment_id +
-                                                            "_completed");
+    std::shared_ptr<FrontendTransport> t = FrontendTransport::create(
+        segment_id, transport, false, SegmentLayout());
+    return std::shared_ptr<CompletedCommandsTimeSeries>(t, &t->completed());
 }
 
 TEMPLATE_FRONTEND
-auto FRONTEND::get_introspection_waiting_for_completion(std::string segment_id)
+std::shared_ptr<typename FRONTEND::CompletedCommandsTimeSeries>
+FRONTEND::get_introspection_waiting_for_completion(std::string segment_id,
+                                                   TransportType transport)
 {
-    return CompletedCommandsTimeSeries::create_follower_ptr(
-        segment_id + "_waiting_for_completion");
+    std::shared_ptr<FrontendTransport> t = FrontendTransport::create(
+        segment_id, transport, false, SegmentLayout());
+    CompletedCommandsTimeSeries* ts = t->waiting_for_completion();
+    if (ts == nullptr)
+    {
+        throw std::runtime_error(
+            "o80 frontend: the time series of commands waited for is "
+            "disabled by the layout of segment " +
+            segment_id);
+    }
+    return std::shared_ptr<CompletedCommandsTimeSeries>(t, ts);
 }
 
 TEMPLATE_FRONTEND
-auto FRONTEND::get_introspection_completion_reported(std::string segment_id)
+std::shared_ptr<typename FRONTEND::CompletedCommandsTimeSeries>
+FRONTEND::get_introspection_completion_reported(std::string segment_id,
+                                                TransportType transport)
 {
-    return CompletedCommandsTimeSeries::create_follower(segment_id +
-                                                        "_completion_reported");
+    std::shared_ptr<FrontendTransport> t = FrontendTransport::create(
+        segment_id, transport, false, SegmentLayout());
+    CompletedCommandsTimeSeries* ts = t->completion_reported();
+    if (ts == nullptr)
+    {
+        throw std::runtime_error(
+            "o80 frontend: the time series of reported completions is "
+            "disabled by the layout of segment " +
+            segment_id);
+    }
+    return std::shared_ptr<CompletedCommandsTimeSeries>(t, ts);
 }
@@ -0,0 +1,84 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "o80/front_end.hpp"
+#include "o80/observation.hpp"
+#include "o80/states.hpp"
+#include "o80/transport.hpp"
+#include "o80_internal/worker_pool.hpp"
+
+namespace o80
+{
+/**
+ * ! Group of frontends, each connected to a (bursting) standalone
+ *   (e.g. started via StandaloneGroup). The frontends are operated
+ *   concurrently by a pool of worker threads, so that all the
+ *   standalones burst in parallel.
+ *   @tparam QUEUE_SIZE size of the commands and observations time series
+ *   @tparam NB_ACTUATORS number of actuators of the robot
+ *   @tparam ROBOT_STATE class encapsulating the state of an actuator
+ *   @tparam EXTENDED_STATE class encapsulating supplementary
+ *           arbitrary information
+ */
+template <int QUEUE_SIZE,
+          int NB_ACTUATORS,
+          class ROBOT_STATE,
+          class EXTENDED_STATE>
+class FrontEndGroup
+{
+public:
+    typedef FrontEnd<QUEUE_SIZE, NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>
+        Frontend;
+    typedef Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>
+        GroupObservation;
+    /*! one observation per frontend of the group*/
+    typedef std::vector<GroupObservation> Observations;
+    /*! one instance of States per frontend of the group*/
+    typedef std::vector<States<NB_ACTUATORS, ROBOT_STATE>> Actions;
+
+public:
+    /**
+     * @param segment_ids one frontend is created per segment id
+     * @param nb_workers number of worker threads (if not positive:
+     *        one per frontend)
+     * @param transport should be the one used by the standalones
+     */
+    FrontEndGroup(const std::vector<std::string>& segment_ids,
+                  int nb_workers = -1,
+                  TransportType transport = SHARED_MEMORY);
+
+    /*! number of frontends*/
+    int size() const;
+
+    /*! returns the frontend of the specified index*/
+    Frontend& get(int index);
+
+    /*! for each frontend, adds overwriting commands setting the
+        desired state of each actuator to the corresponding value of
+        actions, then requests its standalone to burst nb_iterations.
+        Returns the resulting observations. Throws a runtime_error if
+        the size of actions does not match the size of the group.*/
+    Observations step(const Actions& actions, long int nb_iterations = 1);
+
+    /*! requests all standalones to burst nb_iterations, and
+        returns the resulting observations*/
+    Observations burst(long int nb_iterations = 1);
+
+    /*! returns the latest observation of each frontend*/
+    Observations latest();
+
+    /*! calls final_burst on each frontend*/
+    void final_burst();
+
+private:
+    std::vector<std::shared_ptr<Frontend>> frontends_;
+    internal::WorkerPool workers_;
+};
+
+#include "front_end_group.hxx"
+}  // namespace o80
@@ -0,0 +1,91 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#define TEMPLATE_FRONTEND_GROUP  \
+    template <int QUEUE_SIZE,    \
+              int NB_ACTUATORS,  \
+              class ROBOT_STATE, \
+              class EXTENDED_STATE>
+
+#define FRONTEND_GROUP \
+    FrontEndGroup<QUEUE_SIZE, NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>
+
+TEMPLATE_FRONTEND_GROUP
+FRONTEND_GROUP::FrontEndGroup(const std::vector<std::string>& segment_ids,
+                              int nb_workers,
+                              TransportType transport)
+    : workers_(nb_workers > 0 ? nb_workers
+                              : static_cast<int>(segment_ids.size()))
+{
+    for (const std::string& segment_id : segment_ids)
+    {
+        frontends_.push_back(std::make_shared<Frontend>(segment_id, transport));
+    }
+}
+
+TEMPLATE_FRONTEND_GROUP
+int FRONTEND_GROUP::size() const
+{
+    return frontends_.size();
+}
+
+TEMPLATE_FRONTEND_GROUP
+typename FRONTEND_GROUP::Frontend& FRONTEND_GROUP::get(int index)
+{
+    return *frontends_.at(index);
+}
+
+TEMPLATE_FRONTEND_GROUP
+typename FRONTEND_GROUP::Observations FRONTEND_GROUP::step(
+    const Actions& actions, long int nb_iterations)
+{
+    if (actions.size() != frontends_.size())
+    {
+        throw std::runtime_error(
+            "o80 frontend group: number of actions does not match "
+            "the number of frontends");
+    }
+    Observations observations(frontends_.size());
+    workers_.run(frontends_.size(), [&](int index) {
+        Frontend& frontend = *frontends_[index];
+        for (int dof = 0; dof < NB_ACTUATORS; dof++)
+        {
+            frontend.add_command(
+                dof, actions[index].get(dof), Mode::OVERWRITE);
+        }
+        observations[index] = frontend.burst(nb_iterations);
+    });
+    return observations;
+}
+
+TEMPLATE_FRONTEND_GROUP
+typename FRONTEND_GROUP::Observations FRONTEND_GROUP::burst(
+    long int nb_iterations)
+{
+    Observations observations(frontends_.size());
+    workers_.run(frontends_.size(), [&](int index) {
+        observations[index] = frontends_[index]->burst(nb_iterations);
+    });
+    return observations;
+}
+
+TEMPLATE_FRONTEND_GROUP
+typename FRONTEND_GROUP::Observations FRONTEND_GROUP::latest()
+{
+    Observations observations;
+    observations.reserve(frontends_.size());
+    for (std::shared_ptr<Frontend>& frontend : frontends_)
+    {
+        observations.push_back(frontend->read(-1));
+    }
+    return observations;
+}
+
+TEMPLATE_FRONTEND_GROUP
+void FRONTEND_GROUP::final_burst()
+{
+    for (std::shared_ptr<Frontend>& frontend : frontends_)
+    {
+        frontend->final_burst();
+    }
+}
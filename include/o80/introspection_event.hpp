@@ -0,0 +1,75 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace o80
+{
+/*! step of the lifecycle of a command, as recorded by Introspector*/
+enum CommandEvent
+{
+    COMMAND_SHARED,      // a frontend shared the command with the backend
+    COMMAND_RECEIVED,    // the backend received it
+    COMMAND_STARTING,    // the backend started its execution
+    COMMAND_COMPLETED,   // the backend completed it
+    COMMAND_WAITED_FOR,  // a frontend waits for its completion
+    COMMAND_REPORTED,    // a frontend processed its completion
+    NB_COMMAND_EVENTS
+};
+
+/*! format of the files written by Introspector*/
+enum IntrospectionFormat
+{
+    INTROSPECTION_CSV,
+    INTROSPECTION_BINARY
+};
+
+/**
+ * ! An event of the lifecycle of a command. Introspector writes them
+ *   either as csv (see csv_header) or as binary records of 16 bytes
+ *   (native endianness): time stamp (double, milliseconds), command id
+ *   (int32), event (int16) and actuator (int16), preceded by the 8 bytes
+ *   header "o80evt1".
+ */
+class IntrospectionEvent
+{
+public:
+    IntrospectionEvent();
+
+    /**
+     * @param actuator the actuator the command applies to, or -1
+     *        if not known (only the shared commands events provide it)
+     */
+    IntrospectionEvent(double timestamp_ms,
+                       int command_id,
+                       CommandEvent event,
+                       int actuator = -1);
+
+    std::string to_string() const;
+
+    /*! "timestamp_ms,event,command_id,actuator"*/
+    static std::string csv_header();
+    std::string to_csv() const;
+
+    static void write_binary_header(std::ostream& stream);
+    void write_binary(std::ostream& stream) const;
+
+    /*! reads the events of a file written by Introspector
+        (csv or binary). Throws a runtime_error if the file can not
+        be read.*/
+    static std::vector<IntrospectionEvent> read_file(const std::string& path);
+
+    static std::string event_name(CommandEvent event);
+
+public:
+    double timestamp_ms;
+    int command_id;
+    CommandEvent event;
+    int actuator;
+};
+}  // namespace o80
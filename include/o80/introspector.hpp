@@ -1,30 +1,37 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <deque>
+#include <fstream>
 #include <memory>
 #include <mutex>
-#include <real_time_tools/thread.hpp>
-#include "o80/front_end.hpp"
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "o80/introspection_event.hpp"
+#include "o80/segment_layout.hpp"
+#include "o80_internal/command.hpp"
+#include "shared_memory/shared_memory.hpp"
+#include "time_series/multiprocess_time_series.hpp"
 
 namespace o80
 {
-namespace internal
-{
-template <class ROBOT_STATE>
-THREAD_FUNCTION_RETURN_TYPE run_commands_helper(void *arg);
-template <class ROBOT_STATE>
-THREAD_FUNCTION_RETURN_TYPE run_completed_commands_helper(void *arg);
-template <class ROBOT_STATE>
-THREAD_FUNCTION_RETURN_TYPE run_waiting_for_completion_helper(void *arg);
-template <class ROBOT_STATE>
-THREAD_FUNCTION_RETURN_TYPE run_completion_reported_helper(void *arg);
-template <class ROBOT_STATE>
-THREAD_FUNCTION_RETURN_TYPE run_received_helper(void *arg);
-template <class ROBOT_STATE>
-THREAD_FUNCTION_RETURN_TYPE run_starting_helper(void *arg);
-}  // namespace internal
-
+/**
+ * ! Records the lifecycle of the commands of a backend (shared, received,
+ *   started and completed by the backend, waited for and reported by
+ *   the frontends). A single (non real time) thread polls the time series
+ *   of the backend, merges their new items into a stream of
+ *   IntrospectionEvent sorted by time stamp, and writes it to a file
+ *   (csv or binary) and to a ring of the latest events (see get_events).
+ *   The CPU used is bounded by the polling period and the max number
+ *   of events processed per poll: if more events are available, the
+ *   oldest are skipped (see nb_dropped). Supports only the shared
+ *   memory transport. If the introspection time series are disabled by
+ *   the segment layout, only the shared and completed events are recorded.
+ */
 template <class ROBOT_STATE>
 class Introspector
 {
@@ -35,54 +42,83 @@ public:
         CompletedCommandsTimeSeries;
 
 public:
-    Introspector(std::string segment_id);
+    /**
+     * @param segment_id segment id of the backend
+     * @param path file the events are written to (none if empty)
+     * @param format csv or binary (see IntrospectionEvent)
+     * @param ring_size number of latest events kept in memory
+     * @param period_ms period at which the time series are polled
+     * @param max_events max number of events processed per poll
+     */
+    Introspector(std::string segment_id,
+                 std::string path = "",
+                 IntrospectionFormat format = INTROSPECTION_CSV,
+                 std::size_t ring_size = 10000,
+                 double period_ms = 10,
+                 std::size_t max_events = 1000);
+    ~Introspector();
+
+    /*! starts the thread polling the time series*/
     void start();
+    /*! stops the thread (after a last poll)*/
     void stop();
 
+    /*! processes the events available (called by the thread started by
+        "start", may also be called directly if not started). Returns the
+        number of events processed.*/
+    std::size_t poll();
+
+    /*! the nb_events latest events (oldest first)*/
+    std::vector<IntrospectionEvent> get_events(std::size_t nb_events) const;
+
+    /*! number of events processed since construction*/
+    long int nb_events() const;
+
+    /*! number of events skipped, either because the budget
+        of events per poll was exceeded, or because they were
+        overwritten in the time series before being polled*/
+    long int nb_dropped() const;
+
 private:
-    friend THREAD_FUNCTION_RETURN_TYPE
-    internal::run_commands_helper<ROBOT_STATE>(void *arg);
-    friend THREAD_FUNCTION_RETURN_TYPE
-    internal::run_completed_commands_helper<ROBOT_STATE>(void *arg);
-    friend THREAD_FUNCTION_RETURN_TYPE
-    internal::run_waiting_for_completion_helper<ROBOT_STATE>(void *arg);
-    friend THREAD_FUNCTION_RETURN_TYPE
-    internal::run_completion_reported_helper<ROBOT_STATE>(void *arg);
-    friend THREAD_FUNCTION_RETURN_TYPE
-    internal::run_received_helper<ROBOT_STATE>(void *arg);
-    friend THREAD_FUNCTION_RETURN_TYPE
-    internal::run_starting_helper<ROBOT_STATE>(void *arg);
     template <class T>
-    void run(std::shared_ptr<T> time_series, std::string prefix);
-    void run_commands();
-    void run_completed_commands();
-    void run_waiting_for_completion();
-    void run_completion_reported();
-    void run_received();
-    void run_starting();
+    void read(T& time_series,
+              CommandEvent event,
+              std::vector<IntrospectionEvent>& events);
+    void run();
 
 private:
-    std::mutex mutex_;
-    std::atomic<bool> running_;
-    real_time_tools::RealTimeThread commands_thread_;
-    real_time_tools::RealTimeThread completed_commands_thread_;
-    real_time_tools::RealTimeThread waiting_for_completion_thread_;
-    real_time_tools::RealTimeThread completion_reported_thread_;
-    real_time_tools::RealTimeThread received_thread_;
-    real_time_tools::RealTimeThread starting_thread_;
+    std::size_t ring_size_;
+    double period_ms_;
+    std::size_t max_events_per_series_;
+    IntrospectionFormat format_;
+    std::ofstream file_;
     std::shared_ptr<CommandsTimeSeries> commands_;
-    std::shared_ptr<CompletedCommandsTimeSeries> completed_commands_;
-    std::shared_ptr<CompletedCommandsTimeSeries> waiting_for_completion_;
-    std::shared_ptr<CompletedCommandsTimeSeries> completion_reported_;
-    std::shared_ptr<CompletedCommandsTimeSeries> received_;
-    std::shared_ptr<CompletedCommandsTimeSeries> starting_;
+    // indexed by CommandEvent, nullptr if not available
+    std::shared_ptr<CompletedCommandsTimeSeries> ids_[NB_COMMAND_EVENTS];
+    // next index to read, indexed by CommandEvent
+    time_series::Index next_[NB_COMMAND_EVENTS];
+    std::atomic<long int> nb_events_;
+    std::atomic<long int> nb_dropped_;
+    mutable std::mutex ring_mutex_;
+    std::deque<IntrospectionEvent> ring_;
+    std::atomic<bool> running_;
+    std::unique_ptr<std::thread> thread_;
 
 private:
     static std::shared_ptr<Introspector<ROBOT_STATE>> instance_;
 
 public:
-    static bool start_running(std::string segment_id);
+    /*! starts an introspector of the segment_id, if none
+        is running already (returns false otherwise)*/
+    static bool start_running(std::string segment_id,
+                              std::string path = "",
+                              IntrospectionFormat format = INTROSPECTION_CSV);
+    /*! stops the introspector started by start_running (returns false
+        if none is running)*/
     static bool stop_running();
+    /*! the latest events of the introspector started by start_running*/
+    static std::vector<IntrospectionEvent> latest_events(
+        std::size_t nb_events);
 };
 
 #include "introspector.hxx"
@@ -1,178 +1,265 @@
 
-
-namespace internal
-{
-template <class ROBOT_STATE>
-THREAD_FUNCTION_RETURN_TYPE run_commands_helper(void *arg)
-{
-    ((Introspector<ROBOT_STATE> *)arg)->run_commands();
-    return THREAD_FUNCTION_RETURN_VALUE;
-}
-template <class ROBOT_STATE>
-THREAD_FUNCTION_RETURN_TYPE run_completed_commands_helper(void *arg)
-{
-    ((Introspector<ROBOT_STATE> *)arg)->run_completed_commands();
-    return THREAD_FUNCTION_RETURN_VALUE;
-}
-template <class ROBOT_STATE>
-THREAD_FUNCTION_RETURN_TYPE run_waiting_for_completion_helper(void *arg)
-{
-    ((Introspector<ROBOT_STATE> *)arg)->run_waiting_for_completion();
-    return THREAD_FUNCTION_RETURN_VALUE;
-}
 template <class ROBOT_STATE>
-THREAD_FUNCTION_RETURN_TYPE run_completion_reported_helper(void *arg)
+Introspector<ROBOT_STATE>::Introspector(std::string segment_id,
+                                        std::string path,
+                                        IntrospectionFormat format,
+                                        std::size_t ring_size,
+                                        double period_ms,
+                                        std::size_t max_events)
+    : ring_size_(ring_size),
+      period_ms_(period_ms),
+      max_events_per_series_(std::max<std::size_t>(
+          1, max_events / static_cast<std::size_t>(NB_COMMAND_EVENTS))),
+      format_(format),
+      nb_events_(0),
+      nb_dropped_(0),
+      running_(false)
 {
-    ((Introspector<ROBOT_STATE> *)arg)->run_completion_reported();
-    return THREAD_FUNCTION_RETURN_VALUE;
+    SegmentLayout layout;
+    shared_memory::deserialize(segment_id, "layout", layout);
+
+    commands_ = CommandsTimeSeries::create_follower_ptr(segment_id +
+                                                        "_commands");
+    ids_[COMMAND_COMPLETED] =
+        CompletedCommandsTimeSeries::create_follower_ptr(segment_id +
+                                                         "_completed");
+    if (layout.has_introspection())
+    {
+        ids_[COMMAND_RECEIVED] =
+            CompletedCommandsTimeSeries::create_follower_ptr(segment_id +
+                                                             "_received");
+        ids_[COMMAND_STARTING] =
+            CompletedCommandsTimeSeries::create_follower_ptr(segment_id +
+                                                             "_starting");
+        ids_[COMMAND_WAITED_FOR] =
+            CompletedCommandsTimeSeries::create_follower_ptr(
+                segment_id + "_waiting_for_completion");
+        ids_[COMMAND_REPORTED] =
+            CompletedCommandsTimeSeries::create_follower_ptr(
+                segment_id + "_completion_reported");
+    }
+
+    // only the events occurring after construction are recorded
+    next_[COMMAND_SHARED] = commands_->newest_timeindex(false) + 1;
+    for (int event = COMMAND_RECEIVED; event < NB_COMMAND_EVENTS; event++)
+    {
+        next_[event] = 0;
+        if (ids_[event])
+        {
+            next_[event] = ids_[event]->newest_timeindex(false) + 1;
+        }
+    }
+
+    if (!path.empty())
+    {
+        file_.open(path, std::ios::out | std::ios::trunc | std::ios::binary);
+        if (!file_)
+        {
+            throw std::runtime_error("o80 introspector: failed to open " +
+                                     path);
+        }
+        if (format_ == INTROSPECTION_BINARY)
+        {
+            IntrospectionEvent::write_binary_header(file_);
+        }
+        else
+        {
+            file_ << IntrospectionEvent::csv_header() << "\n";
+        }
+        file_.flush();
+    }
 }
+
 template <class ROBOT_STATE>
-THREAD_FUNCTION_RETURN_TYPE run_received_helper(void *arg)
+Introspector<ROBOT_STATE>::~Introspector()
 {
-    ((Introspector<ROBOT_STATE> *)arg)->run_received();
-    return THREAD_FUNCTION_RETURN_VALUE;
+    stop();
 }
+
 template <class ROBOT_STATE>
-THREAD_FUNCTION_RETURN_TYPE run_starting_helper(void *arg)
+void Introspector<ROBOT_STATE>::start()
 {
-    ((Introspector<ROBOT_STATE> *)arg)->run_starting();
-    return THREAD_FUNCTION_RETURN_VALUE;
+    if (thread_)
+    {
+        return;
+    }
+    running_ = true;
+    thread_.reset(new std::thread(&Introspector<ROBOT_STATE>::run, this));
 }
 
-}  // namespace internal
-
 template <class ROBOT_STATE>
-Introspector<ROBOT_STATE>::Introspector(std::string segment_id)
-    : running_{false},
-      commands_{
-          CommandsTimeSeries::create_follower_ptr(segment_id + "_commands")},
-      completed_commands_{CompletedCommandsTimeSeries::create_follower_ptr(
-          segment_id + "_completed")},
-      waiting_for_completion_{CompletedCommandsTimeSeries::create_follower_ptr(
-          segment_id + "_waiting_for_completion")},
-      completion_reported_{CompletedCommandsTimeSeries::create_follower_ptr(
-          segment_id + "_completion_reported")},
-      received_{CompletedCommandsTimeSeries::create_follower_ptr(segment_id +
-                                                                 "_received")},
-      starting_{CompletedCommandsTimeSeries::create_follower_ptr(segment_id +
-                                                                 "_starting")}
+void Introspector<ROBOT_STATE>::stop()
 {
+    if (!thread_)
+    {
+        return;
+    }
+    running_ = false;
+    thread_->join();
+    thread_.reset();
+    poll();
 }
 
 template <class ROBOT_STATE>
-void Introspector<ROBOT_STATE>::start()
+void Introspector<ROBOT_STATE>::run()
 {
-    running_ = true;
-    commands_thread_.create_realtime_thread(
-        internal::run_commands_helper<ROBOT_STATE>, (void *)this);
-    completed_commands_thread_.create_realtime_thread(
-        internal::run_completed_commands_helper<ROBOT_STATE>, (void *)this);
-    waiting_for_completion_thread_.create_realtime_thread(
-        internal::run_waiting_for_completion_helper<ROBOT_STATE>, (void *)this);
-    completion_reported_thread_.create_realtime_thread(
-        internal::run_completion_reported_helper<ROBOT_STATE>, (void *)this);
-    received_thread_.create_realtime_thread(
-        internal::run_received_helper<ROBOT_STATE>, (void *)this);
-    starting_thread_.create_realtime_thread(
-        internal::run_starting_helper<ROBOT_STATE>, (void *)this);
+    while (running_)
+    {
+        poll();
+        std::this_thread::sleep_for(
+            std::chrono::microseconds(static_cast<long int>(period_ms_ * 1000)));
+    }
 }
 
-template <class ROBOT_STATE>
-void Introspector<ROBOT_STATE>::stop()
+template <class T>
+int introspection_command_id(const T& item)
 {
-    running_ = false;
-    commands_thread_.join();
-    completed_commands_thread_.join();
-    waiting_for_completion_thread_.join();
-    completion_reported_thread_.join();
+    if constexpr (std::is_fundamental<T>::value)
+    {
+        return item;
+    }
+    else
+    {
+        return item.get_id();
+    }
 }
 
 template <class T>
-std::string to_string(const T &element)
+int introspection_actuator(const T& item)
 {
     if constexpr (std::is_fundamental<T>::value)
     {
-        return std::to_string(element);
+        return -1;
     }
     else
     {
-        return element.to_string();
+        return item.get_dof();
     }
 }
 
 template <class ROBOT_STATE>
 template <class T>
-void Introspector<ROBOT_STATE>::run(std::shared_ptr<T> time_series,
-                                    std::string prefix)
+void Introspector<ROBOT_STATE>::read(T& time_series,
+                                     CommandEvent event,
+                                     std::vector<IntrospectionEvent>& events)
 {
-    time_series::Index index{time_series::EMPTY};
-    while (true)
+    time_series::Index newest = time_series.newest_timeindex(false);
+    time_series::Index& next = next_[event];
+    if (newest < next)
+    {
+        return;
+    }
+    // skipping the items overwritten since the last poll, and
+    // the items exceeding the budget of this poll
+    time_series::Index first = std::max(
+        time_series.oldest_timeindex(false),
+        newest - static_cast<time_series::Index>(max_events_per_series_) + 1);
+    if (first > next)
     {
-        index = time_series->newest_timeindex(false);
-        if (index != time_series::EMPTY)
+        nb_dropped_ += first - next;
+        next = first;
+    }
+    while (next <= newest)
+    {
+        try
         {
-            break;
+            auto item = time_series[next];
+            double timestamp =
+                static_cast<double>(time_series.timestamp_ms(next));
+            events.push_back(IntrospectionEvent(timestamp,
+                                                introspection_command_id(item),
+                                                event,
+                                                introspection_actuator(item)));
+            next++;
         }
-        if (!running_)
+        catch (const std::exception&)
         {
-            return;
+            // the item has been overwritten by the writer while reading:
+            // it is dropped (as well as any other item overwritten since),
+            // and reading resumes from the (new) oldest item
+            time_series::Index resume = std::max(
+                next + 1, time_series.oldest_timeindex(false));
+            nb_dropped_ += resume - next;
+            next = resume;
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
-    while (running_)
+}
+
+template <class ROBOT_STATE>
+std::size_t Introspector<ROBOT_STATE>::poll()
+{
+    std::vector<IntrospectionEvent> events;
+    read(*commands_, COMMAND_SHARED, events);
+    for (int event = COMMAND_RECEIVED; event < NB_COMMAND_EVENTS; event++)
     {
-        auto element = (*time_series)[index++];
-        std::string str = to_string(element);
+        if (ids_[event])
         {
-            std::lock_guard<std::mutex> guard(mutex_);
-            std::cout << prefix << str << std::endl;
+            read(*ids_[event], static_cast<CommandEvent>(event), events);
         }
-        while (running_)
+    }
+    if (events.empty())
+    {
+        return 0;
+    }
+
+    // merging the time series
+    std::stable_sort(events.begin(),
+                     events.end(),
+                     [](const IntrospectionEvent& a, const IntrospectionEvent& b) {
+                         return a.timestamp_ms < b.timestamp_ms;
+                     });
+
+    if (file_.is_open())
+    {
+        for (const IntrospectionEvent& event : events)
         {
-            bool received = time_series->wait_for_timeindex(index, 0.0001);
-            if (received)
+            if (format_ == INTROSPECTION_BINARY)
+            {
+                event.write_binary(file_);
+            }
+            else
             {
-                break;
+                file_ << event.to_csv() << "\n";
             }
         }
+        file_.flush();
     }
-}
-
-template <class ROBOT_STATE>
-void Introspector<ROBOT_STATE>::run_commands()
-{
-    run(commands_, std::string("~frontend~ shares: "));
-}
 
-template <class ROBOT_STATE>
-void Introspector<ROBOT_STATE>::run_completed_commands()
-{
-    run(completed_commands_,
-        "\t\t\t\t\t\t\t\t\t*backend* reports completion of: ");
-}
+    {
+        std::lock_guard<std::mutex> guard(ring_mutex_);
+        for (const IntrospectionEvent& event : events)
+        {
+            ring_.push_back(event);
+        }
+        while (ring_.size() > ring_size_)
+        {
+            ring_.pop_front();
+        }
+    }
 
-template <class ROBOT_STATE>
-void Introspector<ROBOT_STATE>::run_waiting_for_completion()
-{
-    run(waiting_for_completion_, "\t~frontend~ waiting for completion of: ");
+    nb_events_ += events.size();
+    return events.size();
 }
 
 template <class ROBOT_STATE>
-void Introspector<ROBOT_STATE>::run_completion_reported()
+std::vector<IntrospectionEvent> Introspector<ROBOT_STATE>::get_events(
+    std::size_t nb_events) const
 {
-    run(completion_reported_, "\t\t~frontend~ confirms completion of: ");
+    std::lock_guard<std::mutex> guard(ring_mutex_);
+    std::size_t nb = std::min(nb_events, ring_.size());
+    return std::vector<IntrospectionEvent>(ring_.end() - nb, ring_.end());
 }
 
 template <class ROBOT_STATE>
-void Introspector<ROBOT_STATE>::run_received()
+long int Introspector<ROBOT_STATE>::nb_events() const
 {
-    run(received_, "\t\t\t\t\t\t\t*backend* received: ");
+    return nb_events_;
 }
 
 template <class ROBOT_STATE>
-void Introspector<ROBOT_STATE>::run_starting()
+long int Introspector<ROBOT_STATE>::nb_dropped() const
 {
-    run(received_, "\t\t\t\t\t\t\t\t*backend* starting: ");
+    return nb_dropped_;
 }
 
 template <class ROBOT_STATE>
@@ -180,14 +267,16 @@ std::shared_ptr<Introspector<ROBOT_STATE>>
     Introspector<ROBOT_STATE>::instance_ = nullptr;
 
 template <class ROBOT_STATE>
-bool Introspector<ROBOT_STATE>::start_running(std::string segment_id)
+bool Introspector<ROBOT_STATE>::start_running(std::string segment_id,
+                                              std::string path,
+                                              IntrospectionFormat format)
 {
     if (Introspector<ROBOT_STATE>::instance_)
     {
         return false;
     }
     Introspector<ROBOT_STATE>::instance_ =
-        std::make_shared<Introspector<ROBOT_STATE>>(segment_id);
+        std::make_shared<Introspector<ROBOT_STATE>>(segment_id, path, format);
     Introspector<ROBOT_STATE>::instance_->start();
     return true;
 }
@@ -200,5 +289,17 @@ bool Introspector<ROBOT_STATE>::stop_running()
         return false;
     }
     Introspector<ROBOT_STATE>::instance_->stop();
+    Introspector<ROBOT_STATE>::instance_.reset();
     return true;
 }
+
+template <class ROBOT_STATE>
+std::vector<IntrospectionEvent> Introspector<ROBOT_STATE>::latest_events(
+    std::size_t nb_events)
+{
+    if (!Introspector<ROBOT_STATE>::instance_)
+    {
+        return std::vector<IntrospectionEvent>();
+    }
+    return Introspector<ROBOT_STATE>::instance_->get_events(nb_events);
+}
@@ -8,10 +8,12 @@ namespace o80
 {
 /*! clear all the shared memory segments corresponding to
  *  the specified segment id. The destructor of BackEnd calls
- *  this function, but user code may call it in case a program
- *  has been abruptly terminated (i.e. the BackEnd 's destructor has not
- *  been called). Starting a BackEnd using a segment id that
- *  has not been properly cleared will result in the program hanging.
+ *  this function. Calling it from user code is usually not required:
+ *  when a program has been abruptly terminated (i.e. the BackEnd 's
+ *  destructor has not been called), the next BackEnd of the same
+ *  segment id detects the previous owner is dead and clears
+ *  the segment. Frontends attached to the cleared segment reattach
+ *  to the next backend.
  */
   void clear_shared_memory(std::string segment_id);
 }  // namespace o80
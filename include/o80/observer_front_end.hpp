@@ -0,0 +1,239 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "observation.hpp"
+#include "readiness.hpp"
+#include "segment_layout.hpp"
+#include "states.hpp"
+#include "time.hpp"
+#include "tracer.hpp"
+#include "transport.hpp"
+#include "o80_internal/observation_interpolation.hpp"
+#include "o80_internal/readiness.hpp"
+#include "o80_internal/segment_status.hpp"
+
+namespace o80
+{
+/*! A read only frontend: reads the observations written by a backend,
+ *  but does not send commands. It attaches only to the observations and
+ *  to the control data of the backend (the commands and completed
+ *  commands time series are not attached to, and no command buffer is
+ *  allocated), so it is cheap to construct, e.g. for monitoring.
+ *  Several instances may run concurrently with the FrontEnd sending
+ *  commands.
+ * @tparam NB_ACTUATORS number of actuators of the robot
+ * @tparam ROBOT_STATE class encapsulating the state of an
+ *                     actuator of the robot
+ * @tparam EXTENDED_STATE class encapsulating
+ *                        supplementary arbitrary information
+ */
+template <int NB_ACTUATORS, class ROBOT_STATE, class EXTENDED_STATE>
+class ObserverFrontEnd
+{
+public:
+    /*! channels shared with the backend*/
+    typedef Transport<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>
+        FrontendTransport;
+    /*! time series hosting the observations writen by the backend*/
+    typedef typename FrontendTransport::ObservationsTimeSeries
+        ObservationsTimeSeries;
+    /*! vector of observations*/
+    typedef std::vector<Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>>
+        Observations;
+
+public:
+    /**
+     * @param segment_id should be the same for the
+     *        backend and the frontend
+     * @param transport (default shared memory) should be the
+     *        same as the one used by the backend. IN_PROCESS
+     *        requires the backend to run in the same process.
+     */
+    ObserverFrontEnd(std::string segment_id,
+                     TransportType transport = SHARED_MEMORY);
+
+    virtual ~ObserverFrontEnd();
+
+    /*! If the backend stopped, or has been replaced by a new backend
+     *  (e.g. a standalone restarted after a crash), attaches to the new
+     *  backend and returns true. Returns false otherwise. Throws a
+     *  runtime_error if the backend stopped and no new backend is
+     *  running. Called by the methods reading observations, so calling
+     *  it explicitly is usually not required.
+     */
+    virtual bool reattach();
+
+    /*! Returns the capacities of the time series of the segment,
+        as set by the backend*/
+    const SegmentLayout& get_layout() const;
+
+    /*! Returns the frequency at which the backend is set to run.
+      This will return a value only if the backend has been instantiated
+      by a standalone. Otherwise, throws a runtime_error
+    */
+    float get_frequency() const;
+
+    /*!returns the number of actuators*/
+    int get_nb_actuators() const;
+
+    /*! Read from the shared memory all the observations
+        starting from the specified iteration until the newest
+        iteration and update the observations vector with them.
+     *  @param[in] iteration: iteration number of the backend
+     *  @param[out] push_back_to: vector of observations to be updated.
+     */
+    bool observations_since(time_series::Index iteration,
+                            Observations& push_back_to);
+
+    /*! Read from the shared memory
+        the latest nb_items observations
+        update the observations vector with them.
+     *  @param[in] iteration: iteration number of the backend
+     *  @param[out] push_back_to: vector of observations to be updated.
+     */
+    bool update_latest_observations(size_t nb_items,
+                                    Observations& push_back_to);
+
+    /*! Returns a vector of observations containing all observations
+     *  starting from the specified iteration until the latest iteration
+     *  @param iteration: iteration number
+     */
+    Observations get_observations_since(time_series::Index iteration);
+
+    /*! Returns a vector of observations containing the nb_items
+     *  latest  observations.
+     *  @param iteration: number of observations to read
+     */
+    Observations get_latest_observations(size_t nb_items);
+
+    /*! waiting for the next observation to be writen by the backend, then
+     *  returning it. During the first call to this method, the current
+     *  iteration is initialized as reference iteration, then the reference
+     *  iteration will be increase by one at each call*/
+    Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE> wait_for_next();
+
+    /*! if returns true: during its latest iteration, the backend did not
+     * reapply the previous desired states (i.e. at least one command was
+     * active), if false, the backend reapplied the previous desired state (no
+     * active command)
+     */
+    bool backend_is_active();
+
+    /*! reset the reference iteration used by the "wait_for_next" method
+     *  to the current iteration number*/
+    void reset_next_index();
+
+    /*! returns the observation of the specified iteration, or the
+     *  latest observation if iteration is negative. Throws a range_error
+     *  if the observation is not available anymore.
+     */
+    Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE> read(
+        long int iteration = -1);
+
+    /*! returns the index (as can be passed to the read method) of the
+     *  latest observation, or -1 if no observation has been written yet
+     */
+    long int newest_index();
+
+    /*! returns the index (as can be passed to the read method) of the
+     *  oldest observation still available, or -1 if no observation has
+     *  been written yet
+     */
+    long int oldest_index();
+
+    /*! returns the observation at the time stamp time (see
+     *  Observation::get_time_stamp). The two observations bracketing time
+     *  are found by binary search over the observations, and the observed
+     *  and desired states are linearly interpolated between them (using
+     *  the intermediate_state method of ROBOT_STATE for duration commands,
+     *  i.e. with a precision of a microsecond). The other attributes
+     *  are the ones of the older observation. Throws a range_error if
+     *  time is not between the time stamps of the oldest and of the latest
+     *  observations available.
+     */
+    Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE> read_at_time(
+        const TimePoint& time);
+
+    /*! same as read_at_time, for each of the time stamps*/
+    Observations read_at_times(const std::vector<TimePoint>& times);
+
+    /*! Requests the backend to notify the events (bitwise or of
+     *  ReadinessEvent) to this frontend, and returns a file descriptor
+     *  which becomes readable when any of these events occurred since
+     *  the latest call to clear_readiness, e.g. to be waited on with poll
+     *  or epoll (or asyncio's add_reader), so that a single thread may
+     *  wait for several backends. Notifications may be spurious. The
+     *  file descriptor remains valid (and the requested events notified)
+     *  until disable_readiness is called or this frontend is destroyed,
+     *  including after reattaching to a new backend. Throws a runtime_error
+     *  if the backend status could not be attached to.
+     */
+    int enable_readiness(int events = READY_OBSERVATION);
+
+    /*! stops the notifications and closes the file descriptor
+        returned by enable_readiness*/
+    void disable_readiness();
+
+    /*! returns the file descriptor returned by enable_readiness,
+        or -1 if notifications are not enabled*/
+    int get_readiness_fd() const;
+
+    /*! to be called once the file descriptor is readable: reads the
+        pending notifications and returns the events which occurred
+        (bitwise or of ReadinessEvent), 0 if none*/
+    int clear_readiness();
+
+    /*!
+     * returns the first states ever observed by the backend
+     */
+    States<NB_ACTUATORS, ROBOT_STATE> initial_states() const;
+
+protected:
+    std::string segment_id_;
+    TransportType transport_type_;
+
+    // channels shared with the backend (shared memory or in process)
+    std::shared_ptr<FrontendTransport> transport_;
+
+    // backend will write observation into it
+    ObservationsTimeSeries* observations_;
+    time_series::Index observations_index_;
+
+    // segment id as written in the records of Tracer
+    std::uint32_t trace_segment_;
+
+private:
+    // reads the observation at index, returns false if it
+    // is not available anymore
+    bool read_index(
+        time_series::Index index,
+        Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>& observation);
+    // binary search of the observations bracketing stamp, returns false
+    // if an observation has been overwritten during the search. Throws
+    // a range_error if stamp is not in the range of the observations.
+    bool search(long int stamp,
+                Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>& before,
+                Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>& after);
+    Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE> at_time(
+        long int stamp);
+
+    // registers this frontend in the status of the backend
+    // (for the sake of o80_top). Failures are ignored.
+    void attach_status();
+    void detach_status();
+
+    std::unique_ptr<internal::SegmentStatus> status_;
+    int status_slot_;
+
+    // see enable_readiness (nullptr if not enabled)
+    std::unique_ptr<internal::ReadinessListener> readiness_;
+    int readiness_events_;
+};
+
+#include "observer_front_end.hxx"
+}  // namespace o80
@@ -0,0 +1,450 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#define TEMPLATE_OBSERVER \
+    template <int NB_ACTUATORS, class ROBOT_STATE, class EXTENDED_STATE>
+
+#define OBSERVER ObserverFrontEnd<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>
+
+TEMPLATE_OBSERVER
+OBSERVER::ObserverFrontEnd(std::string segment_id, TransportType transport)
+    : segment_id_(segment_id),
+      transport_type_(transport),
+      transport_{FrontendTransport::create(
+          segment_id, transport, false, SegmentLayout())},
+      observations_(&transport_->observations()),
+      trace_segment_(Tracer::register_segment(segment_id)),
+      status_slot_(-1),
+      readiness_events_(0)
+{
+    observations_index_ = observations_->newest_timeindex(false);
+    attach_status();
+}
+
+TEMPLATE_OBSERVER
+OBSERVER::~ObserverFrontEnd()
+{
+    detach_status();
+}
+
+TEMPLATE_OBSERVER
+void OBSERVER::attach_status()
+{
+    try
+    {
+        status_.reset(new internal::SegmentStatus(segment_id_, false));
+        status_slot_ = status_->attach_frontend();
+        // e.g. reattaching to a new backend
+        if (readiness_ && status_slot_ >= 0)
+        {
+            status_->set_readiness(
+                status_slot_, readiness_->get_id(), readiness_events_);
+        }
+    }
+    catch (const std::runtime_error&)
+    {
+        status_.reset();
+        status_slot_ = -1;
+    }
+}
+
+TEMPLATE_OBSERVER
+void OBSERVER::detach_status()
+{
+    if (status_)
+    {
+        status_->detach_frontend(status_slot_);
+    }
+    status_.reset();
+    status_slot_ = -1;
+}
+
+TEMPLATE_OBSERVER
+bool OBSERVER::reattach()
+{
+    if (!transport_->is_retired())
+    {
+        return false;
+    }
+    transport_ = FrontendTransport::create(
+        segment_id_, transport_type_, false, SegmentLayout());
+    observations_ = &transport_->observations();
+    observations_index_ = observations_->newest_timeindex(false);
+    detach_status();
+    attach_status();
+    return true;
+}
+
+TEMPLATE_OBSERVER
+const SegmentLayout& OBSERVER::get_layout() const
+{
+    return transport_->get_layout();
+}
+
+TEMPLATE_OBSERVER
+float OBSERVER::get_frequency() const
+{
+    float value;
+    try
+    {
+        shared_memory::get<float>(segment_id_, "frequency", value);
+    }
+    catch (const shared_memory::Allocation_exception& e)
+    {
+        std::string error =
+            std::string("failed to read the frequency of o80 backend ") +
+            segment_id_ +
+            std::string(
+                ": only backend instantiated via a standalone provide "
+                "their frequency.");
+        throw std::runtime_error(error);
+    }
+    return value;
+}
+
+TEMPLATE_OBSERVER
+int OBSERVER::get_nb_actuators() const
+{
+    return NB_ACTUATORS;
+}
+
+TEMPLATE_OBSERVER
+Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE> OBSERVER::wait_for_next()
+{
+    reattach();
+    Tracer::trace(trace_segment_, FRONTEND_WAIT_START);
+    observations_index_ += 1;
+    time_series::Index newest = observations_->newest_timeindex(false);
+    while (newest < observations_index_)
+    {
+        usleep(10);
+        if (reattach())
+        {
+            observations_index_ += 1;
+        }
+        newest = observations_->newest_timeindex(false);
+    }
+    Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE> obs =
+        (*observations_)[observations_index_];
+    Tracer::trace(trace_segment_, FRONTEND_WAIT_END);
+    return obs;
+}
+
+TEMPLATE_OBSERVER
+void OBSERVER::reset_next_index()
+{
+    reattach();
+    observations_index_ = observations_->newest_timeindex(false);
+}
+
+TEMPLATE_OBSERVER
+bool OBSERVER::observations_since(
+    time_series::Index time_index,
+    std::vector<Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>>& v)
+{
+    reattach();
+    time_series::Index oldest = observations_->oldest_timeindex();
+    time_series::Index newest = observations_->newest_timeindex();
+    if (time_index > newest || time_index < oldest)
+    {
+        return false;
+    }
+    for (time_series::Index index = time_index; index <= newest; index++)
+    {
+        v.push_back((*observations_)[index]);
+    }
+    return true;
+}
+
+TEMPLATE_OBSERVER
+std::vector<Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>>
+OBSERVER::get_observations_since(time_series::Index time_index)
+{
+    std::vector<Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>> v;
+    observations_since(time_index, v);
+    return v;
+}
+
+TEMPLATE_OBSERVER
+bool OBSERVER::update_latest_observations(
+    size_t nb_items,
+    std::vector<Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>>& v)
+{
+    reattach();
+    bool r = true;
+    time_series::Index oldest = observations_->oldest_timeindex();
+    time_series::Index newest = observations_->newest_timeindex();
+    time_series::Index target = newest - nb_items + 1;
+    if (target < oldest)
+    {
+        target = oldest;
+        r = false;
+    }
+    for (time_series::Index index = target; index <= newest; index++)
+    {
+        v.push_back((*observations_)[index]);
+    }
+    return r;
+}
+
+TEMPLATE_OBSERVER
+std::vector<Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>>
+OBSERVER::get_latest_observations(size_t nb_items)
+{
+    std::vector<Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>> v;
+    update_latest_observations(nb_items, v);
+    return v;
+}
+
+TEMPLATE_OBSERVER
+bool OBSERVER::backend_is_active()
+{
+    reattach();
+    return transport_->get_active();
+}
+
+TEMPLATE_OBSERVER
+Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE> OBSERVER::read(
+    long int iteration)
+{
+    reattach();
+    Tracer::trace(trace_segment_, FRONTEND_READ);
+    // no observation yet, throwing error
+    if (observations_->is_empty())
+    {
+        return Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>();
+    }
+
+    // current observation
+    if (iteration < 0)
+    {
+        return observations_->newest_element();
+    }
+
+    // past observations
+    time_series::Index oldest = observations_->oldest_timeindex();
+    if (iteration < oldest)
+    {
+        std::string error = "o80 frontend read: can not return iteration ";
+        error += std::to_string(iteration);
+        error += "(oldest iteration available: " + std::to_string(oldest) + ")";
+        throw std::range_error(error);
+    }
+
+    return (*observations_)[iteration];
+}
+
+TEMPLATE_OBSERVER
+long int OBSERVER::newest_index()
+{
+    reattach();
+    if (observations_->is_empty())
+    {
+        return -1;
+    }
+    return observations_->newest_timeindex(false);
+}
+
+TEMPLATE_OBSERVER
+long int OBSERVER::oldest_index()
+{
+    reattach();
+    if (observations_->is_empty())
+    {
+        return -1;
+    }
+    return observations_->oldest_timeindex(false);
+}
+
+TEMPLATE_OBSERVER
+bool OBSERVER::read_index(
+    time_series::Index index,
+    Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>& observation)
+{
+    try
+    {
+        observation = (*observations_)[index];
+        return true;
+    }
+    catch (const std::logic_error&)
+    {
+        // overwritten by the backend (multiprocess time series and
+        // region time series throw an invalid_argument)
+        return false;
+    }
+}
+
+TEMPLATE_OBSERVER
+bool OBSERVER::search(
+    long int stamp,
+    Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>& before,
+    Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>& after)
+{
+    // the time stamps of the observations are monotonic: binary search
+    // for low and high, the indexes of the observations bracketing stamp
+    time_series::Index low = observations_->oldest_timeindex(false);
+    time_series::Index high = observations_->newest_timeindex(false);
+    if (!read_index(low, before) || !read_index(high, after))
+    {
+        return false;
+    }
+    if (stamp < before.get_time_stamp() || stamp > after.get_time_stamp())
+    {
+        std::string error = "o80 frontend read_at_time: time stamp ";
+        error += std::to_string(stamp);
+        error += " is not in the range of the observations available (";
+        error += std::to_string(before.get_time_stamp()) + " to ";
+        error += std::to_string(after.get_time_stamp()) + ")";
+        throw std::range_error(error);
+    }
+    Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE> observation;
+    while (high - low > 1)
+    {
+        time_series::Index middle = low + (high - low) / 2;
+        if (!read_index(middle, observation))
+        {
+            return false;
+        }
+        if (observation.get_time_stamp() <= stamp)
+        {
+            low = middle;
+            before = observation;
+        }
+        else
+        {
+            high = middle;
+            after = observation;
+        }
+    }
+    return true;
+}
+
+TEMPLATE_OBSERVER
+Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE> OBSERVER::at_time(
+    long int stamp)
+{
+    if (observations_->is_empty())
+    {
+        throw std::range_error("o80 frontend read_at_time: no observation");
+    }
+
+    // the backend may overwrite the oldest observations during the
+    // search, which then restarts over the observations still available
+    static constexpr int max_attempts = 3;
+    Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE> before;
+    Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE> after;
+    bool found = false;
+    for (int attempt = 0; attempt < max_attempts && !found; attempt++)
+    {
+        found = search(stamp, before, after);
+    }
+    if (!found)
+    {
+        std::string error = "o80 frontend read_at_time: time stamp ";
+        error += std::to_string(stamp);
+        error += " is about the oldest observation available, which ";
+        error += "kept being overwritten during the search";
+        throw std::range_error(error);
+    }
+    if (before.get_time_stamp() == stamp)
+    {
+        return before;
+    }
+    if (after.get_time_stamp() == stamp)
+    {
+        return after;
+    }
+
+    return internal::interpolate_observation(before, after, stamp);
+}
+
+TEMPLATE_OBSERVER
+Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE> OBSERVER::read_at_time(
+    const TimePoint& time)
+{
+    reattach();
+    Tracer::trace(trace_segment_, FRONTEND_READ);
+    return at_time(time.count());
+}
+
+TEMPLATE_OBSERVER
+std::vector<Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>>
+OBSERVER::read_at_times(const std::vector<TimePoint>& times)
+{
+    reattach();
+    Tracer::trace(trace_segment_, FRONTEND_READ);
+    std::vector<Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>> v;
+    v.reserve(times.size());
+    for (const TimePoint& time : times)
+    {
+        v.push_back(at_time(time.count()));
+    }
+    return v;
+}
+
+TEMPLATE_OBSERVER
+int OBSERVER::enable_readiness(int events)
+{
+    reattach();
+    if (!status_ || status_slot_ < 0)
+    {
+        throw std::runtime_error(
+            std::string("o80 frontend: failed to attach to the status of ") +
+            segment_id_ +
+            std::string(", readiness notifications can not be enabled"));
+    }
+    if (!readiness_)
+    {
+        readiness_.reset(new internal::ReadinessListener());
+    }
+    readiness_events_ = events;
+    status_->set_readiness(status_slot_, readiness_->get_id(), events);
+    return readiness_->get_fd();
+}
+
+TEMPLATE_OBSERVER
+void OBSERVER::disable_readiness()
+{
+    if (status_ && readiness_)
+    {
+        status_->set_readiness(status_slot_, readiness_->get_id(), 0);
+    }
+    readiness_.reset();
+    readiness_events_ = 0;
+}
+
+TEMPLATE_OBSERVER
+int OBSERVER::get_readiness_fd() const
+{
+    if (!readiness_)
+    {
+        return -1;
+    }
+    return readiness_->get_fd();
+}
+
+TEMPLATE_OBSERVER
+int OBSERVER::clear_readiness()
+{
+    if (!readiness_)
+    {
+        return 0;
+    }
+    // emptying the pipe before clearing the pending events, so that
+    // an event notified in between is not lost (but may be reported
+    // twice)
+    int events = readiness_->clear();
+    if (status_)
+    {
+        events |= status_->clear_readiness(status_slot_);
+    }
+    return events;
+}
+
+TEMPLATE_OBSERVER
+States<NB_ACTUATORS, ROBOT_STATE> OBSERVER::initial_states() const
+{
+    States<NB_ACTUATORS, ROBOT_STATE> r;
+    transport_->get_initial_states(r);
+    return r;
+}
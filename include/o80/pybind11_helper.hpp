@@ -6,12 +6,19 @@
 #include <o80/burster.hpp>
 #include <o80/command_types.hpp>
 #include <o80/front_end.hpp>
+#include <o80/front_end_group.hpp>
 #include <o80/introspector.hpp>
 #include <o80/mode.hpp>
 #include <o80/observation.hpp>
+#include <o80/observer_front_end.hpp>
+#include <o80/segment_join.hpp>
 #include <o80/standalone.hpp>
+#include <o80/standalone_group.hpp>
+#include <o80/state.hpp>
+#include <o80/statend.hpp>
 #include <o80/states.hpp>
 
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/stl_bind.h>
@@ -61,5 +68,19 @@ template <class RobotDriver, class RobotStandalone, typename... DriverArgs>
 void create_standalone_python_bindings(pybind11::module &m,
                                        std::string prefix = std::string(""));
 
+/**
+ * ! Creates the python bindings of the class SegmentJoin (named name)
+ *   and of its samples (named name+"Sample"), e.g.
+ *   \code{.cpp}
+ *   create_segment_join_python_bindings<
+ *       SegmentJoin<RobotObserver, BallObserver>>(m, "RobotBallJoin");
+ *   \endcode
+ *   The python bindings of the observations of each segment
+ *   are expected to be created separately (see create_python_bindings).
+ */
+template <class Join>
+void create_segment_join_python_bindings(pybind11::module &m,
+                                         std::string name);
+
 #include "pybind11_helper.hxx"
 }  // namespace o80
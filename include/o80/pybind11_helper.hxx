@@ -10,6 +10,122 @@ constexpr bool has_type()
     return std::disjunction<std::is_same<T, Ts>...>::value;
 }
 
+// for the bindings of methods which may block (waiting for the backend,
+// for a burst ...) or copy data out of the shared memory: the GIL is
+// released while they run, so that other python threads (e.g. frontends
+// of other segments) may run concurrently
+typedef pybind11::call_guard<pybind11::gil_scoped_release> release_gil;
+
+// 1d arrays, converted if required (e.g. from lists)
+typedef pybind11::array_t<int,
+                          pybind11::array::c_style | pybind11::array::forcecast>
+    int_array;
+typedef pybind11::array_t<long int,
+                          pybind11::array::c_style | pybind11::array::forcecast>
+    long_array;
+typedef pybind11::array_t<double,
+                          pybind11::array::c_style | pybind11::array::forcecast>
+    double_array;
+
+// one instance of T constructed from each value of the 1d array
+template <typename T, typename V, int FLAGS>
+std::vector<T> to_vector(const pybind11::array_t<V, FLAGS>& array)
+{
+    if (array.ndim() != 1)
+    {
+        throw std::runtime_error("o80: expected a one dimensional array");
+    }
+    auto a = array.template unchecked<1>();
+    std::vector<T> v;
+    v.reserve(a.shape(0));
+    for (pybind11::ssize_t index = 0; index < a.shape(0); index++)
+    {
+        v.push_back(T(a(index)));
+    }
+    return v;
+}
+
+// time stamps (nanoseconds, see Observation::get_time_stamp)
+inline std::vector<TimePoint> time_points(const std::vector<long int>& stamps)
+{
+    std::vector<TimePoint> v;
+    v.reserve(stamps.size());
+    for (long int stamp : stamps)
+    {
+        v.push_back(TimePoint(stamp));
+    }
+    return v;
+}
+
+// numpy_state<STATE>::supported is true if the memory of an instance
+// of STATE starts with dim contiguous doubles, in which case the memory
+// of States (an array of STATE) may be viewed as a [NB_ACTUATORS, dim]
+// array of doubles (one row every sizeof(STATE) bytes), without copy
+template <class STATE, class Enable = void>
+struct numpy_state
+{
+    static constexpr bool supported = false;
+};
+
+// e.g. State1d
+template <class STATE>
+struct numpy_state<
+    STATE,
+    std::enable_if_t<std::is_base_of<State<double, STATE>, STATE>::value>>
+{
+    static constexpr bool supported =
+        std::is_standard_layout<STATE>::value &&
+        sizeof(STATE) == sizeof(double);
+    static constexpr int dim = 1;
+    static const double* data(const STATE& state)
+    {
+        return &state.value;
+    }
+};
+
+template <int N>
+struct numpy_state<StateNd<double, N>>
+{
+    static constexpr bool supported = true;
+    static constexpr int dim = N;
+    static const double* data(const StateNd<double, N>& state)
+    {
+        return state.values.data();
+    }
+};
+
+template <int NB_ACTUATORS, class STATE>
+pybind11::buffer_info states_buffer(States<NB_ACTUATORS, STATE>& states)
+{
+    return pybind11::buffer_info(
+        const_cast<double*>(numpy_state<STATE>::data(states.values[0])),
+        sizeof(double),
+        pybind11::format_descriptor<double>::format(),
+        2,
+        {static_cast<pybind11::ssize_t>(NB_ACTUATORS),
+         static_cast<pybind11::ssize_t>(numpy_state<STATE>::dim)},
+        {static_cast<pybind11::ssize_t>(sizeof(STATE)),
+         static_cast<pybind11::ssize_t>(sizeof(double))});
+}
+
+// read only [NB_ACTUATORS, dim] view on states, which keeps base
+// (the python object owning states) alive
+template <int NB_ACTUATORS, class STATE>
+pybind11::array_t<double> states_view(
+    const States<NB_ACTUATORS, STATE>& states, pybind11::handle base)
+{
+    pybind11::array_t<double> view(
+        {static_cast<pybind11::ssize_t>(NB_ACTUATORS),
+         static_cast<pybind11::ssize_t>(numpy_state<STATE>::dim)},
+        {static_cast<pybind11::ssize_t>(sizeof(STATE)),
+         static_cast<pybind11::ssize_t>(sizeof(double))},
+        numpy_state<STATE>::data(states.values[0]),
+        base);
+    pybind11::detail::array_proxy(view.ptr())->flags &=
+        ~pybind11::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+    return view;
+}
+
 }  // namespace internal
 
 template <int QUEUE_SIZE,
@@ -24,11 +140,18 @@ void create_python_bindings(pybind11::module& m, std::string prefix)
     if constexpr (!internal::has_type<NO_STATES, EXCLUDED_CLASSES...>())
     {
         typedef States<NB_ACTUATORS, o80_STATE> states;
-        pybind11::class_<states>(m, (prefix + "States").c_str())
-            .def(pybind11::init<>())
+        pybind11::class_<states> s(
+            m, (prefix + "States").c_str(), pybind11::buffer_protocol());
+        s.def(pybind11::init<>())
             .def("set", &states::set)
             .def("get", &states::get)
             .def_readwrite("values", &states::values);
+        if constexpr (internal::numpy_state<o80_STATE>::supported)
+        {
+            // numpy.asarray(states): [NB_ACTUATORS, dim] view, no copy
+            s.def_buffer(
+                [](states& st) { return internal::states_buffer(st); });
+        }
     }
     if constexpr (!internal::has_type<NO_STATE, EXCLUDED_CLASSES...>())
     {
@@ -50,8 +173,9 @@ void create_python_bindings(pybind11::module& m, std::string prefix)
     {
         typedef Observation<NB_ACTUATORS, o80_STATE, o80_EXTENDED_STATE>
             observation;
-        pybind11::class_<observation>(m, (prefix + "Observation").c_str())
-            .def(pybind11::init<>())
+        pybind11::class_<observation> obs(m,
+                                          (prefix + "Observation").c_str());
+        obs.def(pybind11::init<>())
             .def("get_observed_states", &observation::get_observed_states)
             .def("get_desired_states", &observation::get_desired_states)
             .def("get_extended_state", &observation::get_extended_state)
@@ -59,6 +183,24 @@ void create_python_bindings(pybind11::module& m, std::string prefix)
             .def("get_frequency", &observation::get_frequency)
             .def("get_time_stamp", &observation::get_time_stamp)
             .def("__str__", &observation::to_string);
+        if constexpr (internal::numpy_state<o80_STATE>::supported)
+        {
+            // read only [NB_ACTUATORS, dim] numpy views on the observed and
+            // desired states (no copy, no python State instance created)
+            obs.def("get_observed_states_array",
+                    [](pybind11::object self) {
+                        const observation& o = self.cast<const observation&>();
+                        return internal::states_view(o.get_observed_states(),
+                                                     self);
+                    })
+                .def("get_desired_states_array",
+                     [](pybind11::object self) {
+                         const observation& o =
+                             self.cast<const observation&>();
+                         return internal::states_view(o.get_desired_states(),
+                                                      self);
+                     });
+        }
     }
 
     if constexpr (!internal::has_type<NO_SERIALIZER, EXCLUDED_CLASSES...>())
@@ -85,15 +227,24 @@ void create_python_bindings(pybind11::module& m, std::string prefix)
                          o80_STATE,
                          o80_EXTENDED_STATE>
             frontend;
-        pybind11::class_<frontend>(m, (prefix + "FrontEnd").c_str())
-            .def(pybind11::init<std::string>())
+        pybind11::class_<frontend> fe(m, (prefix + "FrontEnd").c_str());
+        fe.def(pybind11::init<std::string>())
+            .def(pybind11::init<std::string, TransportType>())
+            .def("get_layout", &frontend::get_layout)
             .def("get_frequency", &frontend::get_frequency)
             .def("get_nb_actuators", &frontend::get_nb_actuators)
-            .def("get_observations_since", &frontend::get_observations_since)
-            .def("get_latest_observations", &frontend::get_latest_observations)
-            .def("wait_for_next", &frontend::wait_for_next)
+            .def("get_observations_since",
+                 &frontend::get_observations_since,
+                 internal::release_gil())
+            .def("get_latest_observations",
+                 &frontend::get_latest_observations,
+                 internal::release_gil())
+            .def("wait_for_next",
+                 &frontend::wait_for_next,
+                 internal::release_gil())
             .def("reset_next_index", &frontend::reset_next_index)
             .def("is_backend_active", &frontend::backend_is_active)
+            .def("reattach", &frontend::reattach, internal::release_gil())
             .def("purge", &frontend::purge)
             .def("add_command",
                  (void (frontend::*)(int, o80_STATE, Iteration, Mode)) &
@@ -107,63 +258,315 @@ void create_python_bindings(pybind11::module& m, std::string prefix)
             .def("add_command",
                  (void (frontend::*)(int, o80_STATE, Speed, Mode)) &
                      frontend::add_command)
+            .def("add_commands",
+                 (void (frontend::*)(const std::vector<int>&,
+                                     const std::vector<o80_STATE>&,
+                                     const std::vector<Duration_us>&,
+                                     Mode)) &
+                     frontend::add_commands,
+                 internal::release_gil())
+            .def("add_commands",
+                 (void (frontend::*)(const std::vector<int>&,
+                                     const std::vector<o80_STATE>&,
+                                     const std::vector<Iteration>&,
+                                     Mode)) &
+                     frontend::add_commands,
+                 internal::release_gil())
             .def("add_reinit_command", &frontend::add_reinit_command)
-            .def("burst", &frontend::burst)
-            .def("final_burst", &frontend::final_burst)
-            .def("pulse_and_wait", &frontend::pulse_and_wait)
-            .def("pulse_prepare_wait", &frontend::pulse_prepare_wait)
-            .def("wait", &frontend::wait)
-            .def("read", &frontend::read)
-            .def("latest", [](frontend& fe) { return fe.read(-1); })
+            .def("burst", &frontend::burst, internal::release_gil())
+            .def("final_burst",
+                 &frontend::final_burst,
+                 internal::release_gil())
+            .def("pulse_and_wait",
+                 &frontend::pulse_and_wait,
+                 internal::release_gil())
+            .def("pulse_prepare_wait",
+                 &frontend::pulse_prepare_wait,
+                 internal::release_gil())
+            .def("wait", &frontend::wait, internal::release_gil())
+            .def("read", &frontend::read, internal::release_gil())
+            .def(
+                "latest",
+                [](frontend& fe) { return fe.read(-1); },
+                internal::release_gil())
+            .def("enable_readiness",
+                 &frontend::enable_readiness,
+                 pybind11::arg("events") =
+                     static_cast<int>(READY_OBSERVATION))
+            .def("disable_readiness", &frontend::disable_readiness)
+            .def("get_readiness_fd", &frontend::get_readiness_fd)
+            .def("clear_readiness", &frontend::clear_readiness)
+            .def(
+                "read_at_time",
+                [](frontend& fe, long int stamp) {
+                    return fe.read_at_time(TimePoint(stamp));
+                },
+                internal::release_gil())
+            .def(
+                "read_at_times",
+                [](frontend& fe, const std::vector<long int>& stamps) {
+                    return fe.read_at_times(internal::time_points(stamps));
+                },
+                internal::release_gil())
+            .def("pulse",
+                 (observation(frontend::*)(Iteration)) & frontend::pulse,
+                 internal::release_gil())
             .def("pulse",
-                 (observation(frontend::*)(Iteration)) & frontend::pulse)
-            .def("pulse", (observation(frontend::*)()) & frontend::pulse)
-            .def("initial_states", &frontend::initial_states);
+                 (observation(frontend::*)()) & frontend::pulse,
+                 internal::release_gil())
+            .def("initial_states",
+                 &frontend::initial_states,
+                 internal::release_gil());
+        if constexpr (std::is_constructible<o80_STATE, double>::value)
+        {
+            // commands from 1d arrays (one command per index): the
+            // commands are built in a single call rather than one python
+            // call per command
+            fe.def(
+                "add_commands",
+                [](frontend& f,
+                   internal::int_array dofs,
+                   internal::double_array values,
+                   internal::long_array durations_us,
+                   Mode mode) {
+                    std::vector<int> d = internal::to_vector<int>(dofs);
+                    std::vector<o80_STATE> v =
+                        internal::to_vector<o80_STATE>(values);
+                    std::vector<Duration_us> t =
+                        internal::to_vector<Duration_us>(durations_us);
+                    pybind11::gil_scoped_release release;
+                    f.add_commands(d, v, t, mode);
+                });
+            fe.def(
+                "add_iteration_commands",
+                [](frontend& f,
+                   internal::int_array dofs,
+                   internal::double_array values,
+                   internal::long_array iterations,
+                   Mode mode,
+                   bool relative) {
+                    std::vector<int> d = internal::to_vector<int>(dofs);
+                    std::vector<o80_STATE> v =
+                        internal::to_vector<o80_STATE>(values);
+                    std::vector<long int> i =
+                        internal::to_vector<long int>(iterations);
+                    std::vector<Iteration> t;
+                    t.reserve(i.size());
+                    for (long int iteration : i)
+                    {
+                        t.push_back(Iteration(iteration, relative));
+                    }
+                    pybind11::gil_scoped_release release;
+                    f.add_commands(d, v, t, mode);
+                },
+                pybind11::arg("dofs"),
+                pybind11::arg("values"),
+                pybind11::arg("iterations"),
+                pybind11::arg("mode"),
+                pybind11::arg("relative") = false);
+        }
+    }
+
+    if constexpr (!internal::has_type<NO_FRONTEND, EXCLUDED_CLASSES...>())
+    {
+        typedef ObserverFrontEnd<NB_ACTUATORS, o80_STATE, o80_EXTENDED_STATE>
+            observer;
+        pybind11::class_<observer>(m, (prefix + "ObserverFrontEnd").c_str())
+            .def(pybind11::init<std::string>())
+            .def(pybind11::init<std::string, TransportType>())
+            .def("get_layout", &observer::get_layout)
+            .def("get_frequency", &observer::get_frequency)
+            .def("get_nb_actuators", &observer::get_nb_actuators)
+            .def("get_observations_since",
+                 &observer::get_observations_since,
+                 internal::release_gil())
+            .def("get_latest_observations",
+                 &observer::get_latest_observations,
+                 internal::release_gil())
+            .def("wait_for_next",
+                 &observer::wait_for_next,
+                 internal::release_gil())
+            .def("reset_next_index", &observer::reset_next_index)
+            .def("is_backend_active", &observer::backend_is_active)
+            .def("reattach", &observer::reattach, internal::release_gil())
+            .def("read", &observer::read, internal::release_gil())
+            .def(
+                "latest",
+                [](observer& o) { return o.read(-1); },
+                internal::release_gil())
+            .def("enable_readiness",
+                 &observer::enable_readiness,
+                 pybind11::arg("events") =
+                     static_cast<int>(READY_OBSERVATION))
+            .def("disable_readiness", &observer::disable_readiness)
+            .def("get_readiness_fd", &observer::get_readiness_fd)
+            .def("clear_readiness", &observer::clear_readiness)
+            .def(
+                "read_at_time",
+                [](observer& o, long int stamp) {
+                    return o.read_at_time(TimePoint(stamp));
+                },
+                internal::release_gil())
+            .def(
+                "read_at_times",
+                [](observer& o, const std::vector<long int>& stamps) {
+                    return o.read_at_times(internal::time_points(stamps));
+                },
+                internal::release_gil())
+            .def("initial_states",
+                 &observer::initial_states,
+                 internal::release_gil());
+    }
+
+    if constexpr (!internal::has_type<NO_FRONTEND, EXCLUDED_CLASSES...>())
+    {
+        typedef FrontEndGroup<QUEUE_SIZE,
+                              NB_ACTUATORS,
+                              o80_STATE,
+                              o80_EXTENDED_STATE>
+            frontend_group;
+        typedef typename frontend_group::Actions actions;
+        pybind11::class_<frontend_group> group(
+            m, (prefix + "FrontEndGroup").c_str());
+        group.def(pybind11::init<std::vector<std::string>>())
+            .def(pybind11::init<std::vector<std::string>, int>())
+            .def(pybind11::init<std::vector<std::string>, int, TransportType>())
+            .def("size", &frontend_group::size)
+            .def("get",
+                 &frontend_group::get,
+                 pybind11::return_value_policy::reference_internal)
+            .def("step",
+                 [](frontend_group& fg,
+                    const std::vector<std::array<o80_STATE, NB_ACTUATORS>>&
+                        states,
+                    long int nb_iterations) {
+                     actions a(states.size());
+                     for (std::size_t index = 0; index < states.size(); index++)
+                     {
+                         a[index].values = states[index];
+                     }
+                     pybind11::gil_scoped_release release;
+                     return fg.step(a, nb_iterations);
+                 })
+            .def("burst", &frontend_group::burst, internal::release_gil())
+            .def("latest", &frontend_group::latest, internal::release_gil())
+            .def("final_burst",
+                 &frontend_group::final_burst,
+                 internal::release_gil());
+        if constexpr (std::is_constructible<o80_STATE, double>::value)
+        {
+            // actions as an array of shape [size of group, NB_ACTUATORS]
+            group.def(
+                "step",
+                [](frontend_group& fg,
+                   pybind11::array_t<double, pybind11::array::c_style |
+                                                 pybind11::array::forcecast>
+                       values,
+                   long int nb_iterations) {
+                    if (values.ndim() != 2 || values.shape(1) != NB_ACTUATORS)
+                    {
+                        throw std::runtime_error(
+                            "o80 frontend group: actions should be an array "
+                            "of shape [size of group, number of actuators]");
+                    }
+                    auto v = values.template unchecked<2>();
+                    actions a(values.shape(0));
+                    for (pybind11::ssize_t index = 0; index < v.shape(0);
+                         index++)
+                    {
+                        for (int dof = 0; dof < NB_ACTUATORS; dof++)
+                        {
+                            a[index].set(dof, o80_STATE(v(index, dof)));
+                        }
+                    }
+                    pybind11::gil_scoped_release release;
+                    return fg.step(a, nb_iterations);
+                });
+        }
     }
 
     if constexpr (!internal::has_type<NO_BACKEND, EXCLUDED_CLASSES...>())
     {
         typedef BackEnd<QUEUE_SIZE, NB_ACTUATORS, o80_STATE, o80_EXTENDED_STATE>
             backend;
+        pybind11::class_<typename backend::Snapshot>(
+            m, (prefix + "BackEndSnapshot").c_str());
         pybind11::class_<backend>(m, (prefix + "BackEnd").c_str())
             .def(pybind11::init<std::string>())
             .def(pybind11::init<std::string, bool>())
+            .def(pybind11::init<std::string, bool, double, TransportType>())
+            .def(pybind11::init<std::string,
+                                bool,
+                                double,
+                                TransportType,
+                                SegmentLayout>())
             .def("is_active", &backend::is_active)
-            .def("pulse", &backend::pulse)
-            .def("pulse",
-                 [](backend& bc) {
-                     o80::TimePoint time_now = o80::time_now();
-                     o80::States<NB_ACTUATORS, o80_STATE> states_;
-                     o80_EXTENDED_STATE extended_state;
-                     return bc.pulse(time_now, states_, extended_state);
-                 })
-            .def("pulse",
-                 [](backend& bc, o80_EXTENDED_STATE& extended_state) {
-                     o80::TimePoint time_now = o80::time_now();
-                     o80::States<NB_ACTUATORS, o80_STATE> states_;
-                     return bc.pulse(time_now, states_, extended_state);
-                 })
-            .def("pulse",
-                 [](backend& bc,
-                    const std::array<o80_STATE, NB_ACTUATORS>& dof_states) {
-                     o80::TimePoint time_now = o80::time_now();
-                     o80::States<NB_ACTUATORS, o80_STATE> states;
-                     o80_EXTENDED_STATE extended_state;
-                     for (int dof = 0; dof < NB_ACTUATORS; dof++)
-                     {
-                         states.set(dof, dof_states[dof]);
-                     }
-                     return bc.pulse(time_now, states, extended_state);
-                 });
+            .def("snapshot", &backend::snapshot)
+            .def("restore", &backend::restore)
+            .def("pulse", &backend::pulse, internal::release_gil())
+            .def(
+                "pulse",
+                [](backend& bc) {
+                    o80::TimePoint time_now = o80::time_now();
+                    o80::States<NB_ACTUATORS, o80_STATE> states_;
+                    o80_EXTENDED_STATE extended_state;
+                    return bc.pulse(time_now, states_, extended_state);
+                },
+                internal::release_gil())
+            .def(
+                "pulse",
+                [](backend& bc, o80_EXTENDED_STATE& extended_state) {
+                    o80::TimePoint time_now = o80::time_now();
+                    o80::States<NB_ACTUATORS, o80_STATE> states_;
+                    return bc.pulse(time_now, states_, extended_state);
+                },
+                internal::release_gil())
+            .def(
+                "pulse",
+                [](backend& bc,
+                   const std::array<o80_STATE, NB_ACTUATORS>& dof_states) {
+                    o80::TimePoint time_now = o80::time_now();
+                    o80::States<NB_ACTUATORS, o80_STATE> states;
+                    o80_EXTENDED_STATE extended_state;
+                    for (int dof = 0; dof < NB_ACTUATORS; dof++)
+                    {
+                        states.set(dof, dof_states[dof]);
+                    }
+                    return bc.pulse(time_now, states, extended_state);
+                },
+                internal::release_gil());
     }
     if constexpr (!internal::has_type<NO_INTROSPECTOR, EXCLUDED_CLASSES...>())
     {
         typedef Introspector<o80_STATE> introspector;
         pybind11::class_<introspector>(m, (prefix + "Introspector").c_str())
+            .def(pybind11::init<std::string,
+                                std::string,
+                                IntrospectionFormat,
+                                std::size_t,
+                                double,
+                                std::size_t>(),
+                 pybind11::arg("segment_id"),
+                 pybind11::arg("path") = "",
+                 pybind11::arg("format") = INTROSPECTION_CSV,
+                 pybind11::arg("ring_size") = 10000,
+                 pybind11::arg("period_ms") = 10.,
+                 pybind11::arg("max_events") = 1000)
+            .def("start", &introspector::start)
+            .def("stop", &introspector::stop, internal::release_gil())
+            .def("poll", &introspector::poll, internal::release_gil())
+            .def("get_events", &introspector::get_events)
+            .def("nb_events", &introspector::nb_events)
+            .def("nb_dropped", &introspector::nb_dropped)
             .def_static((prefix + std::string("start")).c_str(),
-                        &introspector::start_running)
+                        &introspector::start_running,
+                        pybind11::arg("segment_id"),
+                        pybind11::arg("path") = "",
+                        pybind11::arg("format") = INTROSPECTION_CSV)
             .def_static((prefix + std::string("stop")).c_str(),
-                        &introspector::stop_running);
+                        &introspector::stop_running)
+            .def_static((prefix + std::string("latest_events")).c_str(),
+                        &introspector::latest_events);
     }
 }
 
@@ -189,9 +592,78 @@ void create_standalone_python_bindings(pybind11::module& m, std::string prefix)
                   segment_id, frequency, bursting, (driver_args)...);
           });
 
-    m.def("stop_standalone", &stop_standalone);
+    m.def((prefix + std::string("start_standalone")).c_str(),
+          [](std::string segment_id,
+             double frequency,
+             bool bursting,
+             RealTimeConfig config,
+             DriverArgs... driver_args) {
+              start_standalone<RobotDriver, RobotStandalone>(
+                  segment_id, frequency, bursting, config, (driver_args)...);
+          });
+
+    m.def((prefix + std::string("start_in_process_standalone")).c_str(),
+          [](std::string segment_id,
+             double frequency,
+             bool bursting,
+             DriverArgs... driver_args) {
+              start_in_process_standalone<RobotDriver, RobotStandalone>(
+                  segment_id, frequency, bursting, (driver_args)...);
+          });
+
+    m.def((prefix + std::string("start_shared_region_standalone")).c_str(),
+          [](std::string segment_id,
+             double frequency,
+             bool bursting,
+             DriverArgs... driver_args) {
+              start_shared_region_standalone<RobotDriver, RobotStandalone>(
+                  segment_id, frequency, bursting, (driver_args)...);
+          });
+
+    typedef StandaloneGroup<RobotDriver, RobotStandalone> standalone_group;
+    pybind11::class_<standalone_group>(
+        m, (prefix + std::string("StandaloneGroup")).c_str())
+        .def(pybind11::init<std::string,
+                            int,
+                            double,
+                            TransportType,
+                            DriverArgs...>())
+        .def("get_segment_ids", &standalone_group::get_segment_ids)
+        .def("stop", &standalone_group::stop, internal::release_gil());
+
+    m.def("stop_standalone", &stop_standalone, internal::release_gil());
+
+    m.def("snapshot_standalone", &snapshot_standalone);
+
+    m.def("restore_standalone", &restore_standalone);
 
     m.def("standalone_is_running", &standalone_is_running);
 
-    m.def("please_stop", &please_stop);
+    m.def("please_stop", &please_stop, internal::release_gil());
+}
+
+template <class Join>
+void create_segment_join_python_bindings(pybind11::module& m,
+                                         std::string name)
+{
+    typedef typename Join::Sample sample;
+    pybind11::class_<sample>(m, (name + std::string("Sample")).c_str())
+        .def_readonly("stamp", &sample::stamp)
+        .def_readonly("observations", &sample::observations);
+    pybind11::class_<Join>(m, name.c_str())
+        .def(pybind11::init<std::array<std::string, Join::size>, long int>())
+        .def(pybind11::init<std::array<std::string, Join::size>,
+                            long int,
+                            JoinMode>())
+        .def(pybind11::init<std::array<std::string, Join::size>,
+                            long int,
+                            JoinMode,
+                            TransportType>())
+        .def("reset", &Join::reset, internal::release_gil())
+        .def("join",
+             (typename Join::Samples(Join::*)()) & Join::join,
+             internal::release_gil())
+        .def("get_next_stamp", &Join::get_next_stamp)
+        .def("get_period", &Join::get_period)
+        .def("get_mode", &Join::get_mode);
 }
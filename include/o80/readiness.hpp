@@ -0,0 +1,22 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+namespace o80
+{
+/**
+ * @brief Events a frontend may request to be notified of, via
+ * its readiness file descriptor (see ObserverFrontEnd::enable_readiness).
+ * Values may be combined (bitwise or).
+ * observation : the backend wrote a new observation
+ * completion : at least one command completed
+ * burst : the standalone finished a burst and waits for the next one
+ */
+enum ReadinessEvent
+{
+    READY_OBSERVATION = 1,
+    READY_COMPLETION = 2,
+    READY_BURST = 4
+};
+}  // namespace o80
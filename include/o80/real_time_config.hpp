@@ -0,0 +1,66 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace o80
+{
+/*! scheduling policy of the thread running a standalone*/
+enum SchedulingPolicy
+{
+    FIFO_POLICY,
+    ROUND_ROBIN_POLICY,
+    OTHER_POLICY
+};
+
+/**
+ * ! Configuration of the real time thread running a standalone
+ *   (see start_standalone). It is applied by the thread itself, before
+ *   its first iteration. Setting the cpus, a real time policy or locking
+ *   the memory usually requires the related privileges (e.g. rtprio and
+ *   memlock limits), a runtime_error is thrown otherwise.
+ */
+class RealTimeConfig
+{
+public:
+    RealTimeConfig();
+
+    /*! applies the configuration to the calling thread (and process,
+        for memory locking). Throws a runtime_error on failure.*/
+    void apply() const;
+
+    /*! reads (once per page) all the shared memory segments of the
+        segment_id mapped in this process, so that no page fault occurs
+        when the standalone accesses them. If lock is true, the segments
+        are also locked in memory (mlock, failures are ignored). Returns
+        the number of pages touched*/
+    static std::size_t touch_segment_pages(const std::string& segment_id,
+                                           bool lock = false);
+
+    /*! writes (once per page) nb_bytes of the stack of the calling thread,
+        so that no page fault occurs when the stack later grows*/
+    static void prefault_stack(std::size_t nb_bytes);
+
+public:
+    /*! cpus the thread will be pinned to (no pinning if empty)*/
+    std::vector<int> cpus;
+    /*! scheduling policy (default: FIFO_POLICY)*/
+    SchedulingPolicy policy;
+    /*! scheduling priority (default: 80, ignored for OTHER_POLICY)*/
+    int priority;
+    /*! if true (default), mlockall(MCL_CURRENT|MCL_FUTURE) is called*/
+    bool lock_memory;
+    /*! number of bytes of the stack to prefault (default: 0)*/
+    std::size_t stack_prefault_size;
+    /*! if true (default: false), touch_segment_pages is called
+        for the segment id of the standalone*/
+    bool touch_segments;
+    /*! if true (default: false), the get and set methods of the driver
+        run in a dedicated I/O thread (see Standalone::set_pipelined_io)*/
+    bool pipelined_io;
+};
+}  // namespace o80
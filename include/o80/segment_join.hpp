@@ -0,0 +1,162 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "o80/observation.hpp"
+#include "o80/observer_front_end.hpp"
+#include "o80/transport.hpp"
+#include "o80_internal/observation_interpolation.hpp"
+
+namespace o80
+{
+/*! how SegmentJoin computes the observation of a segment at
+ *  a time stamp*/
+enum JoinMode
+{
+    /*! the observation with the closest time stamp*/
+    NEAREST_SAMPLE,
+    /*! the states are interpolated between the observations
+        bracketing the time stamp*/
+    INTERPOLATED
+};
+
+namespace internal
+{
+/**
+ * ! Reads the observations of a segment in order, keeping the two
+ *   latest observations read (bracketing the time stamp of the latest
+ *   request). Each observation is read only once.
+ */
+template <class SegmentObserver>
+class JoinCursor
+{
+public:
+    typedef typename SegmentObserver::Observations::value_type JoinObservation;
+
+public:
+    JoinCursor(const std::string& segment_id, TransportType transport);
+
+    /*! starts from the latest observation, and returns its time stamp.
+        Throws a runtime_error if the backend did not write any observation
+        yet.*/
+    long int reset();
+
+    /*! reads the observations (following the ones already read) until
+        the observations bracketing stamp have been read, or
+        until the latest observation. Returns true if the observation
+        at stamp can be computed. Throws a range_error if the observations
+        to read have been overwritten by the backend.*/
+    bool ready(long int stamp);
+
+    /*! observation at stamp (to be called only if ready(stamp)
+        returned true)*/
+    JoinObservation get(long int stamp, JoinMode mode) const;
+
+private:
+    std::unique_ptr<SegmentObserver> observer_;
+    long int index_;
+    JoinObservation before_;
+    JoinObservation after_;
+    bool has_after_;
+};
+}  // namespace internal
+
+/**
+ * ! Joins the observations of several segments (e.g. a robot, a ball
+ *   tracker and pressure sensors, each backend running at its own
+ *   frequency) into time aligned samples, at a fixed output period.
+ *   A sample gathers, for each segment, either the observation closest
+ *   to the time stamp of the sample, or an observation which states are
+ *   interpolated between the two observations bracketing this time stamp
+ *   (see JoinMode). The join is incremental: each segment has a
+ *   cursor, and each observation is read only once.
+ *   @tparam SegmentObservers ObserverFrontEnd (or FrontEnd) types, one per
+ *           segment
+ */
+template <class... SegmentObservers>
+class SegmentJoin
+{
+public:
+    static constexpr int size = sizeof...(SegmentObservers);
+    /*! one observation per segment*/
+    typedef std::tuple<typename SegmentObservers::Observations::value_type...>
+        JoinedObservations;
+    /*! observations of all the segments at the time stamp stamp
+        (nanoseconds, see Observation::get_time_stamp)*/
+    struct Sample
+    {
+        long int stamp;
+        JoinedObservations observations;
+    };
+    typedef std::vector<Sample> Samples;
+
+public:
+    /**
+     * @param segment_ids one segment id per observer type
+     * @param period_ns period between the time stamps of two successive
+     *        samples, in nanoseconds
+     * @param mode nearest sample or interpolation
+     * @param transport should be the one used by the backends
+     */
+    SegmentJoin(
+        const std::array<std::string, sizeof...(SegmentObservers)>&
+            segment_ids,
+        long int period_ns,
+        JoinMode mode = INTERPOLATED,
+        TransportType transport = SHARED_MEMORY);
+
+    /*! restarts the join from the latest observations: the next sample
+        will be at the time stamp of the most recent of the latest
+        observations of the segments. Called during the first call to
+        join. Throws a runtime_error if a backend did not write any
+        observation yet.*/
+    void reset();
+
+    /*! computes all the samples which can be computed since the
+        previous call (i.e. the samples which time stamps are anterior to
+        the latest observation of all the segments) and appends them to
+        push_back_to. Returns the number of samples added. Throws a
+        range_error if the observations of a segment have been overwritten
+        before being read (i.e. join was not called often enough, the
+        join should then be reset).*/
+    int join(Samples& push_back_to);
+
+    /*! same as join(Samples&), returning the new samples*/
+    Samples join();
+
+    /*! time stamp of the next sample*/
+    long int get_next_stamp() const;
+
+    long int get_period() const;
+
+    JoinMode get_mode() const;
+
+private:
+    template <std::size_t... INDEX>
+    SegmentJoin(
+        const std::array<std::string, sizeof...(SegmentObservers)>&
+            segment_ids,
+        long int period_ns,
+        JoinMode mode,
+        TransportType transport,
+        std::index_sequence<INDEX...>);
+
+private:
+    long int period_ns_;
+    JoinMode mode_;
+    long int next_stamp_;
+    bool started_;
+    std::tuple<internal::JoinCursor<SegmentObservers>...> cursors_;
+};
+
+#include "segment_join.hxx"
+
+}  // namespace o80
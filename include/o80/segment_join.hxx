@@ -0,0 +1,182 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+namespace internal
+{
+#define TEMPLATE_JOIN_CURSOR template <class SegmentObserver>
+#define JOIN_CURSOR JoinCursor<SegmentObserver>
+
+TEMPLATE_JOIN_CURSOR
+JOIN_CURSOR::JoinCursor(const std::string& segment_id,
+                        TransportType transport)
+    : observer_(new SegmentObserver(segment_id, transport)),
+      index_(-1),
+      has_after_(false)
+{
+}
+
+TEMPLATE_JOIN_CURSOR
+long int JOIN_CURSOR::reset()
+{
+    index_ = observer_->newest_index();
+    if (index_ < 0)
+    {
+        throw std::runtime_error(
+            "o80 segment join: no observation written by the backend "
+            "yet");
+    }
+    before_ = observer_->read(index_);
+    has_after_ = false;
+    return before_.get_time_stamp();
+}
+
+TEMPLATE_JOIN_CURSOR
+bool JOIN_CURSOR::ready(long int stamp)
+{
+    // before_ is always the latest observation not more recent than stamp
+    while (before_.get_time_stamp() < stamp)
+    {
+        if (!has_after_)
+        {
+            if (observer_->newest_index() <= index_)
+            {
+                // waiting for the backend
+                return false;
+            }
+            // throws a range_error if overwritten
+            after_ = observer_->read(index_ + 1);
+            has_after_ = true;
+        }
+        if (after_.get_time_stamp() > stamp)
+        {
+            return true;
+        }
+        before_ = std::move(after_);
+        index_++;
+        has_after_ = false;
+    }
+    return true;
+}
+
+TEMPLATE_JOIN_CURSOR
+typename JOIN_CURSOR::JoinObservation JOIN_CURSOR::get(long int stamp,
+                                                       JoinMode mode) const
+{
+    if (!has_after_ || before_.get_time_stamp() == stamp)
+    {
+        return before_;
+    }
+    if (mode == NEAREST_SAMPLE)
+    {
+        if (after_.get_time_stamp() - stamp < stamp - before_.get_time_stamp())
+        {
+            return after_;
+        }
+        return before_;
+    }
+    return interpolate_observation(before_, after_, stamp);
+}
+
+}  // namespace internal
+
+#define TEMPLATE_SEGMENT_JOIN template <class... SegmentObservers>
+#define SEGMENT_JOIN SegmentJoin<SegmentObservers...>
+
+TEMPLATE_SEGMENT_JOIN
+SEGMENT_JOIN::SegmentJoin(
+    const std::array<std::string, sizeof...(SegmentObservers)>& segment_ids,
+    long int period_ns,
+    JoinMode mode,
+    TransportType transport)
+    : SegmentJoin(segment_ids,
+                  period_ns,
+                  mode,
+                  transport,
+                  std::index_sequence_for<SegmentObservers...>())
+{
+}
+
+TEMPLATE_SEGMENT_JOIN
+template <std::size_t... INDEX>
+SEGMENT_JOIN::SegmentJoin(
+    const std::array<std::string, sizeof...(SegmentObservers)>& segment_ids,
+    long int period_ns,
+    JoinMode mode,
+    TransportType transport,
+    std::index_sequence<INDEX...>)
+    : period_ns_(period_ns),
+      mode_(mode),
+      next_stamp_(-1),
+      started_(false),
+      cursors_(internal::JoinCursor<SegmentObservers>(segment_ids[INDEX],
+                                               transport)...)
+{
+    if (period_ns_ <= 0)
+    {
+        throw std::runtime_error(
+            "o80 segment join: the period should be strictly positive");
+    }
+}
+
+TEMPLATE_SEGMENT_JOIN
+void SEGMENT_JOIN::reset()
+{
+    std::apply(
+        [this](auto&... cursor) {
+            next_stamp_ = std::max({cursor.reset()...});
+        },
+        cursors_);
+    started_ = true;
+}
+
+TEMPLATE_SEGMENT_JOIN
+int SEGMENT_JOIN::join(Samples& push_back_to)
+{
+    if (!started_)
+    {
+        reset();
+    }
+    int nb_samples = 0;
+    while (std::apply(
+        [this](auto&... cursor) { return (cursor.ready(next_stamp_) && ...); },
+        cursors_))
+    {
+        push_back_to.push_back(Sample{
+            next_stamp_,
+            std::apply(
+                [this](const auto&... cursor) {
+                    return JoinedObservations(
+                        cursor.get(next_stamp_, mode_)...);
+                },
+                cursors_)});
+        next_stamp_ += period_ns_;
+        nb_samples++;
+    }
+    return nb_samples;
+}
+
+TEMPLATE_SEGMENT_JOIN
+typename SEGMENT_JOIN::Samples SEGMENT_JOIN::join()
+{
+    Samples samples;
+    join(samples);
+    return samples;
+}
+
+TEMPLATE_SEGMENT_JOIN
+long int SEGMENT_JOIN::get_next_stamp() const
+{
+    return next_stamp_;
+}
+
+TEMPLATE_SEGMENT_JOIN
+long int SEGMENT_JOIN::get_period() const
+{
+    return period_ns_;
+}
+
+TEMPLATE_SEGMENT_JOIN
+JoinMode SEGMENT_JOIN::get_mode() const
+{
+    return mode_;
+}
@@ -0,0 +1,85 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace o80
+{
+/**
+ * ! Capacity of each of the time series shared by a backend
+ *   and its frontends. Set by the backend, frontends read it
+ *   when attaching to the backend.
+ *   - commands: commands shared by the frontends
+ *   - observations: observations written by the backend (i.e. size
+ *     of the history available to the frontends)
+ *   - completed: ids of the commands completed by the backend
+ *   - introspection: ids of the commands received and started by the
+ *     backend, and waited for / reported by the frontends (debug
+ *     and introspection only). If 0, these time series are not created.
+ *   - traces: time stamped lifecycle events of the commands (see
+ *     CommandTrace). If 0 (default), the traces are not recorded.
+ *   The memory options (huge_pages and prefault, default false) are
+ *   applied by the backend when creating the time series. huge_pages
+ *   is supported only by the SHARED_REGION transport, prefault by the
+ *   SHARED_REGION and SHARED_MEMORY transports: the backend throws an
+ *   invalid_argument if they are set for another transport.
+ */
+class SegmentLayout
+{
+public:
+    /*! all capacities set to 0 (to be deserialized)*/
+    SegmentLayout();
+
+    /*! all time series (including introspection) have the
+        capacity queue_size, traces are disabled*/
+    SegmentLayout(std::size_t queue_size);
+
+    SegmentLayout(std::size_t commands_size,
+                  std::size_t observations_size,
+                  std::size_t completed_size,
+                  std::size_t introspection_size,
+                  std::size_t trace_size = 0);
+
+    /*! true if the introspection time series are created*/
+    bool has_introspection() const;
+
+    /*! true if the lifecycle of the commands is traced*/
+    bool has_traces() const;
+
+    /*! throws an invalid_argument if the capacity of the commands,
+        observations or completed time series is 0 (called by the
+        backend before creating the time series)*/
+    void check() const;
+
+    std::string to_string() const;
+
+    template <class Archive>
+    void serialize(Archive& archive)
+    {
+        archive(commands_size,
+                observations_size,
+                completed_size,
+                introspection_size,
+                trace_size);
+    }
+
+public:
+    std::size_t commands_size;
+    std::size_t observations_size;
+    std::size_t completed_size;
+    std::size_t introspection_size;
+    std::size_t trace_size;
+    /*! if true, the memory of the time series is allocated from huge
+        pages (hugetlbfs), falling back to transparent huge pages
+        (madvise) and then to regular pages if none are available*/
+    bool huge_pages;
+    /*! if true, all the pages of the time series are touched and
+        locked in memory (mlock) when created, so that no page fault
+        occurs when first writing to them. Locking failures (e.g.
+        memlock limits) are ignored.*/
+    bool prefault;
+};
+}  // namespace o80
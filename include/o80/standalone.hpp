@@ -8,7 +8,10 @@
 #include "o80/driver.hpp"
 #include "o80/frequency_manager.hpp"
 #include "o80/observation.hpp"
+#include "o80/real_time_config.hpp"
 #include "o80/time.hpp"
+#include "o80/transport.hpp"
+#include "o80_internal/pipelined_io.hpp"
 #include "o80_internal/standalone_runner.hpp"
 #include "synchronizer/leader.hpp"
 
@@ -29,6 +32,8 @@ void please_stop(std::string segment_id)
     catch (...)
     {
     }
+    internal::release_in_process_segment(segment_id);
+    internal::SharedRegion::release(segment_id);
 }
 
 /**
@@ -72,6 +77,16 @@ private:
     typedef BackEnd<QUEUE_SIZE, NB_ACTUATORS, o80_STATE, o80_EXTENDED_STATE>
         o80Backend;
 
+public:
+    /*! state of the standalone, as returned by snapshot*/
+    class Snapshot
+    {
+    public:
+        typename o80Backend::Snapshot backend;
+        // (virtual) time of the next iteration
+        TimePoint now;
+    };
+
 public:
     /**
      * Creates instances of:
@@ -81,8 +96,17 @@ public:
      * @param ri_driver robot_interfaces robot driver
      * @param frequency desired frequency
      * @param segment_id shared memory segment id for o80 BackEnd.
+     * @param transport shared memory (default) or in process.
+     *        Subclasses supporting in process transport should
+     *        forward this argument.
+     * @param layout capacities of the time series of the segment
+     *        (default: all of size QUEUE_SIZE).
      */
-    Standalone(DriverPtr driver_ptr, double frequency, std::string segment_id);
+    Standalone(DriverPtr driver_ptr,
+               double frequency,
+               std::string segment_id,
+               TransportType transport = SHARED_MEMORY,
+               const SegmentLayout& layout = SegmentLayout(QUEUE_SIZE));
 
     ~Standalone();
 
@@ -96,6 +120,42 @@ public:
      */
     void stop();
 
+    /**
+     * ! If true, the get and set methods of the driver are called
+     *   by a dedicated I/O thread (spawned by the first iteration, and
+     *   inheriting the configuration of the calling thread), so that
+     *   reading the sensors of the next iteration overlaps with the
+     *   computation of the current action. This increases the throughput
+     *   of drivers with slow I/O, but the action of an iteration is
+     *   then applied one iteration later (see PipelinedIO).
+     *   Should be called before the first iteration.
+     */
+    void set_pipelined_io(bool pipelined);
+
+    /**
+     * ! returns the state of the o80 backend (see BackEnd::snapshot)
+     *   and the time of the next iteration. The state of the driver is
+     *   not part of the snapshot.
+     */
+    Snapshot snapshot() const;
+
+    /**
+     * ! restores a snapshot (see BackEnd::restore)
+     */
+    void restore(const Snapshot& snapshot);
+
+    /**
+     * ! starts recording the commands executed by the o80 backend
+     *   (see BackEnd::start_recording)
+     */
+    void start_recording(const std::string& path,
+                         std::size_t ring_size = 4096);
+
+    /**
+     * ! stops the recording (see BackEnd::stop_recording)
+     */
+    long int stop_recording();
+
     /**
      * ! - If bursting is false, performs one iteration and then wait for the
      * time requied to match the desired frequency.
@@ -142,9 +202,10 @@ private:
     Microseconds period_;
     FrequencyManager frequency_manager_;
     TimePoint now_;
-    std::shared_ptr<Burster> burster_;
     std::string segment_id_;
     DriverPtr driver_ptr_;
+    bool pipelined_;
+    std::shared_ptr<internal::PipelinedIO<DRIVER>> pipelined_io_;
     o80Backend o8o_backend_;
 };
 
@@ -175,6 +236,49 @@ void start_standalone(std::string segment_id,
                       bool bursting,
                       Args&&... args);
 
+/**
+ * @brief similar to start_standalone, except that the thread running
+ * the standalone is configured according to config (cpus, scheduling
+ * policy and priority, memory locking, stack and shared memory
+ * prefaulting) before its first iteration. A runtime error is thrown if
+ * the configuration could not be applied (e.g. missing privileges).
+ */
+template <class RobotDriver, class o80Standalone, typename... Args>
+void start_standalone(std::string segment_id,
+                      double frequency,
+                      bool bursting,
+                      RealTimeConfig config,
+                      Args&&... args);
+
+/**
+ * @brief similar to start_standalone, except that the standalone
+ * exchanges commands and observations with FrontEnd via in process
+ * transport, i.e. only frontends running in the current process and
+ * constructed with the IN_PROCESS transport type will be able to connect.
+ * The constructor of o80Standalone should accept a TransportType
+ * as fourth argument, and forward it to the constructor of
+ * Standalone.
+ */
+template <class RobotDriver, class o80Standalone, typename... Args>
+void start_in_process_standalone(std::string segment_id,
+                                 double frequency,
+                                 bool bursting,
+                                 Args&&... args);
+
+/**
+ * @brief similar to start_standalone, except that the standalone
+ * exchanges commands and observations with FrontEnd via a single shared
+ * memory region (see SharedRegionTransport). Frontends should be
+ * constructed with the SHARED_REGION transport type.
+ * As for start_in_process_standalone, the constructor of o80Standalone
+ * should accept a TransportType as fourth argument.
+ */
+template <class RobotDriver, class o80Standalone, typename... Args>
+void start_shared_region_standalone(std::string segment_id,
+                                    double frequency,
+                                    bool bursting,
+                                    Args&&... args);
+
 /**
  * ! Stop the standalone of the specified segment_id.
  *   A runtime error is thrown if no such standalone is running.
@@ -187,5 +291,26 @@ void stop_standalone(std::string segment_id);
  */
 bool standalone_is_running(std::string segment_id);
 
+/*! opaque snapshot of a standalone started via start_standalone*/
+typedef std::shared_ptr<internal::StandaloneSnapshotInterface>
+    StandaloneSnapshot;
+
+/**
+ * ! Returns a snapshot of the (o80) state of the standalone
+ *   (see Standalone::snapshot). The standalone must run in bursting
+ *   mode, and the snapshot must be taken between bursts (i.e. not
+ *   while another thread calls burst). A runtime error is thrown if no
+ *   such standalone is running.
+ */
+StandaloneSnapshot snapshot_standalone(std::string segment_id);
+
+/**
+ * ! Restores the snapshot of the standalone (which should have been
+ *   returned by snapshot_standalone for the same segment id, or for a
+ *   standalone of the same type). Same constraints as
+ *   snapshot_standalone.
+ */
+void restore_standalone(std::string segment_id, StandaloneSnapshot snapshot);
+
 #include "standalone.hxx"
 }  // namespace o80
@@ -11,34 +11,26 @@
 #define STANDALONE \
     Standalone<QUEUE_SIZE, NB_ACTUATORS, DRIVER, o80_STATE, o80_EXTENDED_STATE>
 
-static long int get_bursting(const std::string& segment_id)
-{
-    long int r;
-    shared_memory::get<long int>(segment_id, "bursting", r);
-    return r;
-}
-
-static void reset_bursting(const std::string& segment_id)
-{
-    shared_memory::set<long int>(segment_id, "bursting", 0);
-}
-
 TEMPLATE_STANDALONE
 STANDALONE::Standalone(DriverPtr driver_ptr,
                        double frequency,
-                       std::string segment_id)
+                       std::string segment_id,
+                       TransportType transport,
+                       const SegmentLayout& layout)
     : frequency_(frequency),
       period_(static_cast<long int>((1.0 / frequency) * 1E6 + 0.5)),
       frequency_manager_(frequency_),
       now_(time_now()),
-      burster_(nullptr),
       segment_id_(segment_id),
       driver_ptr_(driver_ptr),
-      o8o_backend_(segment_id,false,(1./frequency)*1e6)
+      pipelined_(false),
+      pipelined_io_(nullptr),
+      o8o_backend_(
+          segment_id, false, (1. / frequency) * 1e6, transport, layout)
 {
     shared_memory::set<bool>(segment_id, "should_stop", false);
     shared_memory::set<float>(segment_id, "frequency", frequency);
-    reset_bursting(segment_id);
+    o8o_backend_.get_transport().reset_bursting();
 }
 
 TEMPLATE_STANDALONE
@@ -56,15 +48,66 @@ void STANDALONE::start()
 TEMPLATE_STANDALONE
 void STANDALONE::stop()
 {
+    if (pipelined_io_ != nullptr)
+    {
+        pipelined_io_->stop();
+        pipelined_io_.reset();
+    }
     driver_ptr_->stop();
 }
 
+TEMPLATE_STANDALONE
+void STANDALONE::set_pipelined_io(bool pipelined)
+{
+    pipelined_ = pipelined;
+}
+
+TEMPLATE_STANDALONE
+typename STANDALONE::Snapshot STANDALONE::snapshot() const
+{
+    Snapshot snapshot;
+    snapshot.backend = o8o_backend_.snapshot();
+    snapshot.now = now_;
+    return snapshot;
+}
+
+TEMPLATE_STANDALONE
+void STANDALONE::restore(const Snapshot& snapshot)
+{
+    o8o_backend_.restore(snapshot.backend);
+    now_ = snapshot.now;
+}
+
+TEMPLATE_STANDALONE
+void STANDALONE::start_recording(const std::string& path,
+                                 std::size_t ring_size)
+{
+    o8o_backend_.start_recording(path, ring_size);
+}
+
+TEMPLATE_STANDALONE
+long int STANDALONE::stop_recording()
+{
+    return o8o_backend_.stop_recording();
+}
+
 TEMPLATE_STANDALONE
 bool STANDALONE::iterate(const TimePoint& time_now,
                          o80_EXTENDED_STATE& extended_state)
 {
+    // pipelined: get and set are called by the I/O thread, which
+    // is created here so that it inherits the (real time) configuration
+    // of the thread running the standalone
+    if (pipelined_ && pipelined_io_ == nullptr)
+    {
+        pipelined_io_ =
+            std::make_shared<internal::PipelinedIO<DRIVER>>(driver_ptr_);
+        pipelined_io_->start();
+    }
+
     // reading sensory info from the robot (robot_interfaces)
-    typename DRIVER::DRIVER_OUT ri_current_states = driver_ptr_->get();
+    typename DRIVER::DRIVER_OUT ri_current_states =
+        pipelined_ ? pipelined_io_->get() : driver_ptr_->get();
 
     // converting robot_interfaces sensory reading to o80 state
     o80::States<NB_ACTUATORS, o80_STATE> o8o_current_states =
@@ -84,7 +127,14 @@ bool STANDALONE::iterate(const TimePoint& time_now,
     typename DRIVER::DRIVER_IN action = convert(desired_states);
 
     // applying actions to robot
-    driver_ptr_->set(action);
+    if (pipelined_)
+    {
+        pipelined_io_->set(action);
+    }
+    else
+    {
+        driver_ptr_->set(action);
+    }
 
     // check if stop command written by user in shared memory
     bool should_stop;
@@ -96,16 +146,10 @@ bool STANDALONE::iterate(const TimePoint& time_now,
 TEMPLATE_STANDALONE
 bool STANDALONE::spin(o80_EXTENDED_STATE& extended_state, bool bursting)
 {
-    if (bursting && burster_ == nullptr)
-    {
-        burster_ = std::make_shared<Burster>(segment_id_);
-    }
-
     long int nb_iterations = 1;
     if (bursting)
     {
-        nb_iterations = get_bursting(segment_id_);
-        reset_bursting(segment_id_);
+        nb_iterations = o8o_backend_.get_transport().get_bursting();
     }
 
     bool should_not_stop = true;
@@ -142,7 +186,8 @@ bool STANDALONE::spin(o80_EXTENDED_STATE& extended_state, bool bursting)
     // wait for client/python to ask to go again
     if (bursting && should_not_stop)
     {
-        burster_->pulse();
+        o8o_backend_.notify_burst_end();
+        o8o_backend_.get_transport().wait_for_burst();
     }
 
     return should_not_stop;
@@ -155,11 +200,15 @@ bool STANDALONE::spin(bool bursting)
     return spin(empty, bursting);
 }
 
+namespace internal
+{
 template <class Driver, class o80Standalone, typename... Args>
-void start_action_timed_standalone(std::string segment_id,
-                                   double frequency,
-                                   bool bursting,
-                                   Args&&... args)
+void start_standalone(std::string segment_id,
+                      double frequency,
+                      bool bursting,
+                      TransportType transport,
+                      std::optional<RealTimeConfig> config,
+                      Args&&... args)
 {
     if (internal::standalone_exists(segment_id))
     {
@@ -169,16 +218,38 @@ void start_action_timed_standalone(std::string segment_id,
         throw std::runtime_error(error);
     }
 
-    o80::clear_shared_memory(segment_id);
+    // note: the backend of the standalone clears the segment left by a
+    // previous standalone (if any), unless this one is still running
+    // (see internal::reclaim_segment)
 
     typedef internal::StandaloneRunner<Driver, o80Standalone> SR;
     typedef std::shared_ptr<SR> SRPtr;
 
-    SRPtr runner(
-        new SR(segment_id, frequency, bursting, std::forward<Args>(args)...));
+    SRPtr runner(new SR(segment_id,
+                        frequency,
+                        bursting,
+                        transport,
+                        config,
+                        std::forward<Args>(args)...));
     runner->start();
     internal::add_standalone(segment_id, runner);
 }
+}  // namespace internal
+
+template <class Driver, class o80Standalone, typename... Args>
+void start_action_timed_standalone(std::string segment_id,
+                                   double frequency,
+                                   bool bursting,
+                                   Args&&... args)
+{
+    internal::start_standalone<Driver, o80Standalone, Args...>(
+        segment_id,
+        frequency,
+        bursting,
+        SHARED_MEMORY,
+        std::nullopt,
+        std::forward<Args>(args)...);
+}
 
 template <class Driver, class o80Standalone, typename... Args>
 void start_standalone(std::string segment_id,
@@ -190,6 +261,52 @@ void start_standalone(std::string segment_id,
         segment_id, frequency, bursting, std::forward<Args>(args)...);
 }
 
+template <class Driver, class o80Standalone, typename... Args>
+void start_standalone(std::string segment_id,
+                      double frequency,
+                      bool bursting,
+                      RealTimeConfig config,
+                      Args&&... args)
+{
+    internal::start_standalone<Driver, o80Standalone, Args...>(
+        segment_id,
+        frequency,
+        bursting,
+        SHARED_MEMORY,
+        config,
+        std::forward<Args>(args)...);
+}
+
+template <class Driver, class o80Standalone, typename... Args>
+void start_in_process_standalone(std::string segment_id,
+                                 double frequency,
+                                 bool bursting,
+                                 Args&&... args)
+{
+    internal::start_standalone<Driver, o80Standalone, Args...>(
+        segment_id,
+        frequency,
+        bursting,
+        IN_PROCESS,
+        std::nullopt,
+        std::forward<Args>(args)...);
+}
+
+template <class Driver, class o80Standalone, typename... Args>
+void start_shared_region_standalone(std::string segment_id,
+                                    double frequency,
+                                    bool bursting,
+                                    Args&&... args)
+{
+    internal::start_standalone<Driver, o80Standalone, Args...>(
+        segment_id,
+        frequency,
+        bursting,
+        SHARED_REGION,
+        std::nullopt,
+        std::forward<Args>(args)...);
+}
+
 bool standalone_is_running(std::string segment_id)
 {
     if (!internal::standalone_exists(segment_id))
@@ -216,3 +333,27 @@ void stop_standalone(std::string segment_id)
 
     o80::clear_shared_memory(segment_id);
 }
+
+StandaloneSnapshot snapshot_standalone(std::string segment_id)
+{
+    if (!internal::standalone_exists(segment_id))
+    {
+        std::string error = std::string("standalone ");
+        error += segment_id;
+        error += std::string(" does not exist");
+        throw std::runtime_error(error);
+    }
+    return internal::get_standalone(segment_id)->snapshot();
+}
+
+void restore_standalone(std::string segment_id, StandaloneSnapshot snapshot)
+{
+    if (!internal::standalone_exists(segment_id))
+    {
+        std::string error = std::string("standalone ");
+        error += segment_id;
+        error += std::string(" does not exist");
+        throw std::runtime_error(error);
+    }
+    internal::get_standalone(segment_id)->restore(snapshot);
+}
@@ -0,0 +1,56 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "o80/standalone.hpp"
+#include "o80/transport.hpp"
+
+namespace o80
+{
+/**
+ * ! Starts nb_standalones standalones in bursting mode, each running in
+ *   its own thread, with the segment ids segment_id_prefix_0,
+ *   segment_id_prefix_1, ... . Intended to be used with a FrontEndGroup
+ *   (e.g. for stepping several simulated robots in parallel).
+ *   The standalones are stopped by the destructor.
+ *   @tparam RobotDriver driver class
+ *   @tparam o80Standalone standalone class
+ */
+template <class RobotDriver, class o80Standalone>
+class StandaloneGroup
+{
+public:
+    /**
+     * @param segment_id_prefix prefix of the segment ids
+     * @param nb_standalones number of standalones to start
+     * @param frequency frequency of the standalones (used to
+     *        compute the time stamps of the observations)
+     * @param transport should be the one used by the frontends
+     * @param args arguments of the drivers constructor (each
+     *        driver is constructed with the same arguments)
+     */
+    template <typename... Args>
+    StandaloneGroup(std::string segment_id_prefix,
+                    int nb_standalones,
+                    double frequency,
+                    TransportType transport,
+                    const Args&... args);
+
+    ~StandaloneGroup();
+
+    /*! segment ids of the standalones (to be used for
+        creating a FrontEndGroup)*/
+    const std::vector<std::string>& get_segment_ids() const;
+
+    /*! requests all standalones to stop, then waits for them to exit*/
+    void stop();
+
+private:
+    std::vector<std::string> segment_ids_;
+};
+
+#include "standalone_group.hxx"
+}  // namespace o80
@@ -0,0 +1,64 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#define TEMPLATE_STANDALONE_GROUP \
+    template <class RobotDriver, class o80Standalone>
+
+#define STANDALONE_GROUP StandaloneGroup<RobotDriver, o80Standalone>
+
+TEMPLATE_STANDALONE_GROUP
+template <typename... Args>
+STANDALONE_GROUP::StandaloneGroup(std::string segment_id_prefix,
+                                  int nb_standalones,
+                                  double frequency,
+                                  TransportType transport,
+                                  const Args&... args)
+{
+    try
+    {
+        for (int index = 0; index < nb_standalones; index++)
+        {
+            std::string segment_id =
+                segment_id_prefix + std::string("_") + std::to_string(index);
+            internal::start_standalone<RobotDriver, o80Standalone>(
+                segment_id, frequency, true, transport, std::nullopt, args...);
+            segment_ids_.push_back(segment_id);
+        }
+    }
+    catch (...)
+    {
+        stop();
+        throw;
+    }
+}
+
+TEMPLATE_STANDALONE_GROUP
+STANDALONE_GROUP::~StandaloneGroup()
+{
+    stop();
+}
+
+TEMPLATE_STANDALONE_GROUP
+const std::vector<std::string>& STANDALONE_GROUP::get_segment_ids() const
+{
+    return segment_ids_;
+}
+
+TEMPLATE_STANDALONE_GROUP
+void STANDALONE_GROUP::stop()
+{
+    // please_stop releases the standalones waiting for a burst
+    for (const std::string& segment_id : segment_ids_)
+    {
+        please_stop(segment_id);
+    }
+    for (const std::string& segment_id : segment_ids_)
+    {
+        if (internal::standalone_exists(segment_id))
+        {
+            stop_standalone(segment_id);
+            internal::remove_standalone(segment_id);
+        }
+    }
+    segment_ids_.clear();
+}
@@ -0,0 +1,125 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include "o80/command_types.hpp"
+#include "o80/time.hpp"
+
+namespace o80
+{
+/*! Similarly to StateXd, an instance of StateNd represents the state
+ *  of an actuator having several attributes, but all of the same type
+ *  T, e.g.
+ *  \code{.cpp}
+ *  typedef StateNd<double, 6> Pose;
+ *  \endcode
+ *  The attributes are stored in an aligned array, and interpolated
+ *  in a single loop over the array (rather than recursively,
+ *  attribute per attribute), which the compiler may unroll and
+ *  vectorize. The interpolation is the same as the one of StateXd:
+ *  speed commands apply to the first attribute, the other attributes
+ *  interpolating over the duration this requires.
+ *  @tparam T type of the attributes (arithmetic)
+ *  @tparam N number of attributes
+ */
+template <typename T, int N>
+class StateNd
+{
+public:
+    static constexpr int size = N;
+
+private:
+    // arrays of at least 32 bytes are aligned for avx
+    static constexpr std::size_t alignment =
+        sizeof(T) * N >= 32 ? 32 : alignof(std::array<T, N>);
+
+public:
+    /*! all attributes set to 0*/
+    StateNd();
+    StateNd(const std::array<T, N>& init);
+
+    /*! returns the attribute at index*/
+    T get(int index) const;
+
+    /*! sets the attribute at index*/
+    void set(int index, T value);
+
+    std::string to_string() const;
+
+    /*! returns true if the speed command finished for the attribute
+     *  at the first (0) index
+     */
+    bool finished(const o80::TimePoint& start,
+                  const o80::TimePoint& now,
+                  const StateNd<T, N>& start_state,
+                  const StateNd<T, N>& current_state,
+                  const StateNd<T, N>& previous_desired_state,
+                  const StateNd<T, N>& target_state,
+                  const o80::Speed& speed) const;
+
+    /* ! uses linear interpolation to compute the desired state
+     *   at TimePoint "now" provided the speed command. Note that the speed
+     *   of the command corresponds to the first (0) index attribute.
+     *   The other attributes interpolate using a duration command
+     *   inferred from the speed command applied to the first index. */
+    StateNd<T, N> intermediate_state(
+        const o80::TimePoint& start,
+        const o80::TimePoint& now,
+        const StateNd<T, N>& start_state,
+        const StateNd<T, N>& current_state,
+        const StateNd<T, N>& previous_desired_state,
+        const StateNd<T, N>& target_state,
+        const o80::Speed& speed) const;
+
+    /* ! uses linear interpolation to compute the desired state
+     *   at TimePoint "now" provided the duration command. */
+    StateNd<T, N> intermediate_state(
+        const o80::TimePoint& start,
+        const o80::TimePoint& now,
+        const StateNd<T, N>& start_state,
+        const StateNd<T, N>& current_state,
+        const StateNd<T, N>& previous_desired_state,
+        const StateNd<T, N>& target_state,
+        const o80::Duration_us& duration) const;
+
+    /* ! uses linear interpolation to compute the desired state
+     *   at TimePoint "now" provided the iteration command. */
+    StateNd<T, N> intermediate_state(
+        long int start_iteration,
+        long int current_iteration,
+        const StateNd<T, N>& start_state,
+        const StateNd<T, N>& current_state,
+        const StateNd<T, N>& previous_desired_state,
+        const StateNd<T, N>& target_state,
+        const o80::Iteration& iteration) const;
+
+    double to_duration(double speed, const StateNd<T, N>& target_state) const;
+
+    // for binary archives, cereal serializes arrays of arithmetic
+    // types as a single block
+    template <class Archive>
+    void serialize(Archive& archive)
+    {
+        archive(values);
+    }
+
+public:
+    alignas(alignment) std::array<T, N> values;
+
+private:
+    // interpolation of all the attributes at ratio (0: start_state,
+    // 1: target_state)
+    static StateNd<T, N> interpolate(const StateNd<T, N>& start_state,
+                                     const StateNd<T, N>& target_state,
+                                     double ratio);
+};
+
+#include "statend.hxx"
+
+}  // namespace o80
@@ -0,0 +1,176 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#define TEMPLATE_STATEND template <typename T, int N>
+#define STATEND StateNd<T, N>
+
+TEMPLATE_STATEND
+STATEND::StateNd()
+{
+    values.fill(static_cast<T>(0));
+}
+
+TEMPLATE_STATEND
+STATEND::StateNd(const std::array<T, N>& init) : values(init)
+{
+}
+
+TEMPLATE_STATEND
+T STATEND::get(int index) const
+{
+    return values[index];
+}
+
+TEMPLATE_STATEND
+void STATEND::set(int index, T value)
+{
+    values[index] = value;
+}
+
+TEMPLATE_STATEND
+std::string STATEND::to_string() const
+{
+    std::string s;
+    for (int index = 0; index < N; index++)
+    {
+        s += std::to_string(values[index]);
+        s += std::string(" ");
+    }
+    return s;
+}
+
+TEMPLATE_STATEND
+STATEND STATEND::interpolate(const StateNd<T, N>& start_state,
+                             const StateNd<T, N>& target_state,
+                             double ratio)
+{
+    // no branch and no dependency between the attributes:
+    // the loop may be unrolled and vectorized
+    StateNd<T, N> interpolated;
+    for (int index = 0; index < N; index++)
+    {
+        interpolated.values[index] = static_cast<T>(
+            static_cast<double>(start_state.values[index]) +
+            ratio * static_cast<double>(target_state.values[index] -
+                                        start_state.values[index]));
+    }
+    return interpolated;
+}
+
+TEMPLATE_STATEND
+bool STATEND::finished(const o80::TimePoint& start,
+                       const o80::TimePoint& now,
+                       const StateNd<T, N>& start_state,
+                       const StateNd<T, N>& current_state,
+                       const StateNd<T, N>& previous_desired_state,
+                       const StateNd<T, N>& target_state,
+                       const o80::Speed& speed) const
+{
+    (void)(current_state);
+    (void)(previous_desired_state);
+    double value_diff = fabs(static_cast<double>(target_state.values[0]) -
+                             static_cast<double>(start_state.values[0]));
+    double duration_us = value_diff / speed.value;
+    long int expected_end =
+        std::chrono::duration_cast<Microseconds>(start).count() + duration_us;
+    return std::chrono::duration_cast<Microseconds>(now).count() >
+           expected_end;
+}
+
+TEMPLATE_STATEND
+STATEND STATEND::intermediate_state(
+    const o80::TimePoint& start,
+    const o80::TimePoint& now,
+    const StateNd<T, N>& start_state,
+    const StateNd<T, N>& current_state,
+    const StateNd<T, N>& previous_desired_state,
+    const StateNd<T, N>& target_state,
+    const o80::Speed& speed) const
+{
+    // duration required by the first attribute at this speed,
+    // applied to all the attributes
+    double init = static_cast<double>(start_state.values[0]);
+    double end = static_cast<double>(target_state.values[0]);
+    o80::Duration_us duration(
+        static_cast<long int>(fabs(end - init) / speed.value + 0.5));
+    StateNd<T, N> interpolated =
+        intermediate_state(start,
+                           now,
+                           start_state,
+                           current_state,
+                           previous_desired_state,
+                           target_state,
+                           duration);
+
+    // the first attribute moves at the requested speed
+    double time_diff = static_cast<double>(time_diff_us(start, now));
+    double desired;
+    if (end - init > 0)
+    {
+        desired = init + static_cast<double>(speed.value) * time_diff;
+        interpolated.values[0] =
+            desired > end ? target_state.values[0] : static_cast<T>(desired);
+    }
+    else
+    {
+        desired = init - static_cast<double>(speed.value) * time_diff;
+        interpolated.values[0] =
+            desired < end ? target_state.values[0] : static_cast<T>(desired);
+    }
+    return interpolated;
+}
+
+TEMPLATE_STATEND
+STATEND STATEND::intermediate_state(
+    const o80::TimePoint& start,
+    const o80::TimePoint& now,
+    const StateNd<T, N>& start_state,
+    const StateNd<T, N>& current_state,
+    const StateNd<T, N>& previous_desired_state,
+    const StateNd<T, N>& target_state,
+    const o80::Duration_us& duration) const
+{
+    (void)(current_state);
+    (void)(previous_desired_state);
+    long int passed = o80::time_diff_us(start, now);
+    if (passed > duration.value || duration.value <= 0)
+    {
+        return target_state;
+    }
+    double ratio =
+        static_cast<double>(passed) / static_cast<double>(duration.value);
+    return interpolate(start_state, target_state, ratio);
+}
+
+TEMPLATE_STATEND
+STATEND STATEND::intermediate_state(
+    long int start_iteration,
+    long int current_iteration,
+    const StateNd<T, N>& start_state,
+    const StateNd<T, N>& current_state,
+    const StateNd<T, N>& previous_desired_state,
+    const StateNd<T, N>& target_state,
+    const o80::Iteration& iteration) const
+{
+    (void)(current_state);
+    (void)(previous_desired_state);
+    if (current_iteration >= iteration.value)
+    {
+        return target_state;
+    }
+    current_iteration++;
+    int total_iteration = iteration.value - start_iteration;
+    int diff_iteration = current_iteration - start_iteration;
+    double ratio = static_cast<double>(diff_iteration) /
+                   static_cast<double>(total_iteration);
+    return interpolate(start_state, target_state, ratio);
+}
+
+TEMPLATE_STATEND
+double STATEND::to_duration(double speed,
+                            const StateNd<T, N>& target_state) const
+{
+    return fabs(static_cast<double>(target_state.values[0]) -
+                static_cast<double>(values[0])) /
+           speed;
+}
@@ -0,0 +1,98 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include <atomic>
+#include <random>
+#include <string>
+#include <vector>
+#include "o80/driver.hpp"
+
+namespace o80
+{
+/*! distribution of the jitter added to the cost of the get and
+    set methods of SyntheticDriver*/
+enum JitterDistribution
+{
+    NO_JITTER,
+    // uniform in [-jitter_us, jitter_us]
+    UNIFORM_JITTER,
+    // normal, of standard deviation jitter_us
+    NORMAL_JITTER,
+    // exponential, of mean jitter_us (always delays)
+    EXPONENTIAL_JITTER
+};
+
+/**
+ * ! Configuration of SyntheticDriver. Costs are in microseconds.
+ */
+class SyntheticDriverConfig
+{
+public:
+    SyntheticDriverConfig();
+
+    std::string to_string() const;
+
+public:
+    /*! time spent in each call to get (default: 0)*/
+    double get_us;
+    /*! time spent in each call to set (default: 0)*/
+    double set_us;
+    /*! distribution of the jitter added to get_us and set_us
+        (default: NO_JITTER)*/
+    JitterDistribution jitter;
+    /*! scale of the jitter (see JitterDistribution, default: 0)*/
+    double jitter_us;
+    /*! probability for a call to get or set to stall
+        (default: 0)*/
+    double stall_probability;
+    /*! duration of a stall (default: 0)*/
+    double stall_us;
+    /*! if true, the costs are spent busy waiting (accurate, but uses a
+        cpu), otherwise sleeping (default: false)*/
+    bool busy_wait;
+    /*! seed of the random generator (default: 0)*/
+    unsigned int seed;
+};
+
+/**
+ * ! Driver without hardware, for measuring the overhead of o80 and its
+ *   behavior when the driver is slow or irregular (see
+ *   SyntheticStandalone). The values passed to set are returned by
+ *   the following calls to get (i.e. the "robot" reaches the desired
+ *   states instantly). Each call to get and set lasts the configured
+ *   cost, plus a random jitter, plus (occasionally) a stall.
+ */
+class SyntheticDriver : public Driver<std::vector<double>, std::vector<double>>
+{
+public:
+    SyntheticDriver(SyntheticDriverConfig config = SyntheticDriverConfig());
+
+    void start();
+    void stop();
+    void set(const std::vector<double>& values);
+    std::vector<double> get();
+
+    const SyntheticDriverConfig& get_config() const;
+
+    long int nb_gets() const;
+    long int nb_sets() const;
+    long int nb_stalls() const;
+
+private:
+    // spends cost_us, plus jitter and stall
+    void spend(double cost_us);
+
+private:
+    SyntheticDriverConfig config_;
+    std::vector<double> values_;
+    std::mt19937 generator_;
+    std::uniform_real_distribution<double> uniform_;
+    std::normal_distribution<double> normal_;
+    std::exponential_distribution<double> exponential_;
+    std::atomic<long int> nb_gets_;
+    std::atomic<long int> nb_sets_;
+    std::atomic<long int> nb_stalls_;
+};
+}  // namespace o80
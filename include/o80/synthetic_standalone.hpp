@@ -0,0 +1,67 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include "o80/standalone.hpp"
+#include "o80/state1d.hpp"
+#include "o80/synthetic_driver.hpp"
+#include "o80/void_extended_state.hpp"
+
+namespace o80
+{
+/**
+ * ! Standalone running a SyntheticDriver, with NB_ACTUATORS actuators
+ *   of State1d. Values missing from the observations of the driver
+ *   (i.e. before the first call to set) are 0.
+ */
+template <int QUEUE_SIZE, int NB_ACTUATORS>
+class SyntheticStandalone : public Standalone<QUEUE_SIZE,
+                                              NB_ACTUATORS,
+                                              SyntheticDriver,
+                                              State1d,
+                                              VoidExtendedState>
+{
+public:
+    SyntheticStandalone(std::shared_ptr<SyntheticDriver> driver_ptr,
+                        double frequency,
+                        std::string segment_id,
+                        TransportType transport = SHARED_MEMORY)
+        : Standalone<QUEUE_SIZE,
+                     NB_ACTUATORS,
+                     SyntheticDriver,
+                     State1d,
+                     VoidExtendedState>(
+              driver_ptr, frequency, segment_id, transport)
+    {
+    }
+
+    States<NB_ACTUATORS, State1d> convert(const std::vector<double>& values)
+    {
+        States<NB_ACTUATORS, State1d> states;
+        for (int dof = 0; dof < NB_ACTUATORS; dof++)
+        {
+            if (dof < static_cast<int>(values.size()))
+            {
+                states.values[dof].value = values[dof];
+            }
+            else
+            {
+                states.values[dof].value = 0;
+            }
+        }
+        return states;
+    }
+
+    std::vector<double> convert(const States<NB_ACTUATORS, State1d>& states)
+    {
+        std::vector<double> values(NB_ACTUATORS);
+        for (int dof = 0; dof < NB_ACTUATORS; dof++)
+        {
+            values[dof] = states.values[dof].value;
+        }
+        return values;
+    }
+};
+
+}  // namespace o80
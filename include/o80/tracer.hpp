@@ -0,0 +1,100 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "o80/logger.hpp"
+
+namespace o80
+{
+/*! written by Tracer for each traced action (16 bytes)*/
+struct TraceRecord
+{
+    // time stamp counter of the cpu (or steady clock nanoseconds
+    // on architectures without time stamp counter)
+    std::uint64_t tsc;
+    // see Tracer::register_segment
+    std::uint32_t segment;
+    // a LogAction
+    std::uint16_t action;
+    // index of the thread in the process
+    std::uint16_t thread;
+};
+
+/**
+ * ! Low overhead tracer of the activity of the frontends and backends
+ *   of a process (see LogAction). While the tracer runs, each thread
+ *   writes fixed size records (see TraceRecord) into its own lock free
+ *   ring (no system call, no allocation except for the first record of a
+ *   thread). A drain thread periodically moves the records to a memory
+ *   mapped file, so traces are available even if the process crashes.
+ *   The files of several processes (e.g. a standalone and a python script
+ *   running frontends) can be merged into a single Chrome / Perfetto
+ *   trace (see export_chrome_trace), aligned on the steady clock.
+ *   When the tracer does not run, tracing costs a single atomic load.
+ */
+class Tracer
+{
+public:
+    /**
+     * Starts tracing the activity of this process (if not already
+     * started). Throws a runtime_error if the file can not be created.
+     * @param path file the records are written to
+     * @param ring_size capacity (in records) of the ring of each thread.
+     *        Records are dropped if a ring is full (see nb_dropped)
+     * @param period_ms period at which the rings are drained
+     */
+    static void start(const std::string& path,
+                      std::size_t ring_size = 65536,
+                      double period_ms = 10);
+
+    /*! drains the rings a last time and closes the file*/
+    static void stop();
+
+    static bool is_running();
+
+    /*! number of records written to the file since start*/
+    static long int nb_records();
+
+    /*! number of records dropped because a ring was full
+        (or because the file could not be grown)*/
+    static long int nb_dropped();
+
+    /*! hash of the segment id used in the records. The name of the
+        segments registered are written to the file (max 64 segments
+        per process).*/
+    static std::uint32_t register_segment(const std::string& segment_id);
+
+    /*! records the action (if the tracer is running)*/
+    static void trace(std::uint32_t segment, LogAction action)
+    {
+        if (running_.load(std::memory_order_relaxed))
+        {
+            record(segment, action);
+        }
+    }
+
+    /**
+     * Writes a Chrome trace event file (JSON, which can be opened in
+     * chrome://tracing or https://ui.perfetto.dev) merging the files
+     * written by the tracers of one or several processes. Waits (e.g.
+     * FRONTEND_WAIT_START / FRONTEND_WAIT_END) and backend iterations
+     * (BACKEND_READ to BACKEND_WRITE_*) are exported as slices, the other
+     * actions as instant events. Returns the number of events exported.
+     * Throws a runtime_error if a file can not be read.
+     */
+    static long int export_chrome_trace(const std::vector<std::string>& paths,
+                                        const std::string& json_path);
+
+    static std::string action_name(LogAction action);
+
+private:
+    static void record(std::uint32_t segment, LogAction action);
+    static std::atomic<bool> running_;
+};
+
+}  // namespace o80
@@ -0,0 +1,470 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include "o80/burster.hpp"
+#include "o80/command_trace.hpp"
+#include "o80/observation.hpp"
+#include "o80/real_time_config.hpp"
+#include "o80/segment_layout.hpp"
+#include "o80/states.hpp"
+#include "o80_internal/command.hpp"
+#include "o80_internal/region_time_series.hpp"
+#include "o80_internal/segment_owner.hpp"
+#include "o80_internal/shared_region.hpp"
+#include "shared_memory/shared_memory.hpp"
+#include "time_series/multiprocess_time_series.hpp"
+#include "time_series/time_series.hpp"
+
+namespace o80
+{
+/**
+ * ! How instances of BackEnd and FrontEnd of the same segment_id
+ *   exchange commands and observations.
+ * - shared memory : (serialized) multiprocess time series and
+ *                   shared memory segments. The backend and the frontends
+ *                   may run in different processes.
+ * - in process : (non serialized) time series hosted in the memory of the
+ *                process, and condition variables for bursting. The backend
+ *                and the frontends must run in the same process.
+ * - shared region : (serialized) time series and control data hosted by
+ *                   a single shared memory region. The backend and the
+ *                   frontends may run in different processes.
+ */
+enum TransportType
+{
+    SHARED_MEMORY,
+    IN_PROCESS,
+    SHARED_REGION
+};
+
+/**
+ * ! Interface to the channels used by FrontEnd, BackEnd and ControllersManager
+ *   for exchanging commands and the related control data (pulse id,
+ *   commands read by the backend, purge requests, bursting).
+ *   @tparam STATE class encapsulating the state of an actuator
+ */
+template <class STATE>
+class CommandsTransport
+{
+public:
+    typedef time_series::TimeSeriesInterface<Command<STATE>>
+        CommandsTimeSeries;
+    typedef time_series::TimeSeriesInterface<int> CompletedCommandsTimeSeries;
+
+public:
+    virtual ~CommandsTransport()
+    {
+    }
+
+    /*! capacities of the time series*/
+    virtual const SegmentLayout& get_layout() = 0;
+
+    /*! commands shared by the frontend, executed by the backend*/
+    virtual CommandsTimeSeries& commands() = 0;
+    /*! ids of the commands completed by the backend*/
+    virtual CompletedCommandsTimeSeries& completed() = 0;
+    /*! ids of the commands a frontend waits completion of
+        (debug and introspection, nullptr if disabled by the layout)*/
+    virtual CompletedCommandsTimeSeries* waiting_for_completion() = 0;
+    /*! ids of the commands a frontend reported completion of
+        (debug and introspection, nullptr if disabled by the layout)*/
+    virtual CompletedCommandsTimeSeries* completion_reported() = 0;
+    /*! ids of the commands received by the backend
+        (debug and introspection, nullptr if disabled by the layout)*/
+    virtual CompletedCommandsTimeSeries* received() = 0;
+    /*! ids of the commands started by the backend
+        (debug and introspection, nullptr if disabled by the layout)*/
+    virtual CompletedCommandsTimeSeries* starting() = 0;
+    /*! time stamped lifecycle events of the commands, written by the
+        frontends and the backend (nullptr if disabled by the layout)*/
+    virtual TracesTimeSeries* traces() = 0;
+
+    /*! id of the latest batch of commands shared by a frontend*/
+    virtual long int get_pulse_id() = 0;
+    virtual void set_pulse_id(long int pulse_id) = 0;
+
+    /*! index of the next command the backend will read*/
+    virtual time_series::Index get_command_read() = 0;
+    virtual void set_command_read(time_series::Index index) = 0;
+
+    /*! true if a frontend requested the purge of all commands*/
+    virtual bool get_purge() = 0;
+    virtual void set_purge(bool purge) = 0;
+
+    /*! true if at least one command was active during the
+        latest iteration of the backend*/
+    virtual bool get_active() = 0;
+    virtual void set_active(bool active) = 0;
+
+    /*! (frontend side) requests the standalone to perform nb_iterations
+        iterations, and returns once they have been performed*/
+    virtual void burst(int nb_iterations) = 0;
+    /*! (frontend side) requests the standalone to exit the bursting mode*/
+    virtual void final_burst() = 0;
+    /*! (standalone side) returns the number of iterations requested by the
+        latest call to burst, and resets it to zero*/
+    virtual long int get_bursting() = 0;
+    /*! (standalone side) resets the number of requested iterations*/
+    virtual void reset_bursting() = 0;
+    /*! (standalone side) reports the requested iterations have been performed,
+        and waits for the next call to burst*/
+    virtual bool wait_for_burst() = 0;
+
+    /*! (frontend side) true if the backend this transport is attached to
+        stopped, or has been replaced by a new backend (e.g. after a crash).
+        The frontend should then create a new transport.*/
+    virtual bool is_retired() = 0;
+};
+
+/**
+ * ! Channels used by FrontEnd and BackEnd for exchanging commands
+ *   and observations. Instances are created via the "create" factory,
+ *   either as leader (backend side) or as follower (frontend side).
+ *   @tparam NB_ACTUATORS number of actuators of the robot
+ *   @tparam STATE class encapsulating the state of an actuator
+ *   @tparam EXTENDED_STATE class encapsulating supplementary
+ *           arbitrary information
+ */
+template <int NB_ACTUATORS, class STATE, class EXTENDED_STATE>
+class Transport : public CommandsTransport<STATE>
+{
+public:
+    typedef time_series::TimeSeriesInterface<
+        Observation<NB_ACTUATORS, STATE, EXTENDED_STATE>>
+        ObservationsTimeSeries;
+    typedef std::shared_ptr<Transport<NB_ACTUATORS, STATE, EXTENDED_STATE>>
+        TransportPtr;
+
+public:
+    /*! observations written by the backend, read by the frontends*/
+    virtual ObservationsTimeSeries& observations() = 0;
+
+    /*! first states observed by the backend*/
+    virtual void set_initial_states(
+        const States<NB_ACTUATORS, STATE>& initial_states) = 0;
+    virtual void get_initial_states(
+        States<NB_ACTUATORS, STATE>& initial_states) = 0;
+
+public:
+    /**
+     * @param segment_id id shared by the backend and the frontends
+     * @param transport_type shared memory, in process or shared region
+     * @param leader true for the backend (creates the channels), false
+     *        for the frontends (attach to existing channels)
+     * @param layout capacities of the time series (ignored for followers,
+     *        which read the layout set by the leader)
+     */
+    static TransportPtr create(std::string segment_id,
+                               TransportType transport_type,
+                               bool leader,
+                               const SegmentLayout& layout);
+};
+
+/**
+ * ! Transport based on multiprocess time series and
+ *   shared memory segments. Leaders create all the time series
+ *   at construction, followers attach to them on first access.
+ */
+template <int NB_ACTUATORS, class STATE, class EXTENDED_STATE>
+class SharedMemoryTransport
+    : public Transport<NB_ACTUATORS, STATE, EXTENDED_STATE>
+{
+public:
+    typedef time_series::MultiprocessTimeSeries<Command<STATE>>
+        MultiprocessCommands;
+    typedef time_series::MultiprocessTimeSeries<int> MultiprocessCompleted;
+    typedef time_series::MultiprocessTimeSeries<CommandTrace>
+        MultiprocessTraces;
+    typedef time_series::MultiprocessTimeSeries<
+        Observation<NB_ACTUATORS, STATE, EXTENDED_STATE>>
+        MultiprocessObservations;
+
+public:
+    /*! generation: (leader only) see internal::reclaim_segment*/
+    SharedMemoryTransport(std::string segment_id,
+                          bool leader,
+                          const SegmentLayout& layout,
+                          std::uint64_t generation);
+
+    const SegmentLayout& get_layout();
+    typename CommandsTransport<STATE>::CommandsTimeSeries& commands();
+    typename CommandsTransport<STATE>::CompletedCommandsTimeSeries& completed();
+    typename CommandsTransport<STATE>::CompletedCommandsTimeSeries*
+    waiting_for_completion();
+    typename CommandsTransport<STATE>::CompletedCommandsTimeSeries*
+    completion_reported();
+    typename CommandsTransport<STATE>::CompletedCommandsTimeSeries* received();
+    typename CommandsTransport<STATE>::CompletedCommandsTimeSeries* starting();
+    TracesTimeSeries* traces();
+    typename Transport<NB_ACTUATORS, STATE, EXTENDED_STATE>::
+        ObservationsTimeSeries&
+        observations();
+
+    long int get_pulse_id();
+    void set_pulse_id(long int pulse_id);
+    time_series::Index get_command_read();
+    void set_command_read(time_series::Index index);
+    bool get_purge();
+    void set_purge(bool purge);
+    bool get_active();
+    void set_active(bool active);
+    void set_initial_states(const States<NB_ACTUATORS, STATE>& initial_states);
+    void get_initial_states(States<NB_ACTUATORS, STATE>& initial_states);
+
+    void burst(int nb_iterations);
+    void final_burst();
+    long int get_bursting();
+    void reset_bursting();
+    bool wait_for_burst();
+
+    bool is_retired();
+
+private:
+    // create (leader) or attach to (follower) the time series
+    // segment_id+suffix, unless already done
+    template <class TS>
+    TS& attach(std::shared_ptr<TS>& time_series,
+               const std::string& suffix,
+               std::size_t size);
+
+    // same as above for the introspection time series, returns
+    // nullptr if disabled by the layout
+    MultiprocessCompleted* attach_introspection(
+        std::shared_ptr<MultiprocessCompleted>& time_series,
+        const std::string& suffix);
+
+private:
+    std::string segment_id_;
+    bool leader_;
+    SegmentLayout layout_;
+    std::unique_ptr<internal::SegmentOwner> owner_;
+    std::shared_ptr<MultiprocessCommands> commands_;
+    std::shared_ptr<MultiprocessObservations> observations_;
+    std::shared_ptr<MultiprocessCompleted> completed_;
+    std::shared_ptr<MultiprocessCompleted> waiting_for_completion_;
+    std::shared_ptr<MultiprocessCompleted> completion_reported_;
+    std::shared_ptr<MultiprocessCompleted> received_;
+    std::shared_ptr<MultiprocessCompleted> starting_;
+    std::shared_ptr<MultiprocessTraces> traces_;
+    // bursting, frontend side
+    std::shared_ptr<BursterClient> burster_client_;
+    // bursting, standalone side
+    std::shared_ptr<Burster> burster_;
+};
+
+/**
+ * ! Transport based on a single shared memory region (see
+ *   internal::SharedRegion) hosting all the time series and the control
+ *   data. Compared to SharedMemoryTransport, attaching maps a single
+ *   segment, and bursting does not require a synchronizer.
+ */
+template <int NB_ACTUATORS, class STATE, class EXTENDED_STATE>
+class SharedRegionTransport
+    : public Transport<NB_ACTUATORS, STATE, EXTENDED_STATE>
+{
+public:
+    typedef internal::RegionTimeSeries<Command<STATE>> RegionCommands;
+    typedef internal::RegionTimeSeries<int> RegionCompleted;
+    typedef internal::RegionTimeSeries<CommandTrace> RegionTraces;
+    typedef internal::RegionTimeSeries<
+        Observation<NB_ACTUATORS, STATE, EXTENDED_STATE>>
+        RegionObservations;
+
+public:
+    /*! generation: (leader only) see internal::reclaim_segment*/
+    SharedRegionTransport(std::string segment_id,
+                          bool leader,
+                          const SegmentLayout& layout,
+                          std::uint64_t generation);
+
+    const SegmentLayout& get_layout();
+    typename CommandsTransport<STATE>::CommandsTimeSeries& commands();
+    typename CommandsTransport<STATE>::CompletedCommandsTimeSeries& completed();
+    typename CommandsTransport<STATE>::CompletedCommandsTimeSeries*
+    waiting_for_completion();
+    typename CommandsTransport<STATE>::CompletedCommandsTimeSeries*
+    completion_reported();
+    typename CommandsTransport<STATE>::CompletedCommandsTimeSeries* received();
+    typename CommandsTransport<STATE>::CompletedCommandsTimeSeries* starting();
+    TracesTimeSeries* traces();
+    typename Transport<NB_ACTUATORS, STATE, EXTENDED_STATE>::
+        ObservationsTimeSeries&
+        observations();
+
+    long int get_pulse_id();
+    void set_pulse_id(long int pulse_id);
+    time_series::Index get_command_read();
+    void set_command_read(time_series::Index index);
+    bool get_purge();
+    void set_purge(bool purge);
+    bool get_active();
+    void set_active(bool active);
+    void set_initial_states(const States<NB_ACTUATORS, STATE>& initial_states);
+    void get_initial_states(States<NB_ACTUATORS, STATE>& initial_states);
+
+    void burst(int nb_iterations);
+    void final_burst();
+    long int get_bursting();
+    void reset_bursting();
+    bool wait_for_burst();
+
+    bool is_retired();
+
+    /*! the region hosting the time series*/
+    const internal::SharedRegion& get_region() const;
+
+private:
+    typedef std::unique_ptr<RegionCompleted> IntrospectionPtr;
+    static std::shared_ptr<internal::SharedRegion> create_region(
+        const std::string& segment_id,
+        bool leader,
+        const SegmentLayout& layout,
+        std::uint64_t generation);
+    // nullptr if introspection is disabled by the layout
+    IntrospectionPtr create_introspection(internal::RegionRing ring) const;
+
+private:
+    std::shared_ptr<internal::SharedRegion> region_;
+    RegionCommands commands_;
+    RegionObservations observations_;
+    RegionCompleted completed_;
+    IntrospectionPtr waiting_for_completion_;
+    IntrospectionPtr completion_reported_;
+    IntrospectionPtr received_;
+    IntrospectionPtr starting_;
+    // nullptr if traces are disabled by the layout
+    std::unique_ptr<RegionTraces> traces_;
+};
+
+namespace internal
+{
+/**
+ * ! Non templated part of InProcessTransport: synchronization
+ *   of bursting between a frontend and a standalone running in the
+ *   same process.
+ */
+class InProcessSegment
+{
+public:
+    InProcessSegment();
+    virtual ~InProcessSegment();
+
+    void burst(int nb_iterations);
+    void final_burst();
+    long int get_bursting();
+    void reset_bursting();
+    bool wait_for_burst();
+
+    /*! unblocks the standalone and the frontends waiting for bursts*/
+    void release();
+
+    /*! called when the segment is unregistered, see
+        CommandsTransport::is_retired*/
+    void retire();
+    bool retired() const;
+
+private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    long int nb_iterations_;
+    long int requested_;
+    long int done_;
+    bool released_;
+    std::atomic<bool> retired_;
+};
+
+/*! registers the (backend side) transport of the segment_id, so that
+    frontends of the same process may attach to it. Throws a runtime_error
+    if a transport of the same segment_id is already registered.*/
+void register_in_process_segment(const std::string& segment_id,
+                                 std::shared_ptr<InProcessSegment> segment);
+/*! returns the transport registered for this segment_id,
+    or nullptr if none*/
+std::shared_ptr<InProcessSegment> get_in_process_segment(
+    const std::string& segment_id);
+void unregister_in_process_segment(const std::string& segment_id);
+/*! releases the bursting standalone of the segment_id, if any*/
+void release_in_process_segment(const std::string& segment_id);
+}  // namespace internal
+
+/**
+ * ! Transport based on (non serialized) time series living in the
+ *   process memory. Frontends attach to the transport created by the
+ *   backend of the same segment_id, so both have to run in the same process.
+ */
+template <int NB_ACTUATORS, class STATE, class EXTENDED_STATE>
+class InProcessTransport : public Transport<NB_ACTUATORS, STATE, EXTENDED_STATE>,
+                           public internal::InProcessSegment
+{
+public:
+    InProcessTransport(const SegmentLayout& layout);
+
+    const SegmentLayout& get_layout();
+    typename CommandsTransport<STATE>::CommandsTimeSeries& commands();
+    typename CommandsTransport<STATE>::CompletedCommandsTimeSeries& completed();
+    typename CommandsTransport<STATE>::CompletedCommandsTimeSeries*
+    waiting_for_completion();
+    typename CommandsTransport<STATE>::CompletedCommandsTimeSeries*
+    completion_reported();
+    typename CommandsTransport<STATE>::CompletedCommandsTimeSeries* received();
+    typename CommandsTransport<STATE>::CompletedCommandsTimeSeries* starting();
+    TracesTimeSeries* traces();
+    typename Transport<NB_ACTUATORS, STATE, EXTENDED_STATE>::
+        ObservationsTimeSeries&
+        observations();
+
+    long int get_pulse_id();
+    void set_pulse_id(long int pulse_id);
+    time_series::Index get_command_read();
+    void set_command_read(time_series::Index index);
+    bool get_purge();
+    void set_purge(bool purge);
+    bool get_active();
+    void set_active(bool active);
+    void set_initial_states(const States<NB_ACTUATORS, STATE>& initial_states);
+    void get_initial_states(States<NB_ACTUATORS, STATE>& initial_states);
+
+    void burst(int nb_iterations);
+    void final_burst();
+    long int get_bursting();
+    void reset_bursting();
+    bool wait_for_burst();
+
+    bool is_retired();
+
+private:
+    typedef std::unique_ptr<time_series::TimeSeries<int>> IntrospectionPtr;
+    // nullptr if introspection is disabled by the layout
+    IntrospectionPtr create_introspection() const;
+
+private:
+    SegmentLayout layout_;
+    time_series::TimeSeries<Command<STATE>> commands_;
+    time_series::TimeSeries<Observation<NB_ACTUATORS, STATE, EXTENDED_STATE>>
+        observations_;
+    time_series::TimeSeries<int> completed_;
+    IntrospectionPtr waiting_for_completion_;
+    IntrospectionPtr completion_reported_;
+    IntrospectionPtr received_;
+    IntrospectionPtr starting_;
+    // nullptr if traces are disabled by the layout
+    std::unique_ptr<time_series::TimeSeries<CommandTrace>> traces_;
+    std::atomic<long int> pulse_id_;
+    std::atomic<time_series::Index> command_read_;
+    std::atomic<bool> purge_;
+    std::atomic<bool> active_;
+    std::mutex initial_states_mutex_;
+    States<NB_ACTUATORS, STATE> initial_states_;
+};
+
+#include "transport.hxx"
+
+}  // namespace o80
@@ -0,0 +1,753 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#define TEMPLATE_TRANSPORT \
+    template <int NB_ACTUATORS, class STATE, class EXTENDED_STATE>
+
+#define TRANSPORT Transport<NB_ACTUATORS, STATE, EXTENDED_STATE>
+#define SM_TRANSPORT SharedMemoryTransport<NB_ACTUATORS, STATE, EXTENDED_STATE>
+#define IP_TRANSPORT InProcessTransport<NB_ACTUATORS, STATE, EXTENDED_STATE>
+#define SR_TRANSPORT \
+    SharedRegionTransport<NB_ACTUATORS, STATE, EXTENDED_STATE>
+
+#define COMMANDS_TS typename CommandsTransport<STATE>::CommandsTimeSeries
+#define COMPLETED_TS \
+    typename CommandsTransport<STATE>::CompletedCommandsTimeSeries
+#define OBSERVATIONS_TS typename TRANSPORT::ObservationsTimeSeries
+
+TEMPLATE_TRANSPORT
+typename TRANSPORT::TransportPtr TRANSPORT::create(std::string segment_id,
+                                                   TransportType transport_type,
+                                                   bool leader,
+                                                   const SegmentLayout& layout)
+{
+    // backend side: checking the previous backend of the same segment id
+    // (if any) is not running anymore, and clearing its segment.
+    // In process segments are not shared between processes, but
+    // the standalone running their backend uses the shared memory.
+    if (leader)
+    {
+        layout.check();
+        // the memory of the shared memory transport is allocated by the
+        // shared_memory package, which does not support huge pages
+        if (layout.huge_pages && transport_type != SHARED_REGION)
+        {
+            throw std::invalid_argument(
+                "o80 segment layout: huge pages are supported only by "
+                "the shared region transport");
+        }
+        if (layout.prefault && transport_type == IN_PROCESS)
+        {
+            throw std::invalid_argument(
+                "o80 segment layout: prefault is not supported by "
+                "the in process transport");
+        }
+    }
+    std::uint64_t generation = 0;
+    if (leader && (transport_type != IN_PROCESS ||
+                   internal::get_in_process_segment(segment_id) == nullptr))
+    {
+        generation = internal::reclaim_segment(segment_id);
+    }
+
+    if (transport_type == SHARED_MEMORY)
+    {
+        return std::make_shared<SM_TRANSPORT>(
+            segment_id, leader, layout, generation);
+    }
+
+    if (transport_type == SHARED_REGION)
+    {
+        return std::make_shared<SR_TRANSPORT>(
+            segment_id, leader, layout, generation);
+    }
+
+    if (leader)
+    {
+        std::shared_ptr<IP_TRANSPORT> transport =
+            std::make_shared<IP_TRANSPORT>(layout);
+        internal::register_in_process_segment(segment_id, transport);
+        return transport;
+    }
+
+    std::shared_ptr<IP_TRANSPORT> transport =
+        std::dynamic_pointer_cast<IP_TRANSPORT>(
+            internal::get_in_process_segment(segment_id));
+    if (transport == nullptr)
+    {
+        std::string error("o80: no in process backend of segment id ");
+        error += segment_id;
+        error += std::string(
+            " (with matching number of actuators, state and extended state) "
+            "is running in this process");
+        throw std::runtime_error(error);
+    }
+    return transport;
+}
+
+// -------------------- shared memory transport -------------------- //
+
+TEMPLATE_TRANSPORT
+SM_TRANSPORT::SharedMemoryTransport(std::string segment_id,
+                                    bool leader,
+                                    const SegmentLayout& layout,
+                                    std::uint64_t generation)
+    : segment_id_(segment_id),
+      leader_(leader),
+      layout_(layout),
+      burster_client_(nullptr),
+      burster_(nullptr)
+{
+    if (leader_)
+    {
+        owner_.reset(new internal::SegmentOwner(segment_id_, generation));
+        // for the frontends to discover the layout
+        shared_memory::serialize(segment_id_, "layout", layout_);
+        commands();
+        observations();
+        completed();
+        waiting_for_completion();
+        completion_reported();
+        received();
+        starting();
+        traces();
+        if (layout_.prefault)
+        {
+            RealTimeConfig::touch_segment_pages(segment_id_, true);
+        }
+    }
+    else
+    {
+        // throws if no backend is running
+        owner_.reset(new internal::SegmentOwner(segment_id_));
+        shared_memory::deserialize(segment_id_, "layout", layout_);
+    }
+}
+
+TEMPLATE_TRANSPORT
+template <class TS>
+TS& SM_TRANSPORT::attach(std::shared_ptr<TS>& time_series,
+                         const std::string& suffix,
+                         std::size_t size)
+{
+    if (time_series == nullptr)
+    {
+        if (leader_)
+        {
+            time_series = TS::create_leader_ptr(segment_id_ + suffix, size);
+        }
+        else
+        {
+            time_series = TS::create_follower_ptr(segment_id_ + suffix);
+        }
+    }
+    return *time_series;
+}
+
+TEMPLATE_TRANSPORT
+typename SM_TRANSPORT::MultiprocessCompleted*
+SM_TRANSPORT::attach_introspection(
+    std::shared_ptr<MultiprocessCompleted>& time_series,
+    const std::string& suffix)
+{
+    if (!layout_.has_introspection())
+    {
+        return nullptr;
+    }
+    return &attach(time_series, suffix, layout_.introspection_size);
+}
+
+TEMPLATE_TRANSPORT
+const SegmentLayout& SM_TRANSPORT::get_layout()
+{
+    return layout_;
+}
+
+TEMPLATE_TRANSPORT
+COMMANDS_TS& SM_TRANSPORT::commands()
+{
+    return attach(commands_, "_commands", layout_.commands_size);
+}
+
+TEMPLATE_TRANSPORT
+OBSERVATIONS_TS& SM_TRANSPORT::observations()
+{
+    return attach(observations_, "_observations", layout_.observations_size);
+}
+
+TEMPLATE_TRANSPORT
+COMPLETED_TS& SM_TRANSPORT::completed()
+{
+    return attach(completed_, "_completed", layout_.completed_size);
+}
+
+TEMPLATE_TRANSPORT
+COMPLETED_TS* SM_TRANSPORT::waiting_for_completion()
+{
+    return attach_introspection(waiting_for_completion_,
+                                "_waiting_for_completion");
+}
+
+TEMPLATE_TRANSPORT
+COMPLETED_TS* SM_TRANSPORT::completion_reported()
+{
+    return attach_introspection(completion_reported_, "_completion_reported");
+}
+
+TEMPLATE_TRANSPORT
+COMPLETED_TS* SM_TRANSPORT::received()
+{
+    return attach_introspection(received_, "_received");
+}
+
+TEMPLATE_TRANSPORT
+COMPLETED_TS* SM_TRANSPORT::starting()
+{
+    return attach_introspection(starting_, "_starting");
+}
+
+TEMPLATE_TRANSPORT
+TracesTimeSeries* SM_TRANSPORT::traces()
+{
+    if (!layout_.has_traces())
+    {
+        return nullptr;
+    }
+    return &attach(traces_, "_traces", layout_.trace_size);
+}
+
+TEMPLATE_TRANSPORT
+long int SM_TRANSPORT::get_pulse_id()
+{
+    long int pulse_id;
+    shared_memory::get<long int>(segment_id_, "pulse_id", pulse_id);
+    return pulse_id;
+}
+
+TEMPLATE_TRANSPORT
+void SM_TRANSPORT::set_pulse_id(long int pulse_id)
+{
+    shared_memory::set<long int>(segment_id_, "pulse_id", pulse_id);
+}
+
+TEMPLATE_TRANSPORT
+time_series::Index SM_TRANSPORT::get_command_read()
+{
+    time_series::Index index;
+    shared_memory::get<time_series::Index>(segment_id_, "command_read", index);
+    return index;
+}
+
+TEMPLATE_TRANSPORT
+void SM_TRANSPORT::set_command_read(time_series::Index index)
+{
+    shared_memory::set<time_series::Index>(segment_id_, "command_read", index);
+}
+
+TEMPLATE_TRANSPORT
+bool SM_TRANSPORT::get_purge()
+{
+    bool purge;
+    shared_memory::get<bool>(segment_id_, "purge", purge);
+    return purge;
+}
+
+TEMPLATE_TRANSPORT
+void SM_TRANSPORT::set_purge(bool purge)
+{
+    shared_memory::set<bool>(segment_id_, "purge", purge);
+}
+
+TEMPLATE_TRANSPORT
+bool SM_TRANSPORT::get_active()
+{
+    bool active;
+    shared_memory::get<bool>(segment_id_, "active", active);
+    return active;
+}
+
+TEMPLATE_TRANSPORT
+void SM_TRANSPORT::set_active(bool active)
+{
+    shared_memory::set<bool>(segment_id_, "active", active);
+}
+
+TEMPLATE_TRANSPORT
+void SM_TRANSPORT::set_initial_states(
+    const States<NB_ACTUATORS, STATE>& initial_states)
+{
+    shared_memory::serialize(segment_id_, "initial_states", initial_states);
+}
+
+TEMPLATE_TRANSPORT
+void SM_TRANSPORT::get_initial_states(
+    States<NB_ACTUATORS, STATE>& initial_states)
+{
+    shared_memory::deserialize(segment_id_, "initial_states", initial_states);
+}
+
+TEMPLATE_TRANSPORT
+void SM_TRANSPORT::burst(int nb_iterations)
+{
+    if (burster_client_ == nullptr)
+    {
+        burster_client_.reset(new BursterClient(segment_id_));
+    }
+    burster_client_->burst(nb_iterations);
+}
+
+TEMPLATE_TRANSPORT
+void SM_TRANSPORT::final_burst()
+{
+    if (burster_client_ != nullptr)
+    {
+        burster_client_->final_burst();
+    }
+}
+
+TEMPLATE_TRANSPORT
+long int SM_TRANSPORT::get_bursting()
+{
+    long int nb_iterations;
+    shared_memory::get<long int>(segment_id_, "bursting", nb_iterations);
+    reset_bursting();
+    return nb_iterations;
+}
+
+TEMPLATE_TRANSPORT
+void SM_TRANSPORT::reset_bursting()
+{
+    shared_memory::set<long int>(segment_id_, "bursting", 0);
+}
+
+TEMPLATE_TRANSPORT
+bool SM_TRANSPORT::wait_for_burst()
+{
+    if (burster_ == nullptr)
+    {
+        burster_ = std::make_shared<Burster>(segment_id_);
+    }
+    return burster_->pulse();
+}
+
+TEMPLATE_TRANSPORT
+bool SM_TRANSPORT::is_retired()
+{
+    return owner_->record().is_retired();
+}
+
+// -------------------- in process transport -------------------- //
+
+TEMPLATE_TRANSPORT
+IP_TRANSPORT::InProcessTransport(const SegmentLayout& layout)
+    : internal::InProcessSegment(),
+      layout_(layout),
+      commands_(layout.commands_size),
+      observations_(layout.observations_size),
+      completed_(layout.completed_size),
+      waiting_for_completion_(create_introspection()),
+      completion_reported_(create_introspection()),
+      received_(create_introspection()),
+      starting_(create_introspection()),
+      traces_(layout.has_traces() ? new time_series::TimeSeries<CommandTrace>(
+                                        layout.trace_size)
+                                  : nullptr),
+      pulse_id_(0),
+      command_read_(-1),
+      purge_(false),
+      active_(false)
+{
+}
+
+TEMPLATE_TRANSPORT
+typename IP_TRANSPORT::IntrospectionPtr IP_TRANSPORT::create_introspection()
+    const
+{
+    if (!layout_.has_introspection())
+    {
+        return nullptr;
+    }
+    return IntrospectionPtr(
+        new time_series::TimeSeries<int>(layout_.introspection_size));
+}
+
+TEMPLATE_TRANSPORT
+const SegmentLayout& IP_TRANSPORT::get_layout()
+{
+    return layout_;
+}
+
+TEMPLATE_TRANSPORT
+COMMANDS_TS& IP_TRANSPORT::commands()
+{
+    return commands_;
+}
+
+TEMPLATE_TRANSPORT
+OBSERVATIONS_TS& IP_TRANSPORT::observations()
+{
+    return observations_;
+}
+
+TEMPLATE_TRANSPORT
+COMPLETED_TS& IP_TRANSPORT::completed()
+{
+    return completed_;
+}
+
+TEMPLATE_TRANSPORT
+COMPLETED_TS* IP_TRANSPORT::waiting_for_completion()
+{
+    return waiting_for_completion_.get();
+}
+
+TEMPLATE_TRANSPORT
+COMPLETED_TS* IP_TRANSPORT::completion_reported()
+{
+    return completion_reported_.get();
+}
+
+TEMPLATE_TRANSPORT
+COMPLETED_TS* IP_TRANSPORT::received()
+{
+    return received_.get();
+}
+
+TEMPLATE_TRANSPORT
+COMPLETED_TS* IP_TRANSPORT::starting()
+{
+    return starting_.get();
+}
+
+TEMPLATE_TRANSPORT
+TracesTimeSeries* IP_TRANSPORT::traces()
+{
+    return traces_.get();
+}
+
+TEMPLATE_TRANSPORT
+long int IP_TRANSPORT::get_pulse_id()
+{
+    return pulse_id_;
+}
+
+TEMPLATE_TRANSPORT
+void IP_TRANSPORT::set_pulse_id(long int pulse_id)
+{
+    pulse_id_ = pulse_id;
+}
+
+TEMPLATE_TRANSPORT
+time_series::Index IP_TRANSPORT::get_command_read()
+{
+    return command_read_;
+}
+
+TEMPLATE_TRANSPORT
+void IP_TRANSPORT::set_command_read(time_series::Index index)
+{
+    command_read_ = index;
+}
+
+TEMPLATE_TRANSPORT
+bool IP_TRANSPORT::get_purge()
+{
+    return purge_;
+}
+
+TEMPLATE_TRANSPORT
+void IP_TRANSPORT::set_purge(bool purge)
+{
+    purge_ = purge;
+}
+
+TEMPLATE_TRANSPORT
+bool IP_TRANSPORT::get_active()
+{
+    return active_;
+}
+
+TEMPLATE_TRANSPORT
+void IP_TRANSPORT::set_active(bool active)
+{
+    active_ = active;
+}
+
+TEMPLATE_TRANSPORT
+void IP_TRANSPORT::set_initial_states(
+    const States<NB_ACTUATORS, STATE>& initial_states)
+{
+    std::lock_guard<std::mutex> guard(initial_states_mutex_);
+    initial_states_ = initial_states;
+}
+
+TEMPLATE_TRANSPORT
+void IP_TRANSPORT::get_initial_states(
+    States<NB_ACTUATORS, STATE>& initial_states)
+{
+    std::lock_guard<std::mutex> guard(initial_states_mutex_);
+    initial_states = initial_states_;
+}
+
+TEMPLATE_TRANSPORT
+void IP_TRANSPORT::burst(int nb_iterations)
+{
+    internal::InProcessSegment::burst(nb_iterations);
+}
+
+TEMPLATE_TRANSPORT
+void IP_TRANSPORT::final_burst()
+{
+    internal::InProcessSegment::final_burst();
+}
+
+TEMPLATE_TRANSPORT
+long int IP_TRANSPORT::get_bursting()
+{
+    return internal::InProcessSegment::get_bursting();
+}
+
+TEMPLATE_TRANSPORT
+void IP_TRANSPORT::reset_bursting()
+{
+    internal::InProcessSegment::reset_bursting();
+}
+
+TEMPLATE_TRANSPORT
+bool IP_TRANSPORT::wait_for_burst()
+{
+    return internal::InProcessSegment::wait_for_burst();
+}
+
+TEMPLATE_TRANSPORT
+bool IP_TRANSPORT::is_retired()
+{
+    return internal::InProcessSegment::retired();
+}
+
+// -------------------- shared region transport -------------------- //
+
+TEMPLATE_TRANSPORT
+SR_TRANSPORT::SharedRegionTransport(std::string segment_id,
+                                    bool leader,
+                                    const SegmentLayout& layout,
+                                    std::uint64_t generation)
+    : region_(create_region(segment_id, leader, layout, generation)),
+      commands_(region_, internal::COMMANDS_RING),
+      observations_(region_, internal::OBSERVATIONS_RING),
+      completed_(region_, internal::COMPLETED_RING),
+      waiting_for_completion_(
+          create_introspection(internal::WAITING_FOR_COMPLETION_RING)),
+      completion_reported_(
+          create_introspection(internal::COMPLETION_REPORTED_RING)),
+      received_(create_introspection(internal::RECEIVED_RING)),
+      starting_(create_introspection(internal::STARTING_RING)),
+      traces_(region_->has_ring(internal::TRACES_RING)
+                  ? new RegionTraces(region_, internal::TRACES_RING)
+                  : nullptr)
+{
+}
+
+TEMPLATE_TRANSPORT
+std::shared_ptr<internal::SharedRegion> SR_TRANSPORT::create_region(
+    const std::string& segment_id,
+    bool leader,
+    const SegmentLayout& layout,
+    std::uint64_t generation)
+{
+    if (!leader)
+    {
+        return std::make_shared<internal::SharedRegion>(segment_id);
+    }
+    internal::SharedRegion::ItemSizes item_sizes;
+    item_sizes[internal::COMMANDS_RING] = RegionCommands::item_size();
+    item_sizes[internal::OBSERVATIONS_RING] = RegionObservations::item_size();
+    for (internal::RegionRing ring : {internal::COMPLETED_RING,
+                                      internal::WAITING_FOR_COMPLETION_RING,
+                                      internal::COMPLETION_REPORTED_RING,
+                                      internal::RECEIVED_RING,
+                                      internal::STARTING_RING})
+    {
+        item_sizes[ring] = RegionCompleted::item_size();
+    }
+    item_sizes[internal::TRACES_RING] = RegionTraces::item_size();
+    std::size_t initial_states_size = shared_memory::Serializer<
+        States<NB_ACTUATORS, STATE>>::serializable_size();
+    return std::make_shared<internal::SharedRegion>(
+        segment_id, layout, item_sizes, initial_states_size, generation);
+}
+
+TEMPLATE_TRANSPORT
+typename SR_TRANSPORT::IntrospectionPtr SR_TRANSPORT::create_introspection(
+    internal::RegionRing ring) const
+{
+    if (!region_->has_ring(ring))
+    {
+        return nullptr;
+    }
+    return IntrospectionPtr(new RegionCompleted(region_, ring));
+}
+
+TEMPLATE_TRANSPORT
+const internal::SharedRegion& SR_TRANSPORT::get_region() const
+{
+    return *region_;
+}
+
+TEMPLATE_TRANSPORT
+const SegmentLayout& SR_TRANSPORT::get_layout()
+{
+    return region_->get_layout();
+}
+
+TEMPLATE_TRANSPORT
+COMMANDS_TS& SR_TRANSPORT::commands()
+{
+    return commands_;
+}
+
+TEMPLATE_TRANSPORT
+OBSERVATIONS_TS& SR_TRANSPORT::observations()
+{
+    return observations_;
+}
+
+TEMPLATE_TRANSPORT
+COMPLETED_TS& SR_TRANSPORT::completed()
+{
+    return completed_;
+}
+
+TEMPLATE_TRANSPORT
+COMPLETED_TS* SR_TRANSPORT::waiting_for_completion()
+{
+    return waiting_for_completion_.get();
+}
+
+TEMPLATE_TRANSPORT
+COMPLETED_TS* SR_TRANSPORT::completion_reported()
+{
+    return completion_reported_.get();
+}
+
+TEMPLATE_TRANSPORT
+COMPLETED_TS* SR_TRANSPORT::received()
+{
+    return received_.get();
+}
+
+TEMPLATE_TRANSPORT
+COMPLETED_TS* SR_TRANSPORT::starting()
+{
+    return starting_.get();
+}
+
+TEMPLATE_TRANSPORT
+TracesTimeSeries* SR_TRANSPORT::traces()
+{
+    return traces_.get();
+}
+
+TEMPLATE_TRANSPORT
+long int SR_TRANSPORT::get_pulse_id()
+{
+    return region_->get_pulse_id();
+}
+
+TEMPLATE_TRANSPORT
+void SR_TRANSPORT::set_pulse_id(long int pulse_id)
+{
+    region_->set_pulse_id(pulse_id);
+}
+
+TEMPLATE_TRANSPORT
+time_series::Index SR_TRANSPORT::get_command_read()
+{
+    return region_->get_command_read();
+}
+
+TEMPLATE_TRANSPORT
+void SR_TRANSPORT::set_command_read(time_series::Index index)
+{
+    region_->set_command_read(index);
+}
+
+TEMPLATE_TRANSPORT
+bool SR_TRANSPORT::get_purge()
+{
+    return region_->get_purge();
+}
+
+TEMPLATE_TRANSPORT
+void SR_TRANSPORT::set_purge(bool purge)
+{
+    region_->set_purge(purge);
+}
+
+TEMPLATE_TRANSPORT
+bool SR_TRANSPORT::get_active()
+{
+    return region_->get_active();
+}
+
+TEMPLATE_TRANSPORT
+void SR_TRANSPORT::set_active(bool active)
+{
+    region_->set_active(active);
+}
+
+TEMPLATE_TRANSPORT
+void SR_TRANSPORT::set_initial_states(
+    const States<NB_ACTUATORS, STATE>& initial_states)
+{
+    shared_memory::Serializer<States<NB_ACTUATORS, STATE>> serializer;
+    region_->set_initial_states(serializer.serialize(initial_states));
+}
+
+TEMPLATE_TRANSPORT
+void SR_TRANSPORT::get_initial_states(
+    States<NB_ACTUATORS, STATE>& initial_states)
+{
+    std::string serialized;
+    if (region_->get_initial_states(serialized))
+    {
+        shared_memory::Serializer<States<NB_ACTUATORS, STATE>> serializer;
+        serializer.deserialize(serialized, initial_states);
+    }
+}
+
+TEMPLATE_TRANSPORT
+void SR_TRANSPORT::burst(int nb_iterations)
+{
+    region_->burst(nb_iterations);
+}
+
+TEMPLATE_TRANSPORT
+void SR_TRANSPORT::final_burst()
+{
+    region_->final_burst();
+}
+
+TEMPLATE_TRANSPORT
+long int SR_TRANSPORT::get_bursting()
+{
+    return region_->get_bursting();
+}
+
+TEMPLATE_TRANSPORT
+void SR_TRANSPORT::reset_bursting()
+{
+    region_->reset_bursting();
+}
+
+TEMPLATE_TRANSPORT
+bool SR_TRANSPORT::wait_for_burst()
+{
+    return region_->wait_for_burst();
+}
+
+TEMPLATE_TRANSPORT
+bool SR_TRANSPORT::is_retired()
+{
+    return region_->owner().is_retired();
+}
@@ -50,8 +50,10 @@ Command<STATE>::Command(const Command<STATE>& other)
 
 template <class STATE>
 Command<STATE>::Command(Command<STATE>&& other) noexcept
-    : command_type_(std::move(other.command_type_)),
-      target_state_(std::move(other.target_state_))
+    : pulse_id_(other.pulse_id_),
+      target_state_(std::move(other.target_state_)),
+      command_type_(std::move(other.command_type_)),
+      command_status_(std::move(other.command_status_))
 {
     copy(other, false);
 }
@@ -67,6 +69,7 @@ template <class STATE>
 Command<STATE>& Command<STATE>::operator=(Command<STATE>&& other) noexcept
 {
     copy(other, false);
+    pulse_id_ = other.pulse_id_;
     target_state_ = std::move(other.target_state_);
     command_status_ = std::move(other.command_status_);
     return *this;
@@ -10,9 +10,10 @@
 #include "command.hpp"
 #include "command_status.hpp"
 #include "command_type.hpp"
+#include "o80/command_trace.hpp"
 #include "o80/sensor_state.hpp"
 #include "o80/time.hpp"
-#include "time_series/multiprocess_time_series.hpp"
+#include "time_series/interface.hpp"
 
 namespace o80
 {
@@ -29,8 +30,7 @@ template <class STATE>
 class Controller
 {
 private:
-    typedef time_series::MultiprocessTimeSeries<int>
-        CompletedCommandsTimeSeries;
+    typedef time_series::TimeSeriesInterface<int> CompletedCommandsTimeSeries;
 
 public:
     Controller();
@@ -38,7 +38,11 @@ public:
     void set_completed_commands(
         CompletedCommandsTimeSeries& completed_commands);
 
-    void set_starting_commands(CompletedCommandsTimeSeries& starting_commands);
+    void set_starting_commands(CompletedCommandsTimeSeries* starting_commands);
+
+    /*! the controller traces the start and the completion of
+        the commands (ignored if nullptr)*/
+    void set_traces(TracesTimeSeries* traces);
 
     void set_command(const Command<STATE>& command);
 
@@ -65,6 +69,10 @@ public:
 
     bool reapplied_desired_state() const;
 
+    /*! copies the commands (queued and current, including their status)
+        and the desired state of other (used for backend snapshots)*/
+    void copy_state(const Controller<STATE>& other);
+
 private:
     // control iteration is used to remove invalid commands, i.e. commands
     // that would require to change pressure in a duration smaller than one
@@ -81,6 +89,10 @@ private:
     static std::mutex mutex_;
     CompletedCommandsTimeSeries* completed_commands_;
     CompletedCommandsTimeSeries* starting_commands_;
+    TracesTimeSeries* traces_;
+    // latest iteration a command was started at or
+    // computed for (see traces_)
+    long int iteration_;
     std::queue<Command<STATE>> queue_;
     Command<STATE> current_command_;
     STATE desired_state_;
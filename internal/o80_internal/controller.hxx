@@ -5,7 +5,9 @@ namespace o80
 {
 template <class STATE>
 Controller<STATE>::Controller()
-  : current_state_(nullptr), reapplied_desired_state_(true),backend_period_us_(-1.)
+  : traces_(nullptr),
+    iteration_(-1),
+    current_state_(nullptr), reapplied_desired_state_(true),backend_period_us_(-1.)
 {
 }
 
@@ -13,6 +15,11 @@ template <class STATE>
 void Controller<STATE>::share_completed_command(const Command<STATE>& command)
 {
     completed_commands_->append(command.get_id());
+    if (traces_ != nullptr)
+    {
+        traces_->append(
+            CommandTrace(command.get_id(), COMMAND_COMPLETED, iteration_));
+    }
 }
 
 template <class STATE>
@@ -43,9 +50,15 @@ void Controller<STATE>::set_completed_commands(
 
 template <class STATE>
 void Controller<STATE>::set_starting_commands(
-    CompletedCommandsTimeSeries& starting_commands)
+    CompletedCommandsTimeSeries* starting_commands)
+{
+    starting_commands_ = starting_commands;
+}
+
+template <class STATE>
+void Controller<STATE>::set_traces(TracesTimeSeries* traces)
 {
-    starting_commands_ = &starting_commands;
+    traces_ = traces;
 }
 
 template <class STATE>
@@ -91,6 +104,8 @@ Command<STATE>* Controller<STATE>::get_current_command(
 {
     std::lock_guard<std::mutex> guard(mutex_);
 
+    iteration_ = current_iteration;
+
     {
         // if there is a current command, check
         // if finished. if not, returning it
@@ -120,7 +135,15 @@ Command<STATE>* Controller<STATE>::get_current_command(
       }
     
     // for debug and introspection
-    starting_commands_->append(current_command_.get_id());
+    if (starting_commands_ != nullptr)
+    {
+        starting_commands_->append(current_command_.get_id());
+    }
+    if (traces_ != nullptr)
+    {
+        traces_->append(CommandTrace(
+            current_command_.get_id(), COMMAND_STARTING, current_iteration));
+    }
 
     queue_.pop();
 
@@ -233,6 +256,16 @@ bool Controller<STATE>::reapplied_desired_state() const
     return reapplied_desired_state_;
 }
 
+template <class STATE>
+void Controller<STATE>::copy_state(const Controller<STATE>& other)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    queue_ = other.queue_;
+    current_command_ = other.current_command_;
+    desired_state_ = other.desired_state_;
+    reapplied_desired_state_ = other.reapplied_desired_state_;
+}
+
 template <class STATE>
 const STATE& Controller<STATE>::get_desired_state(
     long int current_iteration,
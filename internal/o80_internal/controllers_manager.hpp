@@ -4,10 +4,11 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 #include "command.hpp"
 #include "controller.hpp"
 #include "o80/states.hpp"
-#include "time_series/multiprocess_time_series.hpp"
+#include "o80/transport.hpp"
 
 namespace o80
 {
@@ -16,13 +17,29 @@ class ControllersManager
 {
 public:
     typedef std::array<Controller<STATE>, NB_ACTUATORS> Controllers;
-    typedef time_series::MultiprocessTimeSeries<Command<STATE>>
+    typedef typename CommandsTransport<STATE>::CommandsTimeSeries
         CommandsTimeSeries;
-    typedef time_series::MultiprocessTimeSeries<int>
+    typedef typename CommandsTransport<STATE>::CompletedCommandsTimeSeries
         CompletedCommandsTimeSeries;
 
+    /*! state of the controllers (see BackEnd::snapshot). The position
+        of the manager in the commands time series is not part of it.*/
+    class Snapshot
+    {
+    public:
+        Controllers controllers;
+        States<NB_ACTUATORS, STATE> previous_desired_states;
+        std::array<bool, NB_ACTUATORS> initialized;
+        long int relative_iteration;
+    };
+
 public:
-  ControllersManager(std::string segment_id, double period_us);
+    /**
+     * @param transport channels shared with the frontends
+     *        (commands and completed commands)
+     * @param period_us expected backend period (-1 if unknown)
+     */
+    ControllersManager(CommandsTransport<STATE> &transport, double period_us);
 
     void process_commands(long int current_iteration);
 
@@ -33,38 +50,65 @@ public:
 
     int get_current_command_id(int dof) const;
 
+    /*! number of commands queued or running for this actuator*/
+    int get_queue_depth(int dof) const;
+
+    /*! number of commands read by the manager since construction*/
+    long int nb_received_commands() const;
+
     void get_newly_executed_commands(std::queue<int> &get);
 
     bool reapplied_desired_states() const;
 
+    /*! if not nullptr, process_commands appends to commands a copy of
+        each command it reads (as shared by the frontend)*/
+    void set_recorded_commands(std::vector<Command<STATE>> *commands);
+
+    /*! pulse id of the latest batch of commands read*/
+    long int get_pulse_id() const;
+
     CommandsTimeSeries &get_commands_time_series();
     CompletedCommandsTimeSeries &get_completed_commands_time_series();
 
     void purge();
 
+    Snapshot snapshot() const;
+    void restore(const Snapshot &snapshot);
+
 private:
     // ! to delete
     void _print(CommandsTimeSeries *time_series);
 
-    std::string segment_id_;
-    CommandsTimeSeries commands_;
+    CommandsTransport<STATE> &transport_;
+    CommandsTimeSeries &commands_;
     long int pulse_id_;
     time_series::Index commands_index_;
-    CompletedCommandsTimeSeries completed_commands_;
+    CompletedCommandsTimeSeries &completed_commands_;
     Controllers controllers_;
     States<NB_ACTUATORS, STATE> previous_desired_states_;
     std::array<bool, NB_ACTUATORS> initialized_;
     long int relative_iteration_;
+    long int nb_received_commands_;
 
     // everytime the backend reads a new command from the
     // shared memory, it will write in this time series its
-    // command id. For debug and introspection.
-    CompletedCommandsTimeSeries received_commands_;
+    // command id. For debug and introspection
+    // (nullptr if disabled by the segment layout).
+    CompletedCommandsTimeSeries *received_commands_;
 
     // everytime the backend starts execution of a command,
     // it will write in this time series its
-    // command id. For debug and introspection.
-    CompletedCommandsTimeSeries starting_commands_;
+    // command id. For debug and introspection
+    // (nullptr if disabled by the segment layout).
+    CompletedCommandsTimeSeries *starting_commands_;
+
+    // time stamped lifecycle events of the commands (received,
+    // started and completed), with the backend iteration
+    // (nullptr if disabled by the segment layout).
+    TracesTimeSeries *traces_;
+
+    // see set_recorded_commands
+    std::vector<Command<STATE>> *recorded_commands_;
 };
 }  // namespace o80
 
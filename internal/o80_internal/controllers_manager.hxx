@@ -5,30 +5,29 @@ namespace o80
 {
 template <int NB_ACTUATORS, int QUEUE_SIZE, class STATE>
 ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::ControllersManager(
-									std::string segment_id, double period_us)
-    : commands_{CommandsTimeSeries::create_leader(segment_id + "_commands",
-                                                  QUEUE_SIZE)},
-      commands_index_(-1),
+    CommandsTransport<STATE>& transport, double period_us)
+    : transport_(transport),
+      commands_(transport.commands()),
       pulse_id_(0),
-      completed_commands_{CompletedCommandsTimeSeries::create_leader(
-          segment_id + "_completed", QUEUE_SIZE)},
-      segment_id_(segment_id),
+      commands_index_(-1),
+      completed_commands_(transport.completed()),
       relative_iteration_(-1),
-      received_commands_{CompletedCommandsTimeSeries::create_leader(
-          segment_id + "_received", QUEUE_SIZE)},
-      starting_commands_{CompletedCommandsTimeSeries::create_leader(
-          segment_id + "_starting", QUEUE_SIZE)}
+      nb_received_commands_(0),
+      received_commands_(transport.received()),
+      starting_commands_(transport.starting()),
+      traces_(transport.traces()),
+      recorded_commands_(nullptr)
 {
     for (int i = 0; i < NB_ACTUATORS; i++)
     {
         initialized_[i] = false;
         controllers_[i].set_completed_commands(completed_commands_);
         controllers_[i].set_starting_commands(starting_commands_);
+        controllers_[i].set_traces(traces_);
 	controllers_[i].set_backend_period(period_us);
     }
-    shared_memory::set<long int>(segment_id_, "pulse_id", pulse_id_);
-    shared_memory::set<time_series::Index>(
-        segment_id_, "command_read", commands_index_);
+    transport_.set_pulse_id(pulse_id_);
+    transport_.set_command_read(commands_index_);
 }
 
 template <int NB_ACTUATORS, int QUEUE_SIZE, class STATE>
@@ -45,6 +44,20 @@ bool ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::
     return true;
 }
 
+template <int NB_ACTUATORS, int QUEUE_SIZE, class STATE>
+void ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::set_recorded_commands(
+    std::vector<Command<STATE>>* commands)
+{
+    recorded_commands_ = commands;
+}
+
+template <int NB_ACTUATORS, int QUEUE_SIZE, class STATE>
+long int ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::get_pulse_id()
+    const
+{
+    return pulse_id_;
+}
+
 template <int NB_ACTUATORS, int QUEUE_SIZE, class STATE>
 void ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::purge()
 {
@@ -54,6 +67,34 @@ void ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::purge()
     }
 }
 
+template <int NB_ACTUATORS, int QUEUE_SIZE, class STATE>
+typename ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::Snapshot
+ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::snapshot() const
+{
+    Snapshot snapshot;
+    for (int dof = 0; dof < NB_ACTUATORS; dof++)
+    {
+        snapshot.controllers[dof].copy_state(controllers_[dof]);
+    }
+    snapshot.previous_desired_states = previous_desired_states_;
+    snapshot.initialized = initialized_;
+    snapshot.relative_iteration = relative_iteration_;
+    return snapshot;
+}
+
+template <int NB_ACTUATORS, int QUEUE_SIZE, class STATE>
+void ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::restore(
+    const Snapshot& snapshot)
+{
+    for (int dof = 0; dof < NB_ACTUATORS; dof++)
+    {
+        controllers_[dof].copy_state(snapshot.controllers[dof]);
+    }
+    previous_desired_states_ = snapshot.previous_desired_states;
+    initialized_ = snapshot.initialized;
+    relative_iteration_ = snapshot.relative_iteration;
+}
+
 template <int NB_ACTUATORS, int QUEUE_SIZE, class STATE>
 void ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::process_commands(
     long int current_iteration)
@@ -64,8 +105,7 @@ void ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::process_commands(
     }
 
     // checking if the frontend is done with its current command batch
-    long int current_pulse_id;
-    shared_memory::get<long int>(segment_id_, "pulse_id", current_pulse_id);
+    long int current_pulse_id = transport_.get_pulse_id();
     if (current_pulse_id == pulse_id_)
     {
         return;
@@ -91,6 +131,10 @@ void ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::process_commands(
             newest_index = index - 1;
             break;
         }
+        if (recorded_commands_ != nullptr)
+        {
+            recorded_commands_->push_back(command);
+        }
         CommandType& command_type = command.get_command_type();
         if (command_type.type == Type::ITERATION)
         {
@@ -108,13 +152,21 @@ void ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::process_commands(
         {
             throw std::runtime_error("command with incorrect dof index");
         }
-        received_commands_.append(command.get_id());
+        if (received_commands_ != nullptr)
+        {
+            received_commands_->append(command.get_id());
+        }
+        if (traces_ != nullptr)
+        {
+            traces_->append(CommandTrace(
+                command.get_id(), COMMAND_RECEIVED, current_iteration));
+        }
         controllers_[dof].set_command(command);
+        nb_received_commands_++;
     }
     pulse_id_ = current_pulse_id;
     commands_index_ = newest_index + 1;
-    shared_memory::set<time_series::Index>(
-        segment_id_, "command_read", commands_index_);
+    transport_.set_command_read(commands_index_);
 }
 
 template <int NB_ACTUATORS, int QUEUE_SIZE, class STATE>
@@ -156,6 +208,26 @@ int ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::get_current_command_id(
     return controllers_[dof].get_current_command_id();
 }
 
+template <int NB_ACTUATORS, int QUEUE_SIZE, class STATE>
+int ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::get_queue_depth(
+    int dof) const
+{
+    if (dof < 0 || dof >= NB_ACTUATORS)
+    {
+        throw std::runtime_error("command with incorrect dof index");
+    }
+    // not using get_current_command_id, which locks
+    int running = controllers_[dof].reapplied_desired_state() ? 0 : 1;
+    return controllers_[dof].size() + running;
+}
+
+template <int NB_ACTUATORS, int QUEUE_SIZE, class STATE>
+long int ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::
+    nb_received_commands() const
+{
+    return nb_received_commands_;
+}
+
 template <int NB_ACTUATORS, int QUEUE_SIZE, class STATE>
 void ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::
     get_newly_executed_commands(std::queue<int>& get)
@@ -167,15 +239,16 @@ void ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::
 }
 
 template <int NB_ACTUATORS, int QUEUE_SIZE, class STATE>
-time_series::MultiprocessTimeSeries<Command<STATE>>&
+typename ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::CommandsTimeSeries&
 ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::get_commands_time_series()
 {
     return commands_;
 }
 
 template <int NB_ACTUATORS, int QUEUE_SIZE, class STATE>
-time_series::MultiprocessTimeSeries<int>&
-ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::
+typename ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::
+    CompletedCommandsTimeSeries&
+    ControllersManager<NB_ACTUATORS, QUEUE_SIZE, STATE>::
     get_completed_commands_time_series()
 {
     return completed_commands_;
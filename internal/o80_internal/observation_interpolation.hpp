@@ -0,0 +1,70 @@
+// Copyright (C) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include "o80/command_types.hpp"
+#include "o80/observation.hpp"
+#include "o80/states.hpp"
+#include "o80/time.hpp"
+
+namespace o80
+{
+namespace internal
+{
+/**
+ * ! Returns an observation at the time stamp stamp (expected to be between
+ *   the time stamps of before and after), which observed and desired states
+ *   are linearly interpolated between the ones of before and of after,
+ *   as for a duration command from before to after (i.e. using the
+ *   intermediate_state method of ROBOT_STATE, with a precision of a
+ *   microsecond). The other attributes are the ones of before.
+ */
+template <int NB_ACTUATORS, class ROBOT_STATE, class EXTENDED_STATE>
+Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE> interpolate_observation(
+    const Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>& before,
+    const Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>& after,
+    long int stamp)
+{
+    TimePoint start(before.get_time_stamp());
+    TimePoint now(stamp);
+    Duration_us duration(
+        time_diff_us(start, TimePoint(after.get_time_stamp())));
+    States<NB_ACTUATORS, ROBOT_STATE> observed_states;
+    States<NB_ACTUATORS, ROBOT_STATE> desired_states;
+    for (int dof = 0; dof < NB_ACTUATORS; dof++)
+    {
+        const ROBOT_STATE& observed = before.get_observed_states().get(dof);
+        const ROBOT_STATE& desired = before.get_desired_states().get(dof);
+        const ROBOT_STATE& observed_target =
+            after.get_observed_states().get(dof);
+        const ROBOT_STATE& desired_target = after.get_desired_states().get(dof);
+        observed_states.set(dof,
+                            observed_target.intermediate_state(start,
+                                                               now,
+                                                               observed,
+                                                               observed,
+                                                               observed,
+                                                               observed_target,
+                                                               duration));
+        desired_states.set(dof,
+                           desired_target.intermediate_state(start,
+                                                             now,
+                                                             desired,
+                                                             desired,
+                                                             desired,
+                                                             desired_target,
+                                                             duration));
+    }
+    return Observation<NB_ACTUATORS, ROBOT_STATE, EXTENDED_STATE>(
+        observed_states,
+        desired_states,
+        before.get_extended_state(),
+        stamp,
+        before.get_control_iteration(),
+        before.get_sensor_iteration(),
+        before.get_frequency());
+}
+
+}  // namespace internal
+}  // namespace o80
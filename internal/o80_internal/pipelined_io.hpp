@@ -0,0 +1,111 @@
+// Copyright (C) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace o80
+{
+namespace internal
+{
+/**
+ * ! Single producer / single consumer exchange of instances of T.
+ *   The producer writes the nth item in the slot n%2, so it may run at
+ *   most one item ahead of the consumer (which is ensured by the
+ *   handshake performed by PipelinedIO). The consumer spins for a
+ *   short while, then sleeps on a condition variable until the next
+ *   item is written (so that a waiting consumer, e.g. the I/O thread
+ *   while the standalone is parked in bursting mode, does not keep a
+ *   cpu busy). The producer locks the mutex only when the consumer
+ *   sleeps.
+ */
+template <class T>
+class DoubleBuffer
+{
+public:
+    DoubleBuffer();
+
+    /*! (producer) writes the next item*/
+    void write(const T& item);
+
+    /*! (consumer) waits for the next item and copies it into get.
+        Returns false (without copying) if running becomes false
+        while waiting.*/
+    bool read(T& get, const std::atomic<bool>& running);
+
+    /*! wakes up the consumer, if sleeping (for it to check running)*/
+    void wake_up();
+
+private:
+    // number of checks before the consumer goes to sleep
+    static constexpr int nb_spins_ = 1000;
+    // the sleeping consumer checks running at least at this period
+    static constexpr std::chrono::milliseconds max_sleep_{10};
+
+private:
+    std::array<T, 2> slots_;
+    std::atomic<long int> written_;
+    std::atomic<bool> sleeping_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    long int next_write_;
+    long int next_read_;
+};
+
+/**
+ * ! Runs the get and set methods of a driver in a dedicated thread, so
+ *   that the driver reads sensors for iteration k+1 while the
+ *   standalone computes the action of iteration k. Compared to
+ *   sequential calls, the throughput of the standalone becomes
+ *   bounded by the max of (get+set) and (o80 computation) rather than
+ *   by their sum, at the cost of one iteration of latency between
+ *   sensing and acting (the action of iteration k is applied after the
+ *   sensors of iteration k+1 have been read).
+ *   DRIVER_IN and DRIVER_OUT must be default constructible.
+ */
+template <class DRIVER>
+class PipelinedIO
+{
+public:
+    typedef typename DRIVER::DRIVER_IN DRIVER_IN;
+    typedef typename DRIVER::DRIVER_OUT DRIVER_OUT;
+
+public:
+    PipelinedIO(std::shared_ptr<DRIVER> driver_ptr);
+    ~PipelinedIO();
+
+    /*! spawns the I/O thread, which inherits the scheduling policy,
+        priority and cpu affinity of the calling thread. If the calling
+        thread is pinned to a single cpu, both threads share it and
+        get/set no longer overlap with the o80 computation: pin the
+        standalone to (at least) two cpus when using pipelined I/O.*/
+    void start();
+    void stop();
+
+    /*! (standalone thread) returns the next sensor reading*/
+    DRIVER_OUT get();
+    /*! (standalone thread) hands the action computed from the latest
+        sensor reading to the I/O thread*/
+    void set(const DRIVER_IN& action);
+
+private:
+    void run();
+
+private:
+    std::shared_ptr<DRIVER> driver_ptr_;
+    std::atomic<bool> running_;
+    DoubleBuffer<DRIVER_OUT> readings_;
+    DoubleBuffer<DRIVER_IN> actions_;
+    std::unique_ptr<std::thread> thread_;
+};
+
+#include "pipelined_io.hxx"
+}  // namespace internal
+}  // namespace o80
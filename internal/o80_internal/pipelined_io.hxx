@@ -0,0 +1,122 @@
+// Copyright (C) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+template <class T>
+DoubleBuffer<T>::DoubleBuffer()
+    : written_(-1), sleeping_(false), next_write_(0), next_read_(0)
+{
+}
+
+template <class T>
+void DoubleBuffer<T>::write(const T& item)
+{
+    slots_[next_write_ % 2] = item;
+    // sequentially consistent store and load: either the consumer sees
+    // the new item before going to sleep, or the producer sees it
+    // sleeping and notifies it
+    written_.store(next_write_);
+    next_write_++;
+    if (sleeping_.load())
+    {
+        wake_up();
+    }
+}
+
+template <class T>
+void DoubleBuffer<T>::wake_up()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    condition_.notify_one();
+}
+
+template <class T>
+bool DoubleBuffer<T>::read(T& get, const std::atomic<bool>& running)
+{
+    int spins = 0;
+    while (written_.load() < next_read_)
+    {
+        if (!running)
+        {
+            return false;
+        }
+        if (spins < nb_spins_)
+        {
+            spins++;
+            std::this_thread::yield();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        sleeping_.store(true);
+        condition_.wait_for(lock, max_sleep_, [this, &running]() {
+            return written_.load() >= next_read_ || !running;
+        });
+        sleeping_.store(false);
+    }
+    get = slots_[next_read_ % 2];
+    next_read_++;
+    return true;
+}
+
+template <class DRIVER>
+PipelinedIO<DRIVER>::PipelinedIO(std::shared_ptr<DRIVER> driver_ptr)
+    : driver_ptr_(driver_ptr), running_(false)
+{
+}
+
+template <class DRIVER>
+PipelinedIO<DRIVER>::~PipelinedIO()
+{
+    stop();
+}
+
+template <class DRIVER>
+void PipelinedIO<DRIVER>::start()
+{
+    running_ = true;
+    thread_.reset(new std::thread(&PipelinedIO<DRIVER>::run, this));
+}
+
+template <class DRIVER>
+void PipelinedIO<DRIVER>::stop()
+{
+    running_ = false;
+    readings_.wake_up();
+    actions_.wake_up();
+    if (thread_ != nullptr && thread_->joinable())
+    {
+        thread_->join();
+    }
+    thread_.reset();
+}
+
+template <class DRIVER>
+typename PipelinedIO<DRIVER>::DRIVER_OUT PipelinedIO<DRIVER>::get()
+{
+    DRIVER_OUT reading;
+    readings_.read(reading, running_);
+    return reading;
+}
+
+template <class DRIVER>
+void PipelinedIO<DRIVER>::set(const DRIVER_IN& action)
+{
+    actions_.write(action);
+}
+
+template <class DRIVER>
+void PipelinedIO<DRIVER>::run()
+{
+    DRIVER_IN action;
+    readings_.write(driver_ptr_->get());
+    while (running_)
+    {
+        // reading sensors of iteration k+1 while the standalone
+        // computes the action of iteration k
+        readings_.write(driver_ptr_->get());
+        if (!actions_.read(action, running_))
+        {
+            return;
+        }
+        driver_ptr_->set(action);
+    }
+}
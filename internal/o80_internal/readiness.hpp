@@ -0,0 +1,102 @@
+// Copyright (C) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include "o80_internal/segment_status.hpp"
+
+namespace o80
+{
+namespace internal
+{
+/**
+ * ! Frontend side of the readiness notifications: a named pipe
+ *   (/tmp/o80_readiness_<pid>_<id>), which read end is opened in non
+ *   blocking mode. The backend writes to the pipe when events the
+ *   frontend subscribed to occur (see SegmentStatus::set_readiness),
+ *   so the read end becomes readable (e.g. for poll, epoll or asyncio).
+ *   The pipe is removed on destruction.
+ */
+class ReadinessListener
+{
+public:
+    /*! Throws a runtime_error if the pipe can not be created*/
+    ReadinessListener();
+    ~ReadinessListener();
+
+    ReadinessListener(const ReadinessListener&) = delete;
+    ReadinessListener& operator=(const ReadinessListener&) = delete;
+
+    /*! file descriptor of the read end of the pipe*/
+    int get_fd() const;
+
+    /*! id of the pipe (unique in this process)*/
+    std::int32_t get_id() const;
+
+    /*! reads all the pending notifications, and returns the
+        events they notified (bitwise or of ReadinessEvent),
+        0 if none*/
+    int clear();
+
+    /*! path of the pipe of the listener of the process pid
+        and of id id*/
+    static std::string path(std::int64_t pid, std::int32_t id);
+
+private:
+    std::int32_t id_;
+    std::string path_;
+    int fd_;
+};
+
+/**
+ * ! Backend side of the readiness notifications: writes the events
+ *   to the pipes of the frontends which subscribed to them (as
+ *   registered in the status record of the backend). The pipes are
+ *   opened once per subscriber, for reading and writing and in non
+ *   blocking mode, so that writing never blocks, nor fails (SIGPIPE)
+ *   if the frontend exited. Only named pipes are written to (the path
+ *   is predictable, and not a symbolic link to another file). The
+ *   events are also accumulated in the status record, and a pipe is
+ *   written to only if the frontend cleared the previous notifications
+ *   (see SegmentStatus::clear_readiness): at most one system call per
+ *   frontend and clear. The pipe of a frontend which exited is closed.
+ */
+class ReadinessNotifier
+{
+public:
+    ReadinessNotifier();
+    ~ReadinessNotifier();
+
+    ReadinessNotifier(const ReadinessNotifier&) = delete;
+    ReadinessNotifier& operator=(const ReadinessNotifier&) = delete;
+
+    /*! events (bitwise or of ReadinessEvent) at least one frontend
+        subscribed to*/
+    int subscribed(const StatusRecord& record) const;
+
+    /*! notifies events (bitwise or of ReadinessEvent) to the frontends
+        subscribed to any of them*/
+    void notify(StatusRecord& record, int events);
+
+private:
+    struct Subscriber
+    {
+        int fd;
+        std::int64_t pid;
+        std::int32_t id;
+        // notifications not written since the latest write
+        long int nb_skipped;
+    };
+    // opens the pipe of the subscriber (fd is -1 on failure)
+    void open_pipe(Subscriber& subscriber);
+    void close_pipe(Subscriber& subscriber);
+
+private:
+    std::array<Subscriber, MAX_STATUS_FRONTENDS> subscribers_;
+};
+
+}  // namespace internal
+}  // namespace o80
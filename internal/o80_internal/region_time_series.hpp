@@ -0,0 +1,57 @@
+// Copyright (C) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include "o80_internal/shared_region.hpp"
+#include "shared_memory/serializer.hpp"
+#include "time_series/interface.hpp"
+
+namespace o80
+{
+namespace internal
+{
+/**
+ * ! Time series of (serialized) instances of T hosted by a ring of
+ *   a SharedRegion. Same semantic as multiprocess time series: accessing
+ *   an index which has not been appended yet is blocking, accessing
+ *   an index which has been overwritten throws an invalid_argument.
+ */
+template <class T>
+class RegionTimeSeries : public time_series::TimeSeriesInterface<T>
+{
+public:
+    RegionTimeSeries(std::shared_ptr<SharedRegion> region, RegionRing ring);
+
+    /*! max size of a serialized instance of T*/
+    static std::size_t item_size();
+
+    time_series::Index newest_timeindex(bool wait = true) const;
+    time_series::Index count_appended_elements() const;
+    time_series::Index oldest_timeindex(bool wait = true) const;
+    T newest_element() const;
+    T operator[](const time_series::Index& timeindex) const;
+    time_series::Timestamp timestamp_ms(
+        const time_series::Index& timeindex) const;
+    time_series::Timestamp timestamp_s(
+        const time_series::Index& timeindex) const;
+    bool wait_for_timeindex(
+        const time_series::Index& timeindex,
+        const double max_duration_s =
+            std::numeric_limits<double>::quiet_NaN()) const;
+    std::size_t length() const;
+    std::size_t max_length() const;
+    void append(const T& element);
+    bool is_empty() const;
+
+private:
+    std::shared_ptr<SharedRegion> region_;
+    RegionRing ring_;
+    shared_memory::Serializer<T> serializer_;
+};
+
+#include "region_time_series.hxx"
+}  // namespace internal
+}  // namespace o80
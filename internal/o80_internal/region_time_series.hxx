@@ -0,0 +1,110 @@
+// Copyright (C) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+template <class T>
+RegionTimeSeries<T>::RegionTimeSeries(std::shared_ptr<SharedRegion> region,
+                                      RegionRing ring)
+    : region_(region), ring_(ring)
+{
+}
+
+template <class T>
+std::size_t RegionTimeSeries<T>::item_size()
+{
+    return shared_memory::Serializer<T>::serializable_size();
+}
+
+template <class T>
+time_series::Index RegionTimeSeries<T>::newest_timeindex(bool wait) const
+{
+    if (wait)
+    {
+        region_->wait_for(
+            ring_, 0, std::numeric_limits<double>::quiet_NaN());
+    }
+    return region_->newest(ring_);
+}
+
+template <class T>
+time_series::Index RegionTimeSeries<T>::count_appended_elements() const
+{
+    return region_->newest(ring_) + 1;
+}
+
+template <class T>
+time_series::Index RegionTimeSeries<T>::oldest_timeindex(bool wait) const
+{
+    time_series::Index newest = newest_timeindex(wait);
+    if (newest == time_series::EMPTY)
+    {
+        return time_series::EMPTY;
+    }
+    return newest - static_cast<time_series::Index>(length()) + 1;
+}
+
+template <class T>
+T RegionTimeSeries<T>::newest_element() const
+{
+    return (*this)[newest_timeindex()];
+}
+
+template <class T>
+T RegionTimeSeries<T>::operator[](const time_series::Index& timeindex) const
+{
+    std::string item;
+    double timestamp_ms;
+    region_->read(ring_, timeindex, item, timestamp_ms);
+    T element;
+    shared_memory::Serializer<T> serializer;
+    serializer.deserialize(item, element);
+    return element;
+}
+
+template <class T>
+time_series::Timestamp RegionTimeSeries<T>::timestamp_ms(
+    const time_series::Index& timeindex) const
+{
+    std::string item;
+    double timestamp_ms;
+    region_->read(ring_, timeindex, item, timestamp_ms);
+    return timestamp_ms;
+}
+
+template <class T>
+time_series::Timestamp RegionTimeSeries<T>::timestamp_s(
+    const time_series::Index& timeindex) const
+{
+    return timestamp_ms(timeindex) / 1000.;
+}
+
+template <class T>
+bool RegionTimeSeries<T>::wait_for_timeindex(
+    const time_series::Index& timeindex, const double max_duration_s) const
+{
+    return region_->wait_for(ring_, timeindex, max_duration_s);
+}
+
+template <class T>
+std::size_t RegionTimeSeries<T>::length() const
+{
+    time_series::Index count = count_appended_elements();
+    return std::min(static_cast<std::size_t>(count), max_length());
+}
+
+template <class T>
+std::size_t RegionTimeSeries<T>::max_length() const
+{
+    return region_->capacity(ring_);
+}
+
+template <class T>
+void RegionTimeSeries<T>::append(const T& element)
+{
+    region_->append(ring_, serializer_.serialize(element));
+}
+
+template <class T>
+bool RegionTimeSeries<T>::is_empty() const
+{
+    return region_->newest(ring_) == time_series::EMPTY;
+}
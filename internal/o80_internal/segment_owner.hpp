@@ -0,0 +1,87 @@
+// Copyright (C) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace o80
+{
+namespace internal
+{
+/**
+ * ! Identifies the process running the backend of a segment. Lives in the
+ *   shared memory, either in the header of a shared region or in its own
+ *   segment (see SegmentOwner). A record is retired when its segment is
+ *   cleared (backend stopped, or replaced by a new backend), so that the
+ *   frontends attached to it know they have to reattach.
+ */
+struct OwnerRecord
+{
+    std::int64_t pid;
+    // start time of the owner process (in clock ticks since boot),
+    // for not mistaking a process reusing the pid for the owner
+    std::uint64_t start_time;
+    // /proc/sys/kernel/random/boot_id
+    char boot_id[40];
+    // incremented each time a backend reclaims the segment
+    std::uint64_t generation;
+    std::atomic<std::uint32_t> retired;
+
+    /*! records the calling process as owner*/
+    void claim(std::uint64_t generation);
+    /*! true if the owner process is still running (i.e. same boot,
+        same pid and same start time)*/
+    bool owner_is_alive() const;
+    bool is_retired() const;
+    void retire();
+};
+
+/**
+ * ! Owner record of a segment using the shared memory
+ *   transport, hosted by its own shared memory segment
+ *   (/dev/shm/<segment_id>_owner).
+ */
+class SegmentOwner
+{
+public:
+    /*! Creates the record (backend side), replacing
+        the previous one of the same segment id, if any.*/
+    SegmentOwner(const std::string& segment_id, std::uint64_t generation);
+
+    /*! Attaches to the record created by the backend (frontend side).
+        Throws a runtime_error if no backend created it.*/
+    SegmentOwner(const std::string& segment_id);
+
+    ~SegmentOwner();
+
+    SegmentOwner(const SegmentOwner&) = delete;
+    SegmentOwner& operator=(const SegmentOwner&) = delete;
+
+    static std::string name(const std::string& segment_id);
+    static void clear(const std::string& segment_id);
+
+    OwnerRecord& record() const;
+
+private:
+    void map(int fd);
+
+private:
+    std::string segment_id_;
+    OwnerRecord* record_;
+};
+
+/*! Retires the owner records of the segment (if any), so that the
+    frontends attached to it reattach to the next backend.*/
+void retire_segment(const std::string& segment_id);
+
+/*! To be called by a backend before creating its segment. If a previous
+    backend of the same segment id is still running in another process,
+    throws a runtime_error. Otherwise, retires and clears the segment left
+    by the previous backend (if any, e.g. after a crash) and returns the
+    generation of the new backend.*/
+std::uint64_t reclaim_segment(const std::string& segment_id);
+}  // namespace internal
+}  // namespace o80
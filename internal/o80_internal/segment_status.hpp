@@ -0,0 +1,141 @@
+// Copyright (C) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace o80
+{
+namespace internal
+{
+/*! max number of actuators whose queue depth is reported*/
+static const int MAX_STATUS_ACTUATORS = 64;
+/*! max number of frontends counted by a status record*/
+static const int MAX_STATUS_FRONTENDS = 32;
+
+/**
+ * ! Health of a backend, written by the backend at each iteration and
+ *   read by monitors (see o80_top) without locking. Each field is
+ *   written by a single process with relaxed atomic stores, so a reader
+ *   may see fields of two consecutive iterations, but never a torn value.
+ *   Lives in its own shared memory segment (/dev/shm/<segment_id>_status),
+ *   whatever the transport used by the backend.
+ */
+struct StatusRecord
+{
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::int32_t nb_actuators;
+    std::int64_t pid;
+    char segment_id[64];
+    // a TransportType
+    std::int32_t transport;
+    // expected period of the backend (-1 if unknown)
+    double period_us;
+
+    std::atomic<std::int64_t> iteration;
+    // steady clock time of the latest iteration
+    std::atomic<std::int64_t> stamp_ns;
+    // moving averages of the period and of its deviation
+    std::atomic<std::int64_t> mean_period_ns;
+    std::atomic<std::int64_t> jitter_ns;
+    // number of iterations longer than the expected period
+    // (by more than 10%)
+    std::atomic<std::int64_t> overruns;
+    // 1 if at least one command was active during the latest iteration
+    std::atomic<std::int32_t> active;
+    // 1 once the backend is destroyed
+    std::atomic<std::int32_t> stopped;
+    // number of commands received by the backend since start
+    std::atomic<std::int64_t> nb_commands;
+    // number of commands queued or running, per actuator
+    std::atomic<std::int32_t> queue_depths[MAX_STATUS_ACTUATORS];
+    // pid of the attached frontends (0 for free slots)
+    std::atomic<std::int64_t> frontends[MAX_STATUS_FRONTENDS];
+    // readiness notifications requested by the frontend of each slot
+    // (bitwise or of ReadinessEvent, 0 for none), and id of its pipe
+    // (see ReadinessListener)
+    std::atomic<std::int32_t> readiness_events[MAX_STATUS_FRONTENDS];
+    std::atomic<std::int32_t> readiness_ids[MAX_STATUS_FRONTENDS];
+    // events notified by the backend and not yet cleared by the
+    // frontend (see ReadinessNotifier::notify)
+    std::atomic<std::int32_t> readiness_pending[MAX_STATUS_FRONTENDS];
+};
+
+/**
+ * ! Shared memory segment hosting the StatusRecord of a backend.
+ */
+class SegmentStatus
+{
+public:
+    /*! Creates the record (backend side), replacing the previous
+        one of the same segment id, if any.*/
+    SegmentStatus(const std::string& segment_id,
+                  int nb_actuators,
+                  int transport,
+                  double period_us);
+
+    /*! Attaches to the record created by the backend, read only
+        (monitors) or not (frontends). Throws a runtime_error if
+        no backend created it.*/
+    SegmentStatus(const std::string& segment_id, bool read_only);
+
+    /*! (backend side) marks the record as stopped, and unlinks it
+        (unless a new backend already replaced it)*/
+    ~SegmentStatus();
+
+    SegmentStatus(const SegmentStatus&) = delete;
+    SegmentStatus& operator=(const SegmentStatus&) = delete;
+
+    /*! (backend side) to be called at each iteration*/
+    void update(long int iteration, bool active, long int nb_commands);
+    /*! (backend side)*/
+    void set_queue_depth(int dof, int depth);
+
+    /*! (frontend side) claims a frontend slot, returns its index, or -1
+        if all slots are used*/
+    int attach_frontend();
+    /*! (frontend side) releases the slot returned by attach_frontend
+        (and cancels its readiness notifications)*/
+    void detach_frontend(int slot);
+    /*! (frontend side) requests the backend to notify events (bitwise
+        or of ReadinessEvent, 0 for none) to the ReadinessListener of id
+        listener_id, created by the process which claimed slot*/
+    void set_readiness(int slot, std::int32_t listener_id, int events);
+    /*! (frontend side) returns the events notified to the frontend of
+        slot since the previous call (bitwise or of ReadinessEvent)*/
+    int clear_readiness(int slot);
+
+    const StatusRecord& record() const;
+    StatusRecord& record();
+
+    /*! number of frontend slots claimed by running processes*/
+    int nb_frontends() const;
+
+    /*! true if the backend has not been destroyed and its
+        process is still running*/
+    bool is_alive() const;
+
+    /*! segment ids of all the status records found in /dev/shm*/
+    static std::vector<std::string> list();
+
+    static std::string name(const std::string& segment_id);
+    static void clear(const std::string& segment_id);
+
+private:
+    void map(int fd, bool read_only);
+
+private:
+    std::string segment_id_;
+    StatusRecord* record_;
+    bool leader_;
+    // inode of the segment (leader side)
+    std::uint64_t inode_;
+    std::int64_t previous_stamp_ns_;
+};
+}  // namespace internal
+}  // namespace o80
@@ -0,0 +1,179 @@
+// Copyright (C) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include "o80/segment_layout.hpp"
+#include "segment_owner.hpp"
+#include "time_series/interface.hpp"
+
+namespace o80
+{
+namespace internal
+{
+/*! rings (time series) hosted by a shared region*/
+enum RegionRing
+{
+    COMMANDS_RING,
+    OBSERVATIONS_RING,
+    COMPLETED_RING,
+    WAITING_FOR_COMPLETION_RING,
+    COMPLETION_REPORTED_RING,
+    RECEIVED_RING,
+    STARTING_RING,
+    TRACES_RING,
+    NB_REGION_RINGS
+};
+
+// lives in the shared memory, see shared_region.cpp
+struct RegionHeader;
+
+/**
+ * ! A single shared memory region (/dev/shm/<segment_id>_region) hosting
+ *   all the time series (as rings of serialized items) and the control
+ *   data of a backend. The region starts with a header (magic number,
+ *   segment layout, control block, bursting state and directory of the
+ *   rings), followed by the initial states and the slots of the rings.
+ *   Appending to a ring, waiting for an item and bursting are synchronized
+ *   via a process shared (robust) mutex and condition variable hosted by
+ *   the header. Reading an item does not lock: slots are versioned by the
+ *   index of the item they host. The header also hosts the owner record
+ *   of the segment (see reclaim_segment).
+ *   If required by the layout, the region is created in a hugetlbfs mount
+ *   point (e.g. /dev/hugepages) rather than in /dev/shm, and its pages are
+ *   prefaulted and locked.
+ */
+class SharedRegion
+{
+public:
+    /*! max size (in bytes) of the serialized items of each ring*/
+    typedef std::array<std::size_t, NB_REGION_RINGS> ItemSizes;
+
+public:
+    /**
+     * Creates the region (backend side). A previous region of the same
+     * segment id is replaced.
+     * @param segment_id id shared by the backend and the frontends
+     * @param layout capacity of each ring. If the introspection size
+     *        is 0, the introspection rings are not allocated (same for
+     *        the traces ring and the traces size). If
+     *        huge_pages is true, the region is allocated from huge pages
+     *        if available (regular pages otherwise). If prefault is true,
+     *        all its pages are touched and locked.
+     * @param item_sizes max size of the serialized items of each ring
+     * @param initial_states_size max size of the serialized initial states
+     * @param generation generation of the backend (see reclaim_segment)
+     */
+    SharedRegion(const std::string& segment_id,
+                 const SegmentLayout& layout,
+                 const ItemSizes& item_sizes,
+                 std::size_t initial_states_size,
+                 std::uint64_t generation);
+
+    /*! Attaches to the region created by the backend (frontend side).
+        Throws a runtime_error if no backend created it.*/
+    SharedRegion(const std::string& segment_id);
+
+    ~SharedRegion();
+
+    SharedRegion(const SharedRegion&) = delete;
+    SharedRegion& operator=(const SharedRegion&) = delete;
+
+    /*! name of the region (in /dev/shm)*/
+    static std::string name(const std::string& segment_id);
+
+    /*! path of the region in the hugetlbfs mount point, or an empty
+        string if no hugetlbfs file system is mounted*/
+    static std::string huge_pages_path(const std::string& segment_id);
+
+    /*! unlinks the region, if any. Processes which already mapped
+        it are not affected*/
+    static void clear(const std::string& segment_id);
+
+    /*! if a region of this segment id exists, wakes up
+        the standalone waiting for a burst (see release)*/
+    static void release(const std::string& segment_id);
+
+    const SegmentLayout& get_layout() const;
+
+    /*! process running the backend of the region*/
+    OwnerRecord& owner() const;
+
+    /*! number of bytes mapped*/
+    std::size_t size() const;
+
+    /*! true if the region is backed by hugetlbfs pages*/
+    bool has_huge_pages() const;
+
+    /*! true if the pages of the region are locked in memory
+        (leader side only)*/
+    bool is_locked() const;
+
+public:
+    /*! false for introspection and traces rings disabled by the layout*/
+    bool has_ring(RegionRing ring) const;
+    std::size_t capacity(RegionRing ring) const;
+    /*! index of the newest item, or time_series::EMPTY*/
+    time_series::Index newest(RegionRing ring) const;
+    /*! appends the (serialized) item and returns its index*/
+    time_series::Index append(RegionRing ring, const std::string& item);
+    /*! copies the (serialized) item of the specified index and its time
+        stamp, waiting for it to be appended if needed. Throws an
+        invalid_argument if the item has been overwritten (as
+        multiprocess time series do).*/
+    void read(RegionRing ring,
+              time_series::Index index,
+              std::string& item,
+              double& timestamp_ms) const;
+    /*! waits for the item of the specified index to be appended, for at
+        most max_duration_s seconds (no limit if NaN). Returns false
+        on timeout.*/
+    bool wait_for(RegionRing ring,
+                  time_series::Index index,
+                  double max_duration_s) const;
+
+public:
+    long int get_pulse_id() const;
+    void set_pulse_id(long int pulse_id);
+    time_series::Index get_command_read() const;
+    void set_command_read(time_series::Index index);
+    bool get_purge() const;
+    void set_purge(bool purge);
+    bool get_active() const;
+    void set_active(bool active);
+    void set_initial_states(const std::string& initial_states);
+    /*! returns false if the initial states have not been set yet*/
+    bool get_initial_states(std::string& initial_states) const;
+
+public:
+    // bursting, same semantic as InProcessSegment
+    void burst(int nb_iterations);
+    void final_burst();
+    long int get_bursting();
+    void reset_bursting();
+    bool wait_for_burst();
+    void release();
+
+private:
+    void map(int fd, std::size_t size);
+    // returns false (and leaves the region unmapped) if no huge page
+    // is available
+    bool create_huge_pages(std::size_t size, bool prefault);
+    void create_regular_pages(std::size_t size, bool huge_pages);
+    void prefault_and_lock();
+    char* slot(RegionRing ring, time_series::Index index) const;
+
+private:
+    std::string segment_id_;
+    std::size_t size_;
+    char* memory_;
+    RegionHeader* header_;
+    SegmentLayout layout_;
+    bool huge_pages_;
+    bool locked_;
+};
+}  // namespace internal
+}  // namespace o80
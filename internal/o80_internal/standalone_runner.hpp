@@ -1,8 +1,14 @@
 #pragma once
 
 #include <atomic>
+#include <cstring>
+#include <future>
+#include <o80/real_time_config.hpp>
 #include <o80/standalone.hpp>
+#include <o80/transport.hpp>
+#include <optional>
 #include <real_time_tools/thread.hpp>
+#include <type_traits>
 
 namespace o80
 {
@@ -11,6 +17,26 @@ namespace internal
 template <class RobotDriver, class o80Standalone>
 THREAD_FUNCTION_RETURN_TYPE run_helper(void* arg);
 
+/*! base class of the (opaque) snapshots of standalones*/
+class StandaloneSnapshotInterface
+{
+public:
+    virtual ~StandaloneSnapshotInterface()
+    {
+    }
+};
+
+template <class o80Standalone>
+class StandaloneSnapshotHolder : public StandaloneSnapshotInterface
+{
+public:
+    StandaloneSnapshotHolder(const typename o80Standalone::Snapshot& s)
+        : snapshot(s)
+    {
+    }
+    typename o80Standalone::Snapshot snapshot;
+};
+
 class StandaloneRunnerInterface
 {
 public:
@@ -18,6 +44,9 @@ public:
     virtual void stop() = 0;
     virtual void run() = 0;
     virtual bool is_running() = 0;
+    virtual std::shared_ptr<StandaloneSnapshotInterface> snapshot() = 0;
+    virtual void restore(
+        std::shared_ptr<StandaloneSnapshotInterface> snapshot) = 0;
 };
 
 template <class RobotDriver, class o80Standalone>
@@ -28,6 +57,8 @@ public:
     StandaloneRunner(std::string segment_id,
                      double frequency,
                      bool bursting,
+                     TransportType transport,
+                     std::optional<RealTimeConfig> config,
                      Args&&... args);
 
     ~StandaloneRunner();
@@ -38,8 +69,18 @@ public:
 
     bool is_running();
 
+    std::shared_ptr<StandaloneSnapshotInterface> snapshot();
+    void restore(std::shared_ptr<StandaloneSnapshotInterface> snapshot);
+
+private:
+    void check_snapshot_allowed() const;
+
 private:
+    std::string segment_id_;
     bool bursting_;
+    std::optional<RealTimeConfig> config_;
+    // set by the thread once config_ has been applied
+    std::promise<void> configured_;
     std::atomic<bool> running_;
     real_time_tools::RealTimeThread thread_;
     std::shared_ptr<RobotDriver> driver_ptr_;
@@ -50,6 +91,7 @@ typedef std::shared_ptr<StandaloneRunnerInterface> StandalonePtr;
 
 StandalonePtr& get_standalone(const std::string& segment_id);
 void add_standalone(const std::string& segment_id, StandalonePtr standalone);
+void remove_standalone(const std::string& segment_id);
 bool standalone_exists(const std::string& segment_id);
 
 #include "standalone_runner.hxx"
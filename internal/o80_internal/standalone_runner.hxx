@@ -1,15 +1,48 @@
 #define SRUNNER StandaloneRunner<RobotDriver, o80Standalone>
 
+// constructs the standalone, forwarding the transport type if its
+// constructor supports it (only shared memory is supported otherwise)
+template <class o80Standalone, class DriverPtr>
+o80Standalone make_standalone(DriverPtr driver_ptr,
+                              double frequency,
+                              std::string segment_id,
+                              TransportType transport)
+{
+    if constexpr (std::is_constructible<o80Standalone,
+                                        DriverPtr,
+                                        double,
+                                        std::string,
+                                        TransportType>::value)
+    {
+        return o80Standalone(driver_ptr, frequency, segment_id, transport);
+    }
+    else
+    {
+        if (transport != SHARED_MEMORY)
+        {
+            throw std::runtime_error(
+                "o80 standalone: in process transport requires the standalone "
+                "constructor to accept (and forward) a TransportType argument");
+        }
+        return o80Standalone(driver_ptr, frequency, segment_id);
+    }
+}
+
 template <class RobotDriver, class o80Standalone>
 template <typename... Args>
 SRUNNER::StandaloneRunner(std::string segment_id,
                           double frequency,
                           bool bursting,
+                          TransportType transport,
+                          std::optional<RealTimeConfig> config,
                           Args&&... args)
-    : bursting_(bursting),
+    : segment_id_(segment_id),
+      bursting_(bursting),
+      config_(config),
       running_(false),
       driver_ptr_(std::make_shared<RobotDriver>(std::forward<Args>(args)...)),
-      standalone_(driver_ptr_, frequency, segment_id)
+      standalone_(make_standalone<o80Standalone>(
+          driver_ptr_, frequency, segment_id, transport))
 {
 }
 
@@ -26,8 +59,32 @@ template <class RobotDriver, class o80Standalone>
 void SRUNNER::start()
 {
     standalone_.start();
-    thread_.create_realtime_thread(run_helper<RobotDriver, o80Standalone>,
-                                   (void*)this);
+    if (config_)
+    {
+        // priority, cpus and memory locking are applied by the thread
+        // itself (see run)
+        standalone_.set_pipelined_io(config_->pipelined_io);
+    }
+    std::future<void> configured = configured_.get_future();
+    int error = thread_.create_realtime_thread(
+        run_helper<RobotDriver, o80Standalone>, (void*)this);
+    if (error != 0)
+    {
+        standalone_.stop();
+        throw std::runtime_error(
+            std::string("o80 standalone ") + segment_id_ +
+            std::string(": failed to create the standalone thread (") +
+            std::strerror(error) + std::string(")"));
+    }
+    try
+    {
+        configured.get();
+    }
+    catch (...)
+    {
+        thread_.join();
+        throw;
+    }
 }
 
 template <class RobotDriver, class o80Standalone>
@@ -40,6 +97,24 @@ void SRUNNER::stop()
 template <class RobotDriver, class o80Standalone>
 void SRUNNER::run()
 {
+    if (config_)
+    {
+        try
+        {
+            config_->apply();
+            if (config_->touch_segments)
+            {
+                RealTimeConfig::touch_segment_pages(segment_id_);
+            }
+        }
+        catch (...)
+        {
+            standalone_.stop();
+            configured_.set_exception(std::current_exception());
+            return;
+        }
+    }
+    configured_.set_value();
     running_ = true;
     bool should_run = true;
     while (running_ && should_run)
@@ -56,6 +131,47 @@ bool SRUNNER::is_running()
     return running_;
 }
 
+template <class RobotDriver, class o80Standalone>
+void SRUNNER::check_snapshot_allowed() const
+{
+    // between bursts, the standalone thread waits for the next
+    // burst, so it is safe to access the standalone from another thread
+    if (!bursting_)
+    {
+        std::string error("o80 standalone ");
+        error += segment_id_;
+        error += std::string(
+            ": snapshot and restore are supported only in bursting mode");
+        throw std::runtime_error(error);
+    }
+}
+
+template <class RobotDriver, class o80Standalone>
+std::shared_ptr<StandaloneSnapshotInterface> SRUNNER::snapshot()
+{
+    check_snapshot_allowed();
+    return std::make_shared<StandaloneSnapshotHolder<o80Standalone>>(
+        standalone_.snapshot());
+}
+
+template <class RobotDriver, class o80Standalone>
+void SRUNNER::restore(std::shared_ptr<StandaloneSnapshotInterface> snapshot)
+{
+    check_snapshot_allowed();
+    std::shared_ptr<StandaloneSnapshotHolder<o80Standalone>> holder =
+        std::dynamic_pointer_cast<StandaloneSnapshotHolder<o80Standalone>>(
+            snapshot);
+    if (holder == nullptr)
+    {
+        std::string error("o80 standalone ");
+        error += segment_id_;
+        error += std::string(
+            ": snapshot was taken from a standalone of another type");
+        throw std::runtime_error(error);
+    }
+    standalone_.restore(holder->snapshot);
+}
+
 template <class RobotDriver, class o80Standalone>
 THREAD_FUNCTION_RETURN_TYPE run_helper(void* arg)
 {
@@ -77,6 +193,11 @@ void add_standalone(const std::string& segment_id, StandalonePtr standalone)
         std::pair<std::string, StandalonePtr>(segment_id, standalone));
 }
 
+void remove_standalone(const std::string& segment_id)
+{
+    standalones.erase(segment_id);
+}
+
 bool standalone_exists(const std::string& segment_id)
 {
     if (standalones.find(segment_id) == standalones.end())
@@ -0,0 +1,52 @@
+// Copyright (C) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "o80/tracer.hpp"
+
+namespace o80
+{
+namespace internal
+{
+/**
+ * ! Lock free ring of TraceRecord, with a single producer (the thread
+ *   tracing) and a single consumer (the drain thread of Tracer).
+ *   The producer never blocks: if the ring is full, the record is
+ *   dropped (see nb_dropped).
+ */
+class TraceRing
+{
+public:
+    /*! capacity is rounded up to a power of 2*/
+    TraceRing(std::size_t capacity, std::uint16_t thread);
+
+    /*! producer side, returns false if the ring is full*/
+    bool push(const TraceRecord& record);
+
+    /*! consumer side: copies the records available into records
+        (appended) and returns their number*/
+    std::size_t pop(std::vector<TraceRecord>& records);
+
+    std::uint16_t thread() const;
+    long int nb_dropped() const;
+
+private:
+    std::vector<TraceRecord> records_;
+    std::uint64_t mask_;
+    std::uint16_t thread_;
+    // written by the producer
+    alignas(64) std::atomic<std::uint64_t> head_;
+    // producer side copy of tail_, refreshed only when the
+    // ring seems full
+    std::uint64_t cached_tail_;
+    std::atomic<long int> nb_dropped_;
+    // written by the consumer
+    alignas(64) std::atomic<std::uint64_t> tail_;
+};
+}  // namespace internal
+}  // namespace o80
@@ -0,0 +1,54 @@
+// Copyright (C) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace o80
+{
+namespace internal
+{
+/**
+ * ! Fixed size pool of threads running batches of tasks.
+ *   A task is a function called with the index of the task.
+ */
+class WorkerPool
+{
+public:
+    WorkerPool(int nb_workers);
+    ~WorkerPool();
+
+    /*! calls task(0), ..., task(nb_tasks-1) in the worker threads and
+        returns once all calls returned. If any call throws, the first
+        exception is rethrown (once all calls returned). Concurrent
+        calls (e.g. from several python threads) run their batches one
+        after the other. Should not be called from a task.*/
+    void run(int nb_tasks, const std::function<void(int)>& task);
+
+    int size() const;
+
+private:
+    void work();
+
+private:
+    std::vector<std::thread> workers_;
+    // held by run for the whole batch
+    std::mutex run_mutex_;
+    std::mutex mutex_;
+    std::condition_variable task_condition_;
+    std::condition_variable done_condition_;
+    const std::function<void(int)>* task_;
+    int nb_tasks_;
+    int next_task_;
+    int nb_done_;
+    std::exception_ptr error_;
+    bool stopping_;
+};
+}  // namespace internal
+}  // namespace o80
@@ -0,0 +1,62 @@
+#include "o80/command_replay.hpp"
+#include <unistd.h>
+#include <atomic>
+
+namespace o80
+{
+ReplayReport::ReplayReport()
+    : nb_iterations(0),
+      nb_commands(0),
+      nb_mismatches(0),
+      first_mismatch(-1),
+      duration_ns(0)
+{
+}
+
+double ReplayReport::iterations_per_second() const
+{
+    if (duration_ns <= 0)
+    {
+        return 0;
+    }
+    return static_cast<double>(nb_iterations) * 1e9 /
+           static_cast<double>(duration_ns);
+}
+
+std::string ReplayReport::to_string() const
+{
+    std::string s("iterations: ");
+    s += std::to_string(nb_iterations);
+    s += std::string(" commands: ");
+    s += std::to_string(nb_commands);
+    s += std::string(" duration: ");
+    s += std::to_string(duration_ns / 1e6);
+    s += std::string("ms (");
+    s += std::to_string(static_cast<long int>(iterations_per_second()));
+    s += std::string(" iterations/s)");
+    if (nb_mismatches == 0)
+    {
+        s += std::string(" desired states: identical");
+    }
+    else
+    {
+        s += std::string(" desired states: ");
+        s += std::to_string(nb_mismatches);
+        s += std::string(" mismatches (first at iteration ");
+        s += std::to_string(first_mismatch);
+        s += std::string(")");
+    }
+    return s;
+}
+
+namespace internal
+{
+std::string new_replay_segment_id()
+{
+    static std::atomic<int> counter(0);
+    return std::string("o80_replay_") + std::to_string(getpid()) +
+           std::string("_") + std::to_string(counter++);
+}
+}  // namespace internal
+
+}  // namespace o80
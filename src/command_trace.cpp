@@ -0,0 +1,303 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#include "o80/command_trace.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include "o80/segment_layout.hpp"
+#include "o80/time.hpp"
+#include "o80_internal/region_time_series.hpp"
+#include "o80_internal/segment_owner.hpp"
+#include "o80_internal/shared_region.hpp"
+#include "shared_memory/shared_memory.hpp"
+#include "time_series/multiprocess_time_series.hpp"
+
+namespace o80
+{
+CommandTrace::CommandTrace()
+    : command_id(-1), event(COMMAND_SHARED), iteration(-1), stamp_ns(0)
+{
+}
+
+CommandTrace::CommandTrace(int command_id_,
+                           CommandEvent event_,
+                           long int iteration_)
+    : command_id(command_id_),
+      event(event_),
+      iteration(iteration_),
+      stamp_ns(time_now().count())
+{
+}
+
+CommandTrace::CommandTrace(int command_id_,
+                           CommandEvent event_,
+                           long int iteration_,
+                           long int stamp_ns_)
+    : command_id(command_id_),
+      event(event_),
+      iteration(iteration_),
+      stamp_ns(stamp_ns_)
+{
+}
+
+CommandEvent CommandTrace::get_event() const
+{
+    return static_cast<CommandEvent>(event);
+}
+
+std::string CommandTrace::to_string() const
+{
+    std::ostringstream s;
+    s << stamp_ns << " ns\tcommand " << command_id << "\t"
+      << IntrospectionEvent::event_name(get_event());
+    if (iteration >= 0)
+    {
+        s << " (iteration " << iteration << ")";
+    }
+    return s.str();
+}
+
+LatencyStats::LatencyStats()
+    : count(0), min(0), mean(0), median(0), p90(0), p99(0), max(0)
+{
+}
+
+// nearest rank percentile of sorted values
+static double percentile(const std::vector<double>& sorted, double p)
+{
+    std::size_t rank =
+        static_cast<std::size_t>(std::ceil(p * sorted.size() / 100.));
+    return sorted[std::max<std::size_t>(rank, 1) - 1];
+}
+
+LatencyStats::LatencyStats(std::vector<double> durations) : LatencyStats()
+{
+    if (durations.empty())
+    {
+        return;
+    }
+    std::sort(durations.begin(), durations.end());
+    count = durations.size();
+    min = durations.front();
+    max = durations.back();
+    double sum = 0;
+    for (double duration : durations)
+    {
+        sum += duration;
+    }
+    mean = sum / count;
+    median = percentile(durations, 50);
+    p90 = percentile(durations, 90);
+    p99 = percentile(durations, 99);
+}
+
+std::string LatencyStats::to_string() const
+{
+    if (count == 0)
+    {
+        return std::string("no data");
+    }
+    std::ostringstream s;
+    s << std::fixed << std::setprecision(1) << "count: " << count
+      << " min: " << min << " median: " << median << " p90: " << p90
+      << " p99: " << p99 << " max: " << max << " mean: " << mean << " (us)";
+    return s.str();
+}
+
+CommandLatencies::CommandLatencies(const std::vector<CommandTrace>& traces)
+{
+    // time stamps of the events of each command (the first one
+    // if an event is traced several times, e.g. several frontends
+    // waiting for the same command)
+    typedef std::array<long int, NB_COMMAND_EVENTS> Stamps;
+    std::map<int, Stamps> commands;
+    for (const CommandTrace& trace : traces)
+    {
+        if (trace.event < 0 || trace.event >= NB_COMMAND_EVENTS)
+        {
+            continue;
+        }
+        auto inserted = commands.insert({trace.command_id, Stamps()});
+        if (inserted.second)
+        {
+            inserted.first->second.fill(-1);
+        }
+        long int& stamp = inserted.first->second[trace.event];
+        if (stamp < 0 || trace.stamp_ns < stamp)
+        {
+            stamp = trace.stamp_ns;
+        }
+    }
+    nb_commands_ = commands.size();
+
+    std::vector<double> pickup, queueing, start, execution, total;
+    auto add = [](std::vector<double>& durations,
+                  const Stamps& stamps,
+                  CommandEvent from,
+                  CommandEvent to) {
+        if (stamps[from] >= 0 && stamps[to] >= 0)
+        {
+            durations.push_back(
+                static_cast<double>(stamps[to] - stamps[from]) / 1e3);
+        }
+    };
+    for (const auto& command : commands)
+    {
+        const Stamps& stamps = command.second;
+        add(pickup, stamps, COMMAND_SHARED, COMMAND_RECEIVED);
+        add(queueing, stamps, COMMAND_RECEIVED, COMMAND_STARTING);
+        add(start, stamps, COMMAND_SHARED, COMMAND_STARTING);
+        add(execution, stamps, COMMAND_STARTING, COMMAND_COMPLETED);
+        add(total, stamps, COMMAND_SHARED, COMMAND_COMPLETED);
+    }
+    pickup_ = LatencyStats(pickup);
+    queueing_ = LatencyStats(queueing);
+    start_ = LatencyStats(start);
+    execution_ = LatencyStats(execution);
+    total_ = LatencyStats(total);
+}
+
+std::size_t CommandLatencies::nb_commands() const
+{
+    return nb_commands_;
+}
+
+const LatencyStats& CommandLatencies::pickup() const
+{
+    return pickup_;
+}
+
+const LatencyStats& CommandLatencies::queueing() const
+{
+    return queueing_;
+}
+
+const LatencyStats& CommandLatencies::start() const
+{
+    return start_;
+}
+
+const LatencyStats& CommandLatencies::execution() const
+{
+    return execution_;
+}
+
+const LatencyStats& CommandLatencies::total() const
+{
+    return total_;
+}
+
+std::string CommandLatencies::to_string() const
+{
+    std::ostringstream s;
+    s << "commands:  " << nb_commands_ << "\n"
+      << "pickup:    " << pickup_.to_string() << "\n"
+      << "queueing:  " << queueing_.to_string() << "\n"
+      << "start:     " << start_.to_string() << "\n"
+      << "execution: " << execution_.to_string() << "\n"
+      << "total:     " << total_.to_string();
+    return s.str();
+}
+
+TraceReader::TraceReader(const std::string& segment_id)
+    : region_(nullptr), traces_(nullptr), next_(0), nb_dropped_(0)
+{
+    try
+    {
+        region_ = std::make_shared<internal::SharedRegion>(segment_id);
+    }
+    catch (const std::runtime_error&)
+    {
+    }
+
+    if (region_)
+    {
+        if (!region_->has_ring(internal::TRACES_RING))
+        {
+            throw std::runtime_error("o80: the traces of segment id " +
+                                     segment_id +
+                                     " are disabled by its layout");
+        }
+        traces_ = std::make_shared<internal::RegionTimeSeries<CommandTrace>>(
+            region_, internal::TRACES_RING);
+    }
+    else
+    {
+        // throws if no backend is running
+        internal::SegmentOwner owner(segment_id);
+        SegmentLayout layout;
+        shared_memory::deserialize(segment_id, "layout", layout);
+        if (!layout.has_traces())
+        {
+            throw std::runtime_error("o80: the traces of segment id " +
+                                     segment_id +
+                                     " are disabled by its layout");
+        }
+        traces_ =
+            time_series::MultiprocessTimeSeries<CommandTrace>::
+                create_follower_ptr(segment_id + "_traces");
+    }
+
+    // only the traces written after construction are read
+    next_ = traces_->newest_timeindex(false) + 1;
+}
+
+std::vector<CommandTrace> TraceReader::read()
+{
+    std::vector<CommandTrace> traces;
+    time_series::Index newest = traces_->newest_timeindex(false);
+    if (newest < next_)
+    {
+        return traces;
+    }
+    time_series::Index oldest = traces_->oldest_timeindex(false);
+    if (oldest > next_)
+    {
+        nb_dropped_ += oldest - next_;
+        next_ = oldest;
+    }
+    traces.reserve(newest - next_ + 1);
+    for (; next_ <= newest; next_++)
+    {
+        try
+        {
+            traces.push_back((*traces_)[next_]);
+        }
+        catch (const std::exception&)
+        {
+            // overwritten while reading
+            nb_dropped_++;
+        }
+    }
+    return traces;
+}
+
+std::vector<CommandTrace> TraceReader::collect(double duration_s)
+{
+    std::vector<CommandTrace> traces;
+    TimePoint end = time_now() + std::chrono::duration_cast<TimePoint>(
+                                     std::chrono::duration<double>(duration_s));
+    while (true)
+    {
+        std::vector<CommandTrace> latest = read();
+        traces.insert(traces.end(), latest.begin(), latest.end());
+        if (time_now() >= end)
+        {
+            return traces;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+long int TraceReader::nb_dropped() const
+{
+    return nb_dropped_;
+}
+
+}  // namespace o80
@@ -0,0 +1,157 @@
+#include "o80/introspection_event.hpp"
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace o80
+{
+static const char BINARY_HEADER[8] = "o80evt1";
+
+// binary record, see IntrospectionEvent
+struct EventRecord
+{
+    double timestamp_ms;
+    std::int32_t command_id;
+    std::int16_t event;
+    std::int16_t actuator;
+};
+static_assert(sizeof(EventRecord) == 16, "unexpected padding");
+
+static const char* EVENT_NAMES[NB_COMMAND_EVENTS] = {
+    "shared", "received", "starting", "completed", "waited_for", "reported"};
+
+IntrospectionEvent::IntrospectionEvent()
+    : timestamp_ms(0), command_id(-1), event(COMMAND_SHARED), actuator(-1)
+{
+}
+
+IntrospectionEvent::IntrospectionEvent(double timestamp_ms_,
+                                       int command_id_,
+                                       CommandEvent event_,
+                                       int actuator_)
+    : timestamp_ms(timestamp_ms_),
+      command_id(command_id_),
+      event(event_),
+      actuator(actuator_)
+{
+}
+
+std::string IntrospectionEvent::event_name(CommandEvent event)
+{
+    if (event < 0 || event >= NB_COMMAND_EVENTS)
+    {
+        return std::string("unknown");
+    }
+    return std::string(EVENT_NAMES[event]);
+}
+
+std::string IntrospectionEvent::to_string() const
+{
+    std::ostringstream s;
+    s << std::fixed << std::setprecision(3) << timestamp_ms << " ms\t"
+      << "command " << command_id << "\t" << event_name(event);
+    if (actuator >= 0)
+    {
+        s << " (actuator " << actuator << ")";
+    }
+    return s.str();
+}
+
+std::string IntrospectionEvent::csv_header()
+{
+    return std::string("timestamp_ms,event,command_id,actuator");
+}
+
+std::string IntrospectionEvent::to_csv() const
+{
+    std::ostringstream s;
+    s << std::fixed << std::setprecision(6) << timestamp_ms << ","
+      << event_name(event) << "," << command_id << "," << actuator;
+    return s.str();
+}
+
+void IntrospectionEvent::write_binary_header(std::ostream& stream)
+{
+    stream.write(BINARY_HEADER, sizeof(BINARY_HEADER));
+}
+
+void IntrospectionEvent::write_binary(std::ostream& stream) const
+{
+    EventRecord record;
+    record.timestamp_ms = timestamp_ms;
+    record.command_id = command_id;
+    record.event = static_cast<std::int16_t>(event);
+    record.actuator = static_cast<std::int16_t>(actuator);
+    stream.write(reinterpret_cast<const char*>(&record), sizeof(record));
+}
+
+static CommandEvent event_from_name(const std::string& name)
+{
+    for (int event = 0; event < NB_COMMAND_EVENTS; event++)
+    {
+        if (name == EVENT_NAMES[event])
+        {
+            return static_cast<CommandEvent>(event);
+        }
+    }
+    throw std::runtime_error("o80 introspection: unknown event " + name);
+}
+
+std::vector<IntrospectionEvent> IntrospectionEvent::read_file(
+    const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("o80 introspection: failed to open " + path);
+    }
+    std::vector<IntrospectionEvent> events;
+    char header[sizeof(BINARY_HEADER)];
+    file.read(header, sizeof(header));
+    if (file && std::memcmp(header, BINARY_HEADER, sizeof(header)) == 0)
+    {
+        EventRecord record;
+        while (file.read(reinterpret_cast<char*>(&record), sizeof(record)))
+        {
+            events.push_back(
+                IntrospectionEvent(record.timestamp_ms,
+                                   record.command_id,
+                                   static_cast<CommandEvent>(record.event),
+                                   record.actuator));
+        }
+        return events;
+    }
+    // csv
+    file.clear();
+    file.seekg(0);
+    std::string line;
+    std::getline(file, line);
+    if (line != csv_header())
+    {
+        throw std::runtime_error("o80 introspection: " + path +
+                                 " is not an introspection file");
+    }
+    while (std::getline(file, line))
+    {
+        std::istringstream fields(line);
+        std::string timestamp, event, command_id, actuator;
+        std::getline(fields, timestamp, ',');
+        std::getline(fields, event, ',');
+        std::getline(fields, command_id, ',');
+        std::getline(fields, actuator, ',');
+        if (actuator.empty())
+        {
+            // truncated line (file being written)
+            break;
+        }
+        events.push_back(IntrospectionEvent(std::stod(timestamp),
+                                            std::stoi(command_id),
+                                            event_from_name(event),
+                                            std::stoi(actuator)));
+    }
+    return events;
+}
+
+}  // namespace o80
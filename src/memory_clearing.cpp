@@ -1,10 +1,15 @@
 #include "o80/memory_clearing.hpp"
+#include "o80_internal/segment_owner.hpp"
+#include "o80_internal/segment_status.hpp"
+#include "o80_internal/shared_region.hpp"
 
 namespace o80
 {
 
   void clear_shared_memory(std::string segment_id)
 {
+    // frontends still attached will reattach to the next backend
+    internal::retire_segment(segment_id);
     time_series::clear_memory(segment_id + "_commands");
     time_series::clear_memory(segment_id + "_observations");
     time_series::clear_memory(segment_id + "_completed");
@@ -12,6 +17,7 @@ namespace o80
     time_series::clear_memory(segment_id + "_completion_reported");
     time_series::clear_memory(segment_id + "_received");
     time_series::clear_memory(segment_id + "_starting");
+    time_series::clear_memory(segment_id + "_traces");
     shared_memory::clear_shared_memory(segment_id + std::string("_commands"));
     shared_memory::clear_shared_memory(segment_id +
                                        std::string("_observations"));
@@ -22,6 +28,7 @@ namespace o80
                                        std::string("_completion_reported"));
     shared_memory::clear_shared_memory(segment_id + std::string("_received"));
     shared_memory::clear_shared_memory(segment_id + std::string("_starting"));
+    shared_memory::clear_shared_memory(segment_id + std::string("_traces"));
     Burster::clear_memory(segment_id);
     shared_memory::clear_shared_memory(segment_id +
                                        std::string("_synchronizer"));
@@ -30,6 +37,9 @@ namespace o80
     shared_memory::clear_shared_memory(segment_id +
                                        std::string("_synchronizer_leader"));
     shared_memory::clear_shared_memory(segment_id);
+    internal::SharedRegion::clear(segment_id);
+    internal::SegmentOwner::clear(segment_id);
+    internal::SegmentStatus::clear(segment_id);
 }
 
   
@@ -0,0 +1,200 @@
+// Copyright (C) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#include "o80_internal/readiness.hpp"
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace o80
+{
+namespace internal
+{
+// the pid of a frontend whose notifications are not cleared is checked
+// once every this number of notifications
+static const long int READINESS_CHECK_PERIOD = 1000;
+
+ReadinessListener::ReadinessListener() : fd_(-1)
+{
+    static std::atomic<std::int32_t> counter(0);
+    id_ = counter++;
+    path_ = path(getpid(), id_);
+    unlink(path_.c_str());
+    if (mkfifo(path_.c_str(), 0666) != 0)
+    {
+        throw std::runtime_error("o80: failed to create " + path_ + ": " +
+                                 std::strerror(errno));
+    }
+    fd_ = open(path_.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd_ < 0)
+    {
+        std::string error = std::strerror(errno);
+        unlink(path_.c_str());
+        throw std::runtime_error("o80: failed to open " + path_ + ": " +
+                                 error);
+    }
+}
+
+ReadinessListener::~ReadinessListener()
+{
+    close(fd_);
+    unlink(path_.c_str());
+}
+
+int ReadinessListener::get_fd() const
+{
+    return fd_;
+}
+
+std::int32_t ReadinessListener::get_id() const
+{
+    return id_;
+}
+
+int ReadinessListener::clear()
+{
+    // each notification is a byte which value is the
+    // notified events
+    int events = 0;
+    unsigned char buffer[256];
+    ssize_t nb_read;
+    while ((nb_read = read(fd_, buffer, sizeof(buffer))) > 0)
+    {
+        for (ssize_t index = 0; index < nb_read; index++)
+        {
+            events |= buffer[index];
+        }
+    }
+    return events;
+}
+
+std::string ReadinessListener::path(std::int64_t pid, std::int32_t id)
+{
+    return std::string("/tmp/o80_readiness_") + std::to_string(pid) +
+           std::string("_") + std::to_string(id);
+}
+
+ReadinessNotifier::ReadinessNotifier()
+{
+    for (Subscriber& subscriber : subscribers_)
+    {
+        subscriber.fd = -1;
+        subscriber.pid = 0;
+        subscriber.id = -1;
+        subscriber.nb_skipped = 0;
+    }
+}
+
+ReadinessNotifier::~ReadinessNotifier()
+{
+    for (Subscriber& subscriber : subscribers_)
+    {
+        close_pipe(subscriber);
+    }
+}
+
+void ReadinessNotifier::open_pipe(Subscriber& subscriber)
+{
+    // read and write, so that writing does not fail if the frontend
+    // closes it
+    subscriber.fd =
+        open(ReadinessListener::path(subscriber.pid, subscriber.id).c_str(),
+             O_RDWR | O_NONBLOCK | O_CLOEXEC | O_NOFOLLOW);
+    subscriber.nb_skipped = 0;
+    if (subscriber.fd < 0)
+    {
+        return;
+    }
+    struct stat status;
+    if (fstat(subscriber.fd, &status) != 0 || !S_ISFIFO(status.st_mode))
+    {
+        close(subscriber.fd);
+        subscriber.fd = -1;
+    }
+}
+
+void ReadinessNotifier::close_pipe(Subscriber& subscriber)
+{
+    if (subscriber.fd >= 0)
+    {
+        close(subscriber.fd);
+    }
+    subscriber.fd = -1;
+}
+
+int ReadinessNotifier::subscribed(const StatusRecord& record) const
+{
+    int events = 0;
+    for (int slot = 0; slot < MAX_STATUS_FRONTENDS; slot++)
+    {
+        events |= record.readiness_events[slot].load(std::memory_order_relaxed);
+    }
+    return events;
+}
+
+void ReadinessNotifier::notify(StatusRecord& record, int events)
+{
+    for (int slot = 0; slot < MAX_STATUS_FRONTENDS; slot++)
+    {
+        Subscriber& subscriber = subscribers_[slot];
+        int subscribed =
+            record.readiness_events[slot].load(std::memory_order_acquire);
+        if (subscribed == 0)
+        {
+            if (subscriber.pid != 0)
+            {
+                close_pipe(subscriber);
+                subscriber.pid = 0;
+                subscriber.id = -1;
+            }
+            continue;
+        }
+        std::int64_t pid =
+            record.frontends[slot].load(std::memory_order_relaxed);
+        std::int32_t id =
+            record.readiness_ids[slot].load(std::memory_order_relaxed);
+        if (pid != subscriber.pid || id != subscriber.id)
+        {
+            // new subscriber. If opening its pipe fails, not trying
+            // again until the subscriber changes.
+            close_pipe(subscriber);
+            subscriber.pid = pid;
+            subscriber.id = id;
+            open_pipe(subscriber);
+        }
+        int notified = subscribed & events;
+        if (subscriber.fd < 0 || notified == 0)
+        {
+            continue;
+        }
+        // the pipe is already readable if the frontend did not clear
+        // the previous notifications: only accumulating the events
+        int pending = record.readiness_pending[slot].fetch_or(notified);
+        if (pending != 0)
+        {
+            subscriber.nb_skipped++;
+            if (subscriber.nb_skipped % READINESS_CHECK_PERIOD == 0 &&
+                kill(subscriber.pid, 0) != 0 && errno == ESRCH)
+            {
+                close_pipe(subscriber);
+            }
+            continue;
+        }
+        subscriber.nb_skipped = 0;
+        unsigned char byte = static_cast<unsigned char>(notified);
+        if (write(subscriber.fd, &byte, 1) < 0 && errno != EAGAIN &&
+            errno != EINTR)
+        {
+            // e.g. EPIPE (no reader) or ENXIO
+            close_pipe(subscriber);
+        }
+    }
+}
+
+}  // namespace internal
+}  // namespace o80
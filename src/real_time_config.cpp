@@ -0,0 +1,139 @@
+#include "o80/real_time_config.hpp"
+#include <alloca.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace o80
+{
+static void throw_errno(const std::string& what, int error)
+{
+    std::string message("o80 real time configuration: failed to ");
+    message += what;
+    message += std::string(": ");
+    message += std::string(strerror(error));
+    throw std::runtime_error(message);
+}
+
+RealTimeConfig::RealTimeConfig()
+    : policy(FIFO_POLICY),
+      priority(80),
+      lock_memory(true),
+      stack_prefault_size(0),
+      touch_segments(false),
+      pipelined_io(false)
+{
+}
+
+void RealTimeConfig::apply() const
+{
+    if (!cpus.empty())
+    {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        for (int cpu : cpus)
+        {
+            CPU_SET(cpu, &cpu_set);
+        }
+        int error =
+            pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+        if (error != 0)
+        {
+            throw_errno("set cpu affinity", error);
+        }
+    }
+
+    int sched_policy = SCHED_FIFO;
+    if (policy == ROUND_ROBIN_POLICY)
+    {
+        sched_policy = SCHED_RR;
+    }
+    else if (policy == OTHER_POLICY)
+    {
+        sched_policy = SCHED_OTHER;
+    }
+    sched_param param;
+    param.sched_priority = (policy == OTHER_POLICY) ? 0 : priority;
+    int error = pthread_setschedparam(pthread_self(), sched_policy, &param);
+    if (error != 0)
+    {
+        throw_errno("set scheduling policy and priority", error);
+    }
+
+    if (lock_memory)
+    {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+        {
+            throw_errno("lock memory", errno);
+        }
+    }
+
+    if (stack_prefault_size > 0)
+    {
+        prefault_stack(stack_prefault_size);
+    }
+}
+
+void RealTimeConfig::prefault_stack(std::size_t nb_bytes)
+{
+    std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    volatile unsigned char* stack =
+        static_cast<volatile unsigned char*>(alloca(nb_bytes));
+    for (std::size_t index = 0; index < nb_bytes; index += page_size)
+    {
+        stack[index] = 0;
+    }
+}
+
+std::size_t RealTimeConfig::touch_segment_pages(const std::string& segment_id,
+                                                bool lock)
+{
+    // shared memory segments are mapped from /dev/shm/<name>, the
+    // segments of an o80 segment id are named after it, or after it
+    // followed by "_" (but e.g. segment_id2 is another segment id)
+    std::string exact = std::string("/dev/shm/") + segment_id;
+    std::string prefix = exact + std::string("_");
+    std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    std::size_t nb_pages = 0;
+
+    std::ifstream maps("/proc/self/maps");
+    std::string line;
+    while (std::getline(maps, line))
+    {
+        std::istringstream fields(line);
+        std::string range, permissions, offset, device, inode, path;
+        fields >> range >> permissions >> offset >> device >> inode >> path;
+        if ((path != exact &&
+             path.compare(0, prefix.size(), prefix) != 0) ||
+            permissions[0] != 'r')
+        {
+            continue;
+        }
+        std::size_t separator = range.find('-');
+        std::uintptr_t start = std::stoull(range.substr(0, separator), 0, 16);
+        std::uintptr_t end = std::stoull(range.substr(separator + 1), 0, 16);
+        for (std::uintptr_t address = start; address < end;
+             address += page_size)
+        {
+            volatile const unsigned char* page =
+                reinterpret_cast<volatile const unsigned char*>(address);
+            (void)*page;
+            nb_pages++;
+        }
+        if (lock &&
+            mlock(reinterpret_cast<const void*>(start), end - start) != 0)
+        {
+            // e.g. memlock limit too low: the pages remain touched
+        }
+    }
+    return nb_pages;
+}
+
+}  // namespace o80
@@ -0,0 +1,89 @@
+#include "o80/segment_layout.hpp"
+#include <stdexcept>
+
+namespace o80
+{
+SegmentLayout::SegmentLayout()
+    : commands_size(0),
+      observations_size(0),
+      completed_size(0),
+      introspection_size(0),
+      trace_size(0),
+      huge_pages(false),
+      prefault(false)
+{
+}
+
+SegmentLayout::SegmentLayout(std::size_t queue_size)
+    : commands_size(queue_size),
+      observations_size(queue_size),
+      completed_size(queue_size),
+      introspection_size(queue_size),
+      trace_size(0),
+      huge_pages(false),
+      prefault(false)
+{
+}
+
+SegmentLayout::SegmentLayout(std::size_t commands_size_,
+                             std::size_t observations_size_,
+                             std::size_t completed_size_,
+                             std::size_t introspection_size_,
+                             std::size_t trace_size_)
+    : commands_size(commands_size_),
+      observations_size(observations_size_),
+      completed_size(completed_size_),
+      introspection_size(introspection_size_),
+      trace_size(trace_size_),
+      huge_pages(false),
+      prefault(false)
+{
+}
+
+bool SegmentLayout::has_introspection() const
+{
+    return introspection_size > 0;
+}
+
+bool SegmentLayout::has_traces() const
+{
+    return trace_size > 0;
+}
+
+void SegmentLayout::check() const
+{
+    // introspection and traces may be 0 (disabled)
+    if (commands_size == 0 || observations_size == 0 || completed_size == 0)
+    {
+        throw std::invalid_argument(
+            std::string("o80 segment layout: the capacity of the commands, "
+                        "observations and completed time series should not "
+                        "be 0 (") +
+            to_string() + std::string(")"));
+    }
+}
+
+std::string SegmentLayout::to_string() const
+{
+    std::string s("commands: ");
+    s += std::to_string(commands_size);
+    s += std::string(" observations: ");
+    s += std::to_string(observations_size);
+    s += std::string(" completed: ");
+    s += std::to_string(completed_size);
+    s += std::string(" introspection: ");
+    s += std::to_string(introspection_size);
+    s += std::string(" traces: ");
+    s += std::to_string(trace_size);
+    if (huge_pages)
+    {
+        s += std::string(" (huge pages)");
+    }
+    if (prefault)
+    {
+        s += std::string(" (prefault)");
+    }
+    return s;
+}
+
+}  // namespace o80
@@ -0,0 +1,240 @@
+// Copyright (C) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#include "o80_internal/segment_owner.hpp"
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include "o80/memory_clearing.hpp"
+#include "o80_internal/shared_region.hpp"
+
+namespace o80
+{
+namespace internal
+{
+static std::string current_boot_id()
+{
+    std::ifstream file("/proc/sys/kernel/random/boot_id");
+    std::string boot_id;
+    std::getline(file, boot_id);
+    return boot_id;
+}
+
+// start time (in clock ticks since boot) of the process,
+// i.e. field 22 of /proc/<pid>/stat, or 0 if not available
+static std::uint64_t process_start_time(std::int64_t pid)
+{
+    std::ifstream file("/proc/" + std::to_string(pid) + "/stat");
+    std::string stat;
+    std::getline(file, stat);
+    // the process name (field 2) is in parenthesis and may contain spaces
+    std::size_t end_of_name = stat.rfind(')');
+    if (end_of_name == std::string::npos)
+    {
+        return 0;
+    }
+    std::istringstream fields(stat.substr(end_of_name + 1));
+    std::string field;
+    // fields 3 to 21
+    for (int index = 3; index < 22; index++)
+    {
+        fields >> field;
+    }
+    std::uint64_t start_time = 0;
+    fields >> start_time;
+    return start_time;
+}
+
+void OwnerRecord::claim(std::uint64_t generation_)
+{
+    pid = getpid();
+    start_time = process_start_time(pid);
+    std::string boot = current_boot_id();
+    std::memset(boot_id, 0, sizeof(boot_id));
+    std::strncpy(boot_id, boot.c_str(), sizeof(boot_id) - 1);
+    generation = generation_;
+    retired.store(0, std::memory_order_release);
+}
+
+bool OwnerRecord::owner_is_alive() const
+{
+    if (pid <= 0)
+    {
+        return false;
+    }
+    if (current_boot_id() != std::string(boot_id))
+    {
+        return false;
+    }
+    if (kill(pid, 0) != 0 && errno != EPERM)
+    {
+        return false;
+    }
+    return start_time == 0 || process_start_time(pid) == start_time;
+}
+
+bool OwnerRecord::is_retired() const
+{
+    return retired.load(std::memory_order_acquire) != 0;
+}
+
+void OwnerRecord::retire()
+{
+    retired.store(1, std::memory_order_release);
+}
+
+SegmentOwner::SegmentOwner(const std::string& segment_id,
+                           std::uint64_t generation)
+    : segment_id_(segment_id), record_(nullptr)
+{
+    clear(segment_id_);
+    std::string owner_name = name(segment_id_);
+    int fd = shm_open(owner_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0666);
+    if (fd < 0 || ftruncate(fd, sizeof(OwnerRecord)) != 0)
+    {
+        std::string error = std::strerror(errno);
+        if (fd >= 0)
+        {
+            close(fd);
+            shm_unlink(owner_name.c_str());
+        }
+        throw std::runtime_error("o80: failed to create " + owner_name +
+                                 ": " + error);
+    }
+    map(fd);
+    record_ = new (record_) OwnerRecord;
+    record_->claim(generation);
+}
+
+SegmentOwner::SegmentOwner(const std::string& segment_id)
+    : segment_id_(segment_id), record_(nullptr)
+{
+    int fd = shm_open(name(segment_id_).c_str(), O_RDWR, 0);
+    if (fd < 0)
+    {
+        throw std::runtime_error("o80: no backend of segment id " +
+                                 segment_id_ + " (is the backend running ?)");
+    }
+    map(fd);
+}
+
+SegmentOwner::~SegmentOwner()
+{
+    if (record_ != nullptr)
+    {
+        munmap(record_, sizeof(OwnerRecord));
+    }
+}
+
+void SegmentOwner::map(int fd)
+{
+    void* memory = mmap(nullptr,
+                        sizeof(OwnerRecord),
+                        PROT_READ | PROT_WRITE,
+                        MAP_SHARED,
+                        fd,
+                        0);
+    close(fd);
+    if (memory == MAP_FAILED)
+    {
+        throw std::runtime_error("o80: failed to map " + name(segment_id_) +
+                                 ": " + std::strerror(errno));
+    }
+    record_ = static_cast<OwnerRecord*>(memory);
+}
+
+std::string SegmentOwner::name(const std::string& segment_id)
+{
+    return std::string("/") + segment_id + std::string("_owner");
+}
+
+void SegmentOwner::clear(const std::string& segment_id)
+{
+    shm_unlink(name(segment_id).c_str());
+}
+
+OwnerRecord& SegmentOwner::record() const
+{
+    return *record_;
+}
+
+// owner records of the segment_id (shared memory and shared region
+// transports), ignoring the ones which do not exist
+static void for_each_record(const std::string& segment_id,
+                            void (*function)(const std::string&,
+                                             OwnerRecord&,
+                                             std::uint64_t&),
+                            std::uint64_t& generation)
+{
+    std::unique_ptr<SegmentOwner> owner;
+    try
+    {
+        owner.reset(new SegmentOwner(segment_id));
+    }
+    catch (const std::runtime_error&)
+    {
+    }
+    if (owner)
+    {
+        function(segment_id, owner->record(), generation);
+    }
+    std::unique_ptr<SharedRegion> region;
+    try
+    {
+        region.reset(new SharedRegion(segment_id));
+    }
+    catch (const std::runtime_error&)
+    {
+    }
+    if (region)
+    {
+        function(segment_id, region->owner(), generation);
+    }
+}
+
+void retire_segment(const std::string& segment_id)
+{
+    std::uint64_t generation = 0;
+    for_each_record(
+        segment_id,
+        [](const std::string&, OwnerRecord& record, std::uint64_t&) {
+            record.retire();
+        },
+        generation);
+}
+
+std::uint64_t reclaim_segment(const std::string& segment_id)
+{
+    std::uint64_t generation = 0;
+    for_each_record(
+        segment_id,
+        [](const std::string& segment_id,
+           OwnerRecord& record,
+           std::uint64_t& generation) {
+            if (!record.is_retired() && record.pid != getpid() &&
+                record.owner_is_alive())
+            {
+                throw std::runtime_error(
+                    "o80: the segment id " + segment_id +
+                    " is used by the backend of the running process " +
+                    std::to_string(record.pid));
+            }
+            generation = std::max(generation, record.generation);
+        },
+        generation);
+    // the owner of the segment (if any) is dead or stopped
+    clear_shared_memory(segment_id);
+    return generation + 1;
+}
+
+}  // namespace internal
+}  // namespace o80
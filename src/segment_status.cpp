@@ -0,0 +1,327 @@
+// Copyright (C) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#include "o80_internal/segment_status.hpp"
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include "o80/time.hpp"
+
+namespace o80
+{
+namespace internal
+{
+static const std::uint64_t STATUS_MAGIC = 0x6f38305f73746174;  // o80_stat
+static const std::uint32_t STATUS_VERSION = 3;
+static const std::string STATUS_SUFFIX("_status");
+// weight of the latest period in the moving averages
+static const std::int64_t STATUS_SMOOTHING = 16;
+
+static bool process_is_running(std::int64_t pid)
+{
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+}
+
+SegmentStatus::SegmentStatus(const std::string& segment_id,
+                             int nb_actuators,
+                             int transport,
+                             double period_us)
+    : segment_id_(segment_id),
+      record_(nullptr),
+      leader_(true),
+      inode_(0),
+      previous_stamp_ns_(-1)
+{
+    clear(segment_id_);
+    std::string status_name = name(segment_id_);
+    int fd = shm_open(status_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0666);
+    if (fd < 0 || ftruncate(fd, sizeof(StatusRecord)) != 0)
+    {
+        std::string error = std::strerror(errno);
+        if (fd >= 0)
+        {
+            close(fd);
+            shm_unlink(status_name.c_str());
+        }
+        throw std::runtime_error("o80: failed to create " + status_name +
+                                 ": " + error);
+    }
+    struct stat status;
+    if (fstat(fd, &status) == 0)
+    {
+        inode_ = status.st_ino;
+    }
+    map(fd, false);
+    record_ = new (record_) StatusRecord;
+    record_->magic = STATUS_MAGIC;
+    record_->version = STATUS_VERSION;
+    record_->nb_actuators = std::min(nb_actuators, MAX_STATUS_ACTUATORS);
+    record_->pid = getpid();
+    std::memset(record_->segment_id, 0, sizeof(record_->segment_id));
+    std::strncpy(record_->segment_id,
+                 segment_id_.c_str(),
+                 sizeof(record_->segment_id) - 1);
+    record_->transport = transport;
+    record_->period_us = period_us;
+    record_->iteration.store(-1);
+    record_->stamp_ns.store(0);
+    record_->mean_period_ns.store(0);
+    record_->jitter_ns.store(0);
+    record_->overruns.store(0);
+    record_->active.store(0);
+    record_->stopped.store(0);
+    record_->nb_commands.store(0);
+    for (int dof = 0; dof < MAX_STATUS_ACTUATORS; dof++)
+    {
+        record_->queue_depths[dof].store(0);
+    }
+    for (int slot = 0; slot < MAX_STATUS_FRONTENDS; slot++)
+    {
+        record_->frontends[slot].store(0);
+        record_->readiness_events[slot].store(0);
+        record_->readiness_ids[slot].store(-1);
+        record_->readiness_pending[slot].store(0);
+    }
+}
+
+SegmentStatus::SegmentStatus(const std::string& segment_id, bool read_only)
+    : segment_id_(segment_id),
+      record_(nullptr),
+      leader_(false),
+      inode_(0),
+      previous_stamp_ns_(-1)
+{
+    int fd = shm_open(name(segment_id_).c_str(),
+                      read_only ? O_RDONLY : O_RDWR,
+                      0);
+    struct stat status;
+    if (fd < 0 || fstat(fd, &status) != 0 ||
+        static_cast<std::size_t>(status.st_size) < sizeof(StatusRecord))
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        throw std::runtime_error("o80: no status of segment id " +
+                                 segment_id_ + " (is the backend running ?)");
+    }
+    map(fd, read_only);
+    if (record_->magic != STATUS_MAGIC || record_->version != STATUS_VERSION)
+    {
+        munmap(record_, sizeof(StatusRecord));
+        record_ = nullptr;
+        throw std::runtime_error("o80: the status of segment id " +
+                                 segment_id_ + " has an incompatible version");
+    }
+}
+
+SegmentStatus::~SegmentStatus()
+{
+    if (record_ == nullptr)
+    {
+        return;
+    }
+    if (leader_)
+    {
+        record_->stopped.store(1, std::memory_order_release);
+        // unlinking only if not already replaced by a new backend
+        struct stat status;
+        int fd = shm_open(name(segment_id_).c_str(), O_RDONLY, 0);
+        if (fd >= 0)
+        {
+            if (fstat(fd, &status) == 0 &&
+                static_cast<std::uint64_t>(status.st_ino) == inode_)
+            {
+                shm_unlink(name(segment_id_).c_str());
+            }
+            close(fd);
+        }
+    }
+    munmap(record_, sizeof(StatusRecord));
+}
+
+void SegmentStatus::map(int fd, bool read_only)
+{
+    void* memory =
+        mmap(nullptr,
+             sizeof(StatusRecord),
+             read_only ? PROT_READ : PROT_READ | PROT_WRITE,
+             MAP_SHARED,
+             fd,
+             0);
+    close(fd);
+    if (memory == MAP_FAILED)
+    {
+        throw std::runtime_error("o80: failed to map " + name(segment_id_) +
+                                 ": " + std::strerror(errno));
+    }
+    record_ = static_cast<StatusRecord*>(memory);
+}
+
+void SegmentStatus::update(long int iteration,
+                           bool active,
+                           long int nb_commands)
+{
+    std::int64_t stamp = time_now().count();
+    if (previous_stamp_ns_ >= 0)
+    {
+        std::int64_t period = stamp - previous_stamp_ns_;
+        std::int64_t mean =
+            record_->mean_period_ns.load(std::memory_order_relaxed);
+        std::int64_t jitter = record_->jitter_ns.load(std::memory_order_relaxed);
+        if (mean == 0)
+        {
+            mean = period;
+        }
+        mean += (period - mean) / STATUS_SMOOTHING;
+        jitter += (std::abs(period - mean) - jitter) / STATUS_SMOOTHING;
+        record_->mean_period_ns.store(mean, std::memory_order_relaxed);
+        record_->jitter_ns.store(jitter, std::memory_order_relaxed);
+        if (record_->period_us > 0 && period > record_->period_us * 1100.)
+        {
+            record_->overruns.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    previous_stamp_ns_ = stamp;
+    record_->iteration.store(iteration, std::memory_order_relaxed);
+    record_->active.store(active ? 1 : 0, std::memory_order_relaxed);
+    record_->nb_commands.store(nb_commands, std::memory_order_relaxed);
+    record_->stamp_ns.store(stamp, std::memory_order_release);
+}
+
+void SegmentStatus::set_queue_depth(int dof, int depth)
+{
+    if (dof < MAX_STATUS_ACTUATORS)
+    {
+        record_->queue_depths[dof].store(depth, std::memory_order_relaxed);
+    }
+}
+
+int SegmentStatus::attach_frontend()
+{
+    std::int64_t pid = getpid();
+    for (int slot = 0; slot < MAX_STATUS_FRONTENDS; slot++)
+    {
+        std::int64_t current = record_->frontends[slot].load();
+        // free slot, or slot of a frontend which exited
+        // without detaching
+        if ((current == 0 || !process_is_running(current)) &&
+            record_->frontends[slot].compare_exchange_strong(current, pid))
+        {
+            // not notifying the pipe of the previous frontend
+            record_->readiness_events[slot].store(0);
+            return slot;
+        }
+    }
+    return -1;
+}
+
+void SegmentStatus::detach_frontend(int slot)
+{
+    if (slot >= 0 && slot < MAX_STATUS_FRONTENDS)
+    {
+        record_->readiness_events[slot].store(0);
+        record_->frontends[slot].store(0);
+    }
+}
+
+void SegmentStatus::set_readiness(int slot,
+                                  std::int32_t listener_id,
+                                  int events)
+{
+    if (slot >= 0 && slot < MAX_STATUS_FRONTENDS)
+    {
+        // the backend reads the id after the events
+        record_->readiness_pending[slot].store(0, std::memory_order_relaxed);
+        record_->readiness_ids[slot].store(listener_id,
+                                           std::memory_order_relaxed);
+        record_->readiness_events[slot].store(events,
+                                              std::memory_order_release);
+    }
+}
+
+int SegmentStatus::clear_readiness(int slot)
+{
+    if (slot < 0 || slot >= MAX_STATUS_FRONTENDS)
+    {
+        return 0;
+    }
+    return record_->readiness_pending[slot].exchange(0);
+}
+
+const StatusRecord& SegmentStatus::record() const
+{
+    return *record_;
+}
+
+StatusRecord& SegmentStatus::record()
+{
+    return *record_;
+}
+
+int SegmentStatus::nb_frontends() const
+{
+    int nb_frontends = 0;
+    for (int slot = 0; slot < MAX_STATUS_FRONTENDS; slot++)
+    {
+        if (process_is_running(record_->frontends[slot].load()))
+        {
+            nb_frontends++;
+        }
+    }
+    return nb_frontends;
+}
+
+bool SegmentStatus::is_alive() const
+{
+    return record_->stopped.load(std::memory_order_acquire) == 0 &&
+           process_is_running(record_->pid);
+}
+
+std::vector<std::string> SegmentStatus::list()
+{
+    std::vector<std::string> segment_ids;
+    DIR* directory = opendir("/dev/shm");
+    if (directory == nullptr)
+    {
+        return segment_ids;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(directory)) != nullptr)
+    {
+        std::string file(entry->d_name);
+        if (file.size() > STATUS_SUFFIX.size() &&
+            file.compare(file.size() - STATUS_SUFFIX.size(),
+                         STATUS_SUFFIX.size(),
+                         STATUS_SUFFIX) == 0)
+        {
+            segment_ids.push_back(
+                file.substr(0, file.size() - STATUS_SUFFIX.size()));
+        }
+    }
+    closedir(directory);
+    std::sort(segment_ids.begin(), segment_ids.end());
+    return segment_ids;
+}
+
+std::string SegmentStatus::name(const std::string& segment_id)
+{
+    return std::string("/") + segment_id + STATUS_SUFFIX;
+}
+
+void SegmentStatus::clear(const std::string& segment_id)
+{
+    shm_unlink(name(segment_id).c_str());
+}
+
+}  // namespace internal
+}  // namespace o80
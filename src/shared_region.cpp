@@ -0,0 +1,756 @@
+// Copyright (C) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#include "o80_internal/shared_region.hpp"
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include "o80/time.hpp"
+
+namespace o80
+{
+namespace internal
+{
+static const std::uint64_t REGION_MAGIC = 0x6f38305f72656731;  // o80_reg1
+static const std::uint32_t REGION_VERSION = 3;
+static const std::size_t REGION_ALIGNMENT = 64;
+
+static std::size_t align(std::size_t size)
+{
+    return ((size + REGION_ALIGNMENT - 1) / REGION_ALIGNMENT) *
+           REGION_ALIGNMENT;
+}
+
+// entry of the directory of the rings. Each ring has its own
+// cache line, as written by different processes
+struct alignas(64) RingEntry
+{
+    std::atomic<std::int64_t> newest;
+    std::uint64_t offset;
+    // 0 if the ring is disabled
+    std::uint64_t capacity;
+    std::uint64_t item_size;
+    std::uint64_t stride;
+};
+
+// followed by item_size bytes
+struct SlotHeader
+{
+    // index of the item hosted by the slot, -1 if empty,
+    // -2 while being written
+    std::atomic<std::int64_t> index;
+    double timestamp_ms;
+    std::uint64_t size;
+};
+
+struct RegionHeader
+{
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::atomic<std::uint32_t> ready;
+    std::uint64_t size;
+    std::uint64_t commands_size;
+    std::uint64_t observations_size;
+    std::uint64_t completed_size;
+    std::uint64_t introspection_size;
+    std::uint64_t trace_size;
+
+    // process running the backend
+    OwnerRecord owner;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t condition;
+    long int nb_waiters;
+
+    // control block
+    alignas(64) std::atomic<long int> pulse_id;
+    std::atomic<std::int64_t> command_read;
+    std::atomic<bool> purge;
+    std::atomic<bool> active;
+
+    // bursting (protected by the mutex)
+    long int nb_iterations;
+    long int requested;
+    long int done;
+    bool released;
+
+    // serialized initial states (protected by the mutex)
+    std::uint64_t initial_states_offset;
+    std::uint64_t initial_states_capacity;
+    // 0 if not set yet
+    std::uint64_t initial_states_size;
+
+    RingEntry rings[NB_REGION_RINGS];
+};
+
+namespace
+{
+void recover(pthread_mutex_t* mutex, int status)
+{
+    // a process died while holding the lock, the data it protects
+    // are only counters, which remain consistent
+    if (status == EOWNERDEAD)
+    {
+        pthread_mutex_consistent(mutex);
+    }
+}
+
+class RegionLock
+{
+public:
+    RegionLock(RegionHeader* header) : header_(header)
+    {
+        int status = pthread_mutex_lock(&header_->mutex);
+        if (status != 0 && status != EOWNERDEAD)
+        {
+            throw std::runtime_error(
+                "o80 shared region: failed to lock the mutex");
+        }
+        recover(&header_->mutex, status);
+    }
+
+    ~RegionLock()
+    {
+        pthread_mutex_unlock(&header_->mutex);
+    }
+
+    // waits until predicate returns true or the deadline (if any) passed,
+    // returns the value of predicate
+    template <class Predicate>
+    bool wait(Predicate predicate, const timespec* deadline = nullptr)
+    {
+        header_->nb_waiters++;
+        while (!predicate())
+        {
+            int status;
+            if (deadline == nullptr)
+            {
+                status =
+                    pthread_cond_wait(&header_->condition, &header_->mutex);
+            }
+            else
+            {
+                status = pthread_cond_timedwait(
+                    &header_->condition, &header_->mutex, deadline);
+            }
+            recover(&header_->mutex, status);
+            if (status == ETIMEDOUT)
+            {
+                break;
+            }
+        }
+        header_->nb_waiters--;
+        return predicate();
+    }
+
+    void notify()
+    {
+        if (header_->nb_waiters > 0)
+        {
+            pthread_cond_broadcast(&header_->condition);
+        }
+    }
+
+private:
+    RegionHeader* header_;
+};
+}  // namespace
+
+SharedRegion::SharedRegion(const std::string& segment_id,
+                           const SegmentLayout& layout,
+                           const ItemSizes& item_sizes,
+                           std::size_t initial_states_size,
+                           std::uint64_t generation)
+    : segment_id_(segment_id),
+      size_(0),
+      memory_(nullptr),
+      header_(nullptr),
+      layout_(layout),
+      huge_pages_(false),
+      locked_(false)
+{
+    std::size_t capacities[NB_REGION_RINGS] = {layout.commands_size,
+                                               layout.observations_size,
+                                               layout.completed_size,
+                                               layout.introspection_size,
+                                               layout.introspection_size,
+                                               layout.introspection_size,
+                                               layout.introspection_size,
+                                               layout.trace_size};
+
+    // computing the offsets of the initial states and of the rings
+    std::size_t offset = align(sizeof(RegionHeader));
+    std::size_t initial_states_offset = offset;
+    offset += align(initial_states_size);
+    std::size_t offsets[NB_REGION_RINGS];
+    std::size_t strides[NB_REGION_RINGS];
+    for (int ring = 0; ring < NB_REGION_RINGS; ring++)
+    {
+        offsets[ring] = offset;
+        strides[ring] = align(sizeof(SlotHeader) + item_sizes[ring]);
+        offset += strides[ring] * capacities[ring];
+    }
+    std::size_t size = offset;
+
+    clear(segment_id_);
+    if (layout.huge_pages)
+    {
+        huge_pages_ = create_huge_pages(size, layout.prefault);
+    }
+    if (!huge_pages_)
+    {
+        create_regular_pages(size, layout.huge_pages);
+    }
+    if (layout.prefault)
+    {
+        prefault_and_lock();
+    }
+
+    header_ = new (memory_) RegionHeader;
+    header_->magic = REGION_MAGIC;
+    header_->version = REGION_VERSION;
+    header_->size = size;
+    header_->commands_size = layout.commands_size;
+    header_->observations_size = layout.observations_size;
+    header_->completed_size = layout.completed_size;
+    header_->introspection_size = layout.introspection_size;
+    header_->trace_size = layout.trace_size;
+    new (&header_->owner) OwnerRecord;
+    header_->owner.claim(generation);
+
+    pthread_mutexattr_t mutex_attributes;
+    pthread_mutexattr_init(&mutex_attributes);
+    pthread_mutexattr_setpshared(&mutex_attributes, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&mutex_attributes, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&header_->mutex, &mutex_attributes);
+    pthread_mutexattr_destroy(&mutex_attributes);
+
+    pthread_condattr_t condition_attributes;
+    pthread_condattr_init(&condition_attributes);
+    pthread_condattr_setpshared(&condition_attributes, PTHREAD_PROCESS_SHARED);
+    pthread_condattr_setclock(&condition_attributes, CLOCK_MONOTONIC);
+    pthread_cond_init(&header_->condition, &condition_attributes);
+    pthread_condattr_destroy(&condition_attributes);
+    header_->nb_waiters = 0;
+
+    header_->pulse_id.store(0);
+    header_->command_read.store(-1);
+    header_->purge.store(false);
+    header_->active.store(false);
+
+    header_->nb_iterations = 0;
+    header_->requested = 0;
+    header_->done = 0;
+    header_->released = false;
+
+    header_->initial_states_offset = initial_states_offset;
+    header_->initial_states_capacity = initial_states_size;
+    header_->initial_states_size = 0;
+
+    for (int ring = 0; ring < NB_REGION_RINGS; ring++)
+    {
+        RingEntry& entry = header_->rings[ring];
+        entry.newest.store(time_series::EMPTY);
+        entry.offset = offsets[ring];
+        entry.capacity = capacities[ring];
+        entry.item_size = item_sizes[ring];
+        entry.stride = strides[ring];
+        for (std::size_t index = 0; index < entry.capacity; index++)
+        {
+            SlotHeader* slot_header = new (memory_ + entry.offset +
+                                           index * entry.stride) SlotHeader;
+            slot_header->index.store(-1);
+            slot_header->timestamp_ms = 0;
+            slot_header->size = 0;
+        }
+    }
+
+    header_->ready.store(1, std::memory_order_release);
+}
+
+SharedRegion::SharedRegion(const std::string& segment_id)
+    : segment_id_(segment_id),
+      size_(0),
+      memory_(nullptr),
+      header_(nullptr),
+      huge_pages_(false),
+      locked_(false)
+{
+    std::string region_name = name(segment_id_);
+    int fd = shm_open(region_name.c_str(), O_RDWR, 0);
+    if (fd < 0)
+    {
+        // the backend may have created the region in hugetlbfs
+        std::string path = huge_pages_path(segment_id_);
+        if (!path.empty())
+        {
+            fd = open(path.c_str(), O_RDWR);
+            huge_pages_ = fd >= 0;
+        }
+    }
+    if (fd < 0)
+    {
+        throw std::runtime_error("o80: no shared region " + region_name +
+                                 " (is the backend running ?)");
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0 ||
+        static_cast<std::size_t>(status.st_size) < sizeof(RegionHeader))
+    {
+        close(fd);
+        throw std::runtime_error("o80: shared region " + region_name +
+                                 " is not initialized");
+    }
+    map(fd, status.st_size);
+    close(fd);
+
+    header_ = reinterpret_cast<RegionHeader*>(memory_);
+    if (header_->ready.load(std::memory_order_acquire) != 1 ||
+        header_->magic != REGION_MAGIC || header_->version != REGION_VERSION)
+    {
+        munmap(memory_, size_);
+        throw std::runtime_error("o80: shared region " + region_name +
+                                 " is not initialized or has an "
+                                 "incompatible version");
+    }
+    layout_ = SegmentLayout(header_->commands_size,
+                            header_->observations_size,
+                            header_->completed_size,
+                            header_->introspection_size,
+                            header_->trace_size);
+}
+
+SharedRegion::~SharedRegion()
+{
+    if (memory_ != nullptr)
+    {
+        munmap(memory_, size_);
+    }
+}
+
+void SharedRegion::map(int fd, std::size_t size)
+{
+    void* memory =
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (memory == MAP_FAILED)
+    {
+        std::string error = std::strerror(errno);
+        close(fd);
+        throw std::runtime_error("o80 shared region: failed to map " +
+                                 name(segment_id_) + ": " + error);
+    }
+    memory_ = static_cast<char*>(memory);
+    size_ = size;
+}
+
+bool SharedRegion::create_huge_pages(std::size_t size, bool prefault)
+{
+    std::string path = huge_pages_path(segment_id_);
+    if (path.empty())
+    {
+        return false;
+    }
+    int fd = open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0666);
+    if (fd < 0)
+    {
+        return false;
+    }
+    // the size of a hugetlbfs file is a multiple of the huge page size
+    struct statfs file_system;
+    std::size_t huge_size = 0;
+    if (fstatfs(fd, &file_system) == 0 && file_system.f_bsize > 0)
+    {
+        std::size_t page_size = file_system.f_bsize;
+        huge_size = ((size + page_size - 1) / page_size) * page_size;
+    }
+    if (huge_size == 0 || ftruncate(fd, huge_size) != 0)
+    {
+        close(fd);
+        unlink(path.c_str());
+        return false;
+    }
+    // huge pages are reserved when mapping, so mmap fails
+    // if not enough of them are available
+    int flags = MAP_SHARED;
+    if (prefault)
+    {
+        flags |= MAP_POPULATE;
+    }
+    void* memory =
+        mmap(nullptr, huge_size, PROT_READ | PROT_WRITE, flags, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED)
+    {
+        unlink(path.c_str());
+        return false;
+    }
+    memory_ = static_cast<char*>(memory);
+    size_ = huge_size;
+    return true;
+}
+
+void SharedRegion::create_regular_pages(std::size_t size, bool huge_pages)
+{
+    std::string region_name = name(segment_id_);
+    int fd = shm_open(region_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0666);
+    if (fd < 0)
+    {
+        throw std::runtime_error("o80 shared region: failed to create " +
+                                 region_name + ": " + std::strerror(errno));
+    }
+    if (ftruncate(fd, size) != 0)
+    {
+        std::string error = std::strerror(errno);
+        close(fd);
+        shm_unlink(region_name.c_str());
+        throw std::runtime_error("o80 shared region: failed to allocate " +
+                                 std::to_string(size) + " bytes for " +
+                                 region_name + ": " + error);
+    }
+    map(fd, size);
+    close(fd);
+#ifdef MADV_HUGEPAGE
+    if (huge_pages)
+    {
+        // transparent huge pages, used only if enabled for shared memory
+        // (see /sys/kernel/mm/transparent_hugepage/shmem_enabled)
+        madvise(memory_, size_, MADV_HUGEPAGE);
+    }
+#endif
+}
+
+void SharedRegion::prefault_and_lock()
+{
+    // the region has just been created and is zeroed:
+    // writing 0 once per page does not change its content
+    std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    volatile char* memory = memory_;
+    for (std::size_t offset = 0; offset < size_; offset += page_size)
+    {
+        memory[offset] = 0;
+    }
+    locked_ = mlock(memory_, size_) == 0;
+}
+
+std::string SharedRegion::name(const std::string& segment_id)
+{
+    return std::string("/") + segment_id + std::string("_region");
+}
+
+std::string SharedRegion::huge_pages_path(const std::string& segment_id)
+{
+    std::ifstream mounts("/proc/mounts");
+    std::string line;
+    while (std::getline(mounts, line))
+    {
+        std::istringstream fields(line);
+        std::string device, mount_point, type;
+        fields >> device >> mount_point >> type;
+        if (type == "hugetlbfs")
+        {
+            return mount_point + name(segment_id);
+        }
+    }
+    return std::string();
+}
+
+void SharedRegion::clear(const std::string& segment_id)
+{
+    shm_unlink(name(segment_id).c_str());
+    std::string path = huge_pages_path(segment_id);
+    if (!path.empty())
+    {
+        unlink(path.c_str());
+    }
+}
+
+void SharedRegion::release(const std::string& segment_id)
+{
+    try
+    {
+        SharedRegion region(segment_id);
+        region.release();
+    }
+    catch (const std::runtime_error&)
+    {
+    }
+}
+
+const SegmentLayout& SharedRegion::get_layout() const
+{
+    return layout_;
+}
+
+std::size_t SharedRegion::size() const
+{
+    return size_;
+}
+
+OwnerRecord& SharedRegion::owner() const
+{
+    return header_->owner;
+}
+
+bool SharedRegion::has_huge_pages() const
+{
+    return huge_pages_;
+}
+
+bool SharedRegion::is_locked() const
+{
+    return locked_;
+}
+
+char* SharedRegion::slot(RegionRing ring, time_series::Index index) const
+{
+    const RingEntry& entry = header_->rings[ring];
+    return memory_ + entry.offset + (index % entry.capacity) * entry.stride;
+}
+
+bool SharedRegion::has_ring(RegionRing ring) const
+{
+    return header_->rings[ring].capacity > 0;
+}
+
+std::size_t SharedRegion::capacity(RegionRing ring) const
+{
+    return header_->rings[ring].capacity;
+}
+
+time_series::Index SharedRegion::newest(RegionRing ring) const
+{
+    return header_->rings[ring].newest.load(std::memory_order_acquire);
+}
+
+time_series::Index SharedRegion::append(RegionRing ring,
+                                        const std::string& item)
+{
+    RingEntry& entry = header_->rings[ring];
+    if (item.size() > entry.item_size)
+    {
+        throw std::runtime_error(
+            "o80 shared region: item larger than the slots of the ring");
+    }
+    double timestamp_ms = static_cast<double>(time_now().count()) / 1e6;
+
+    RegionLock lock(header_);
+    time_series::Index index =
+        entry.newest.load(std::memory_order_relaxed) + 1;
+    SlotHeader* slot_header = reinterpret_cast<SlotHeader*>(slot(ring, index));
+    slot_header->index.store(-2, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot_header->timestamp_ms = timestamp_ms;
+    slot_header->size = item.size();
+    std::memcpy(reinterpret_cast<char*>(slot_header) + sizeof(SlotHeader),
+                item.data(),
+                item.size());
+    slot_header->index.store(index, std::memory_order_release);
+    entry.newest.store(index, std::memory_order_release);
+    lock.notify();
+    return index;
+}
+
+void SharedRegion::read(RegionRing ring,
+                        time_series::Index index,
+                        std::string& item,
+                        double& timestamp_ms) const
+{
+    if (index >= 0)
+    {
+        wait_for(ring, index, std::numeric_limits<double>::quiet_NaN());
+        const SlotHeader* slot_header =
+            reinterpret_cast<const SlotHeader*>(slot(ring, index));
+        if (slot_header->index.load(std::memory_order_acquire) == index)
+        {
+            std::size_t size = std::min<std::size_t>(
+                slot_header->size, header_->rings[ring].item_size);
+            timestamp_ms = slot_header->timestamp_ms;
+            item.assign(
+                reinterpret_cast<const char*>(slot_header) + sizeof(SlotHeader),
+                size);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            // the slot has not been overwritten during the copy
+            if (slot_header->index.load(std::memory_order_relaxed) == index)
+            {
+                return;
+            }
+        }
+    }
+    throw std::invalid_argument("o80 shared region: item " +
+                                std::to_string(index) +
+                                " is not available (too old)");
+}
+
+bool SharedRegion::wait_for(RegionRing ring,
+                            time_series::Index index,
+                            double max_duration_s) const
+{
+    const RingEntry& entry = header_->rings[ring];
+    auto appended = [&entry, index]() {
+        return entry.newest.load(std::memory_order_acquire) >= index;
+    };
+    if (appended())
+    {
+        return true;
+    }
+    RegionLock lock(header_);
+    if (std::isnan(max_duration_s))
+    {
+        return lock.wait(appended);
+    }
+    timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    long int nanoseconds = static_cast<long int>(max_duration_s * 1e9);
+    deadline.tv_sec += nanoseconds / 1000000000L;
+    deadline.tv_nsec += nanoseconds % 1000000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    return lock.wait(appended, &deadline);
+}
+
+long int SharedRegion::get_pulse_id() const
+{
+    return header_->pulse_id.load();
+}
+
+void SharedRegion::set_pulse_id(long int pulse_id)
+{
+    header_->pulse_id.store(pulse_id);
+}
+
+time_series::Index SharedRegion::get_command_read() const
+{
+    return header_->command_read.load();
+}
+
+void SharedRegion::set_command_read(time_series::Index index)
+{
+    header_->command_read.store(index);
+}
+
+bool SharedRegion::get_purge() const
+{
+    return header_->purge.load();
+}
+
+void SharedRegion::set_purge(bool purge)
+{
+    header_->purge.store(purge);
+}
+
+bool SharedRegion::get_active() const
+{
+    return header_->active.load();
+}
+
+void SharedRegion::set_active(bool active)
+{
+    header_->active.store(active);
+}
+
+void SharedRegion::set_initial_states(const std::string& initial_states)
+{
+    if (initial_states.size() > header_->initial_states_capacity)
+    {
+        throw std::runtime_error(
+            "o80 shared region: initial states larger than expected");
+    }
+    RegionLock lock(header_);
+    std::memcpy(memory_ + header_->initial_states_offset,
+                initial_states.data(),
+                initial_states.size());
+    header_->initial_states_size = initial_states.size();
+}
+
+bool SharedRegion::get_initial_states(std::string& initial_states) const
+{
+    RegionLock lock(header_);
+    if (header_->initial_states_size == 0)
+    {
+        return false;
+    }
+    initial_states.assign(memory_ + header_->initial_states_offset,
+                          header_->initial_states_size);
+    return true;
+}
+
+void SharedRegion::burst(int nb_iterations)
+{
+    RegionLock lock(header_);
+    if (header_->released)
+    {
+        return;
+    }
+    header_->nb_iterations = nb_iterations;
+    header_->requested++;
+    long int request = header_->requested;
+    lock.notify();
+    RegionHeader* header = header_;
+    lock.wait([header, request]() {
+        return header->done >= request || header->released;
+    });
+}
+
+void SharedRegion::final_burst()
+{
+    RegionLock lock(header_);
+    // the standalone runs one more iteration, then exits
+    header_->nb_iterations = 1;
+    header_->released = true;
+    lock.notify();
+}
+
+long int SharedRegion::get_bursting()
+{
+    RegionLock lock(header_);
+    long int nb_iterations = header_->nb_iterations;
+    header_->nb_iterations = 0;
+    return nb_iterations;
+}
+
+void SharedRegion::reset_bursting()
+{
+    RegionLock lock(header_);
+    header_->nb_iterations = 0;
+}
+
+bool SharedRegion::wait_for_burst()
+{
+    RegionLock lock(header_);
+    // reporting the latest burst as done
+    header_->done = header_->requested;
+    lock.notify();
+    RegionHeader* header = header_;
+    lock.wait([header]() {
+        return header->requested > header->done || header->released;
+    });
+    return !header_->released;
+}
+
+void SharedRegion::release()
+{
+    RegionLock lock(header_);
+    header_->released = true;
+    lock.notify();
+}
+
+}  // namespace internal
+}  // namespace o80
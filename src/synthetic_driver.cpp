@@ -0,0 +1,130 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#include "o80/synthetic_driver.hpp"
+#include <sstream>
+#include <thread>
+#include "o80/time.hpp"
+
+namespace o80
+{
+SyntheticDriverConfig::SyntheticDriverConfig()
+    : get_us(0),
+      set_us(0),
+      jitter(NO_JITTER),
+      jitter_us(0),
+      stall_probability(0),
+      stall_us(0),
+      busy_wait(false),
+      seed(0)
+{
+}
+
+std::string SyntheticDriverConfig::to_string() const
+{
+    static const char* distributions[] = {
+        "none", "uniform", "normal", "exponential"};
+    std::ostringstream s;
+    s << "get: " << get_us << "us set: " << set_us << "us jitter: "
+      << distributions[jitter] << " (" << jitter_us
+      << "us) stalls: " << stall_probability << " (" << stall_us << "us)";
+    if (busy_wait)
+    {
+        s << " (busy wait)";
+    }
+    return s.str();
+}
+
+SyntheticDriver::SyntheticDriver(SyntheticDriverConfig config)
+    : config_(config),
+      generator_(config.seed),
+      uniform_(0., 1.),
+      normal_(0., 1.),
+      exponential_(1.),
+      nb_gets_(0),
+      nb_sets_(0),
+      nb_stalls_(0)
+{
+}
+
+void SyntheticDriver::start()
+{
+}
+
+void SyntheticDriver::stop()
+{
+}
+
+void SyntheticDriver::spend(double cost_us)
+{
+    switch (config_.jitter)
+    {
+        case NO_JITTER:
+            break;
+        case UNIFORM_JITTER:
+            cost_us += config_.jitter_us * (2. * uniform_(generator_) - 1.);
+            break;
+        case NORMAL_JITTER:
+            cost_us += config_.jitter_us * normal_(generator_);
+            break;
+        case EXPONENTIAL_JITTER:
+            cost_us += config_.jitter_us * exponential_(generator_);
+            break;
+    }
+    if (config_.stall_probability > 0 &&
+        uniform_(generator_) < config_.stall_probability)
+    {
+        cost_us += config_.stall_us;
+        nb_stalls_++;
+    }
+    if (cost_us <= 0)
+    {
+        return;
+    }
+    Nanoseconds cost(static_cast<long int>(cost_us * 1e3));
+    if (!config_.busy_wait)
+    {
+        std::this_thread::sleep_for(cost);
+        return;
+    }
+    TimePoint end = time_now() + cost;
+    while (time_now() < end)
+    {
+    }
+}
+
+void SyntheticDriver::set(const std::vector<double>& values)
+{
+    spend(config_.set_us);
+    values_ = values;
+    nb_sets_++;
+}
+
+std::vector<double> SyntheticDriver::get()
+{
+    spend(config_.get_us);
+    nb_gets_++;
+    return values_;
+}
+
+const SyntheticDriverConfig& SyntheticDriver::get_config() const
+{
+    return config_;
+}
+
+long int SyntheticDriver::nb_gets() const
+{
+    return nb_gets_.load();
+}
+
+long int SyntheticDriver::nb_sets() const
+{
+    return nb_sets_.load();
+}
+
+long int SyntheticDriver::nb_stalls() const
+{
+    return nb_stalls_.load();
+}
+
+}  // namespace o80
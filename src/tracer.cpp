@@ -0,0 +1,633 @@
+// Copyright (c) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#include "o80/tracer.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include "o80/time.hpp"
+#include "o80_internal/trace_ring.hpp"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace o80
+{
+static_assert(sizeof(TraceRecord) == 16, "unexpected padding");
+
+static const char TRACE_FILE_MAGIC[8] = "o80trc1";
+static const std::size_t MAX_TRACED_SEGMENTS = 64;
+// offset of the records in the file
+static const std::size_t TRACE_RECORDS_OFFSET = 8192;
+// initial capacity (in records) of the file, doubled when full
+static const std::size_t TRACE_FILE_CAPACITY = 65536;
+
+static const char* ACTION_NAMES[] = {"frontend_wait_start",
+                                     "frontend_wait_end",
+                                     "frontend_communicate",
+                                     "frontend_read",
+                                     "frontend_completion_wait_start",
+                                     "frontend_completion_wait_end",
+                                     "backend_read",
+                                     "backend_write_reapply",
+                                     "backend_write_new"};
+
+struct TracedSegment
+{
+    std::uint32_t hash;
+    char name[60];
+};
+
+// start of the file written by the tracer, followed (at offset
+// TRACE_RECORDS_OFFSET) by nb_records instances of TraceRecord.
+// The time stamp counter is converted to steady clock nanoseconds via
+// two (time stamp counter, nanoseconds) samples taken at start and at
+// the latest drain.
+struct TraceFileHeader
+{
+    char magic[8];
+    std::int64_t pid;
+    std::uint64_t nb_records;
+    std::uint64_t nb_dropped;
+    std::uint64_t tsc_start;
+    std::int64_t ns_start;
+    std::uint64_t tsc_latest;
+    std::int64_t ns_latest;
+    std::uint64_t nb_segments;
+    TracedSegment segments[MAX_TRACED_SEGMENTS];
+};
+static_assert(sizeof(TraceFileHeader) <= TRACE_RECORDS_OFFSET,
+              "trace file header too large");
+
+static std::uint64_t read_tsc()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return time_now().count();
+#endif
+}
+
+// (time stamp counter, steady clock nanoseconds) sampled
+// at (almost) the same time
+static void sample_clocks(std::uint64_t& tsc, std::int64_t& ns)
+{
+    std::int64_t before = time_now().count();
+    tsc = read_tsc();
+    std::int64_t after = time_now().count();
+    ns = before + (after - before) / 2;
+}
+
+static std::uint32_t fnv1a(const std::string& s)
+{
+    std::uint32_t hash = 2166136261u;
+    for (char c : s)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+namespace internal
+{
+TraceRing::TraceRing(std::size_t capacity, std::uint16_t thread)
+    : thread_(thread), head_(0), cached_tail_(0), nb_dropped_(0), tail_(0)
+{
+    std::size_t size = 1;
+    while (size < capacity)
+    {
+        size *= 2;
+    }
+    records_.resize(size);
+    mask_ = size - 1;
+}
+
+bool TraceRing::push(const TraceRecord& record)
+{
+    std::uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head - cached_tail_ >= records_.size())
+    {
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        if (head - cached_tail_ >= records_.size())
+        {
+            nb_dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    records_[head & mask_] = record;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+std::size_t TraceRing::pop(std::vector<TraceRecord>& records)
+{
+    std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+    std::uint64_t head = head_.load(std::memory_order_acquire);
+    for (std::uint64_t index = tail; index < head; index++)
+    {
+        records.push_back(records_[index & mask_]);
+    }
+    tail_.store(head, std::memory_order_release);
+    return head - tail;
+}
+
+std::uint16_t TraceRing::thread() const
+{
+    return thread_;
+}
+
+long int TraceRing::nb_dropped() const
+{
+    return nb_dropped_.load(std::memory_order_relaxed);
+}
+
+/**
+ * ! File written by the drain thread of the tracer, mapped in memory
+ *   and grown (doubled) when full.
+ */
+class MappedTraceFile
+{
+public:
+    MappedTraceFile(const std::string& path) : capacity_(0), memory_(nullptr)
+    {
+        fd_ = open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+        if (fd_ < 0)
+        {
+            throw std::runtime_error("o80 tracer: failed to create " + path +
+                                     ": " + std::strerror(errno));
+        }
+        if (!map(TRACE_FILE_CAPACITY))
+        {
+            std::string error = std::strerror(errno);
+            close(fd_);
+            throw std::runtime_error("o80 tracer: failed to map " + path +
+                                     ": " + error);
+        }
+        TraceFileHeader& h = header();
+        std::memset(&h, 0, sizeof(TraceFileHeader));
+        std::memcpy(h.magic, TRACE_FILE_MAGIC, sizeof(h.magic));
+        h.pid = getpid();
+    }
+
+    ~MappedTraceFile()
+    {
+        std::size_t nb_records = header().nb_records;
+        munmap(memory_, size(capacity_));
+        // removing the unused capacity
+        if (ftruncate(fd_, size(nb_records)) != 0)
+        {
+            // the file remains readable (nb_records is in the header)
+        }
+        close(fd_);
+    }
+
+    TraceFileHeader& header()
+    {
+        return *reinterpret_cast<TraceFileHeader*>(memory_);
+    }
+
+    /*! returns false (and does not write the records) if the
+        file could not be grown*/
+    bool append(const std::vector<TraceRecord>& records)
+    {
+        std::size_t nb_records = header().nb_records;
+        if (nb_records + records.size() > capacity_)
+        {
+            std::size_t capacity = capacity_;
+            while (nb_records + records.size() > capacity)
+            {
+                capacity *= 2;
+            }
+            if (!map(capacity))
+            {
+                return false;
+            }
+        }
+        std::memcpy(memory_ + size(nb_records),
+                    records.data(),
+                    records.size() * sizeof(TraceRecord));
+        header().nb_records = nb_records + records.size();
+        return true;
+    }
+
+private:
+    static std::size_t size(std::size_t nb_records)
+    {
+        return TRACE_RECORDS_OFFSET + nb_records * sizeof(TraceRecord);
+    }
+
+    // (re)maps the file with the capacity, keeping the current
+    // mapping if it fails (e.g. no space left)
+    bool map(std::size_t capacity)
+    {
+        if (ftruncate(fd_, size(capacity)) != 0)
+        {
+            return false;
+        }
+        void* memory = mmap(nullptr,
+                            size(capacity),
+                            PROT_READ | PROT_WRITE,
+                            MAP_SHARED,
+                            fd_,
+                            0);
+        if (memory == MAP_FAILED)
+        {
+            return false;
+        }
+        if (memory_ != nullptr)
+        {
+            munmap(memory_, size(capacity_));
+        }
+        memory_ = static_cast<char*>(memory);
+        capacity_ = capacity;
+        return true;
+    }
+
+private:
+    int fd_;
+    std::size_t capacity_;
+    char* memory_;
+};
+
+// state of the tracer of the process
+struct TracerState
+{
+    std::mutex mutex;
+    // incremented at each start, so that threads create
+    // a new ring after a restart
+    std::atomic<std::uint64_t> session{0};
+    std::size_t ring_size = 0;
+    double period_ms = 0;
+    std::vector<std::shared_ptr<TraceRing>> rings;
+    std::map<std::uint32_t, std::string> segments;
+    std::unique_ptr<MappedTraceFile> file;
+    std::atomic<bool> draining{false};
+    std::unique_ptr<std::thread> drain_thread;
+    std::atomic<long int> nb_records{0};
+    std::atomic<long int> nb_dropped{0};
+    // records which could not be written to the file
+    long int nb_file_dropped = 0;
+};
+
+static TracerState& tracer_state()
+{
+    static TracerState state;
+    return state;
+}
+
+// ring of the calling thread for the current session
+struct ThreadRing
+{
+    std::uint64_t session = 0;
+    std::shared_ptr<TraceRing> ring;
+};
+static thread_local ThreadRing thread_ring;
+
+// moves the records of all rings to the file (drain thread only,
+// or after the drain thread stopped)
+static void drain(TracerState& state)
+{
+    std::vector<std::shared_ptr<TraceRing>> rings;
+    std::map<std::uint32_t, std::string> segments;
+    {
+        std::lock_guard<std::mutex> guard(state.mutex);
+        rings = state.rings;
+        segments = state.segments;
+    }
+    std::vector<TraceRecord> records;
+    long int nb_dropped = 0;
+    for (const std::shared_ptr<TraceRing>& ring : rings)
+    {
+        ring->pop(records);
+        nb_dropped += ring->nb_dropped();
+    }
+    if (!records.empty())
+    {
+        if (state.file->append(records))
+        {
+            state.nb_records += records.size();
+        }
+        else
+        {
+            state.nb_file_dropped += records.size();
+        }
+    }
+    nb_dropped += state.nb_file_dropped;
+    state.nb_dropped = nb_dropped;
+
+    TraceFileHeader& header = state.file->header();
+    header.nb_dropped = nb_dropped;
+    sample_clocks(header.tsc_latest, header.ns_latest);
+    if (header.nb_segments != segments.size())
+    {
+        std::size_t index = 0;
+        for (const auto& segment : segments)
+        {
+            if (index == MAX_TRACED_SEGMENTS)
+            {
+                break;
+            }
+            TracedSegment& traced = header.segments[index];
+            traced.hash = segment.first;
+            std::memset(traced.name, 0, sizeof(traced.name));
+            std::strncpy(
+                traced.name, segment.second.c_str(), sizeof(traced.name) - 1);
+            index++;
+        }
+        header.nb_segments = segments.size();
+    }
+}
+}  // namespace internal
+
+std::atomic<bool> Tracer::running_(false);
+
+void Tracer::start(const std::string& path,
+                   std::size_t ring_size,
+                   double period_ms)
+{
+    internal::TracerState& state = internal::tracer_state();
+    std::lock_guard<std::mutex> guard(state.mutex);
+    if (running_)
+    {
+        return;
+    }
+    state.file.reset(new internal::MappedTraceFile(path));
+    TraceFileHeader& header = state.file->header();
+    sample_clocks(header.tsc_start, header.ns_start);
+    header.tsc_latest = header.tsc_start;
+    header.ns_latest = header.ns_start;
+    state.ring_size = ring_size;
+    state.period_ms = period_ms;
+    state.rings.clear();
+    state.nb_records = 0;
+    state.nb_dropped = 0;
+    state.nb_file_dropped = 0;
+    state.session++;
+    state.draining = true;
+    state.drain_thread.reset(new std::thread([&state]() {
+        while (state.draining)
+        {
+            internal::drain(state);
+            std::this_thread::sleep_for(std::chrono::microseconds(
+                static_cast<long int>(state.period_ms * 1000)));
+        }
+    }));
+    running_ = true;
+}
+
+void Tracer::stop()
+{
+    internal::TracerState& state = internal::tracer_state();
+    {
+        std::lock_guard<std::mutex> guard(state.mutex);
+        if (!running_)
+        {
+            return;
+        }
+        running_ = false;
+        state.draining = false;
+    }
+    state.drain_thread->join();
+    state.drain_thread.reset();
+    internal::drain(state);
+    std::lock_guard<std::mutex> guard(state.mutex);
+    state.file.reset();
+    state.rings.clear();
+}
+
+bool Tracer::is_running()
+{
+    return running_;
+}
+
+long int Tracer::nb_records()
+{
+    return internal::tracer_state().nb_records;
+}
+
+long int Tracer::nb_dropped()
+{
+    return internal::tracer_state().nb_dropped;
+}
+
+std::uint32_t Tracer::register_segment(const std::string& segment_id)
+{
+    std::uint32_t hash = fnv1a(segment_id);
+    internal::TracerState& state = internal::tracer_state();
+    std::lock_guard<std::mutex> guard(state.mutex);
+    state.segments[hash] = segment_id;
+    return hash;
+}
+
+void Tracer::record(std::uint32_t segment, LogAction action)
+{
+    internal::TracerState& state = internal::tracer_state();
+    if (internal::thread_ring.session !=
+        state.session.load(std::memory_order_acquire))
+    {
+        // first record of this thread (since start)
+        std::lock_guard<std::mutex> guard(state.mutex);
+        if (!running_)
+        {
+            return;
+        }
+        internal::thread_ring.ring = std::make_shared<internal::TraceRing>(
+            state.ring_size, static_cast<std::uint16_t>(state.rings.size()));
+        internal::thread_ring.session = state.session;
+        state.rings.push_back(internal::thread_ring.ring);
+    }
+    TraceRecord record;
+    record.tsc = read_tsc();
+    record.segment = segment;
+    record.action = static_cast<std::uint16_t>(action);
+    record.thread = internal::thread_ring.ring->thread();
+    internal::thread_ring.ring->push(record);
+}
+
+std::string Tracer::action_name(LogAction action)
+{
+    if (action < 0 || action > BACKEND_WRITE_NEW)
+    {
+        return std::string("unknown");
+    }
+    return std::string(ACTION_NAMES[action]);
+}
+
+// records of a file, with their time stamp in steady clock nanoseconds
+struct TraceFile
+{
+    std::int64_t pid;
+    std::map<std::uint32_t, std::string> segments;
+    std::vector<std::pair<std::int64_t, TraceRecord>> records;
+};
+
+static TraceFile read_trace_file(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    TraceFileHeader header;
+    if (!file ||
+        !file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, TRACE_FILE_MAGIC, sizeof(header.magic)) != 0)
+    {
+        throw std::runtime_error("o80 tracer: " + path +
+                                 " is not a trace file");
+    }
+    TraceFile trace_file;
+    trace_file.pid = header.pid;
+    for (std::size_t index = 0;
+         index < std::min<std::size_t>(header.nb_segments, MAX_TRACED_SEGMENTS);
+         index++)
+    {
+        trace_file.segments[header.segments[index].hash] =
+            std::string(header.segments[index].name);
+    }
+    double ns_per_tick = 1.;
+    if (header.tsc_latest > header.tsc_start)
+    {
+        ns_per_tick = static_cast<double>(header.ns_latest - header.ns_start) /
+                      static_cast<double>(header.tsc_latest - header.tsc_start);
+    }
+    file.seekg(TRACE_RECORDS_OFFSET);
+    TraceRecord record;
+    for (std::uint64_t index = 0; index < header.nb_records; index++)
+    {
+        if (!file.read(reinterpret_cast<char*>(&record), sizeof(record)))
+        {
+            break;
+        }
+        double ticks = static_cast<double>(record.tsc) -
+                       static_cast<double>(header.tsc_start);
+        std::int64_t ns =
+            header.ns_start + static_cast<std::int64_t>(ticks * ns_per_tick);
+        trace_file.records.push_back(std::make_pair(ns, record));
+    }
+    std::stable_sort(trace_file.records.begin(),
+                     trace_file.records.end(),
+                     [](const std::pair<std::int64_t, TraceRecord>& a,
+                        const std::pair<std::int64_t, TraceRecord>& b) {
+                         return a.first < b.first;
+                     });
+    return trace_file;
+}
+
+static std::string json_escape(const std::string& s)
+{
+    std::string escaped;
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+        }
+        if (static_cast<unsigned char>(c) >= 0x20)
+        {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+long int Tracer::export_chrome_trace(const std::vector<std::string>& paths,
+                                     const std::string& json_path)
+{
+    std::vector<TraceFile> files;
+    std::int64_t origin = 0;
+    bool origin_set = false;
+    for (const std::string& path : paths)
+    {
+        files.push_back(read_trace_file(path));
+        if (!files.back().records.empty() &&
+            (!origin_set || files.back().records.front().first < origin))
+        {
+            origin = files.back().records.front().first;
+            origin_set = true;
+        }
+    }
+
+    std::ofstream json(json_path);
+    if (!json)
+    {
+        throw std::runtime_error("o80 tracer: failed to create " + json_path);
+    }
+    json << std::fixed << std::setprecision(3);
+    json << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&json, &first]() {
+        if (!first)
+        {
+            json << ",\n";
+        }
+        first = false;
+    };
+    long int nb_events = 0;
+    for (const TraceFile& file : files)
+    {
+        separator();
+        json << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << file.pid
+             << ",\"args\":{\"name\":\"o80 process " << file.pid << "\"}}";
+        for (const auto& stamped : file.records)
+        {
+            const TraceRecord& record = stamped.second;
+            LogAction action = static_cast<LogAction>(record.action);
+            auto segment = file.segments.find(record.segment);
+            std::string segment_id =
+                segment == file.segments.end()
+                    ? std::to_string(record.segment)
+                    : json_escape(segment->second);
+            std::string phase("i");
+            std::string name = action_name(action);
+            switch (action)
+            {
+                case FRONTEND_WAIT_START:
+                    phase = "B";
+                    name = "wait";
+                    break;
+                case FRONTEND_COMPLETION_WAIT_START:
+                    phase = "B";
+                    name = "completion wait";
+                    break;
+                case BACKEND_READ:
+                    phase = "B";
+                    name = "iteration";
+                    break;
+                case FRONTEND_WAIT_END:
+                case FRONTEND_COMPLETION_WAIT_END:
+                case BACKEND_WRITE_REAPPLY:
+                case BACKEND_WRITE_NEW:
+                    phase = "E";
+                    break;
+                default:
+                    break;
+            }
+            separator();
+            json << "{\"name\":\"" << name << "\",\"cat\":\"" << segment_id
+                 << "\",\"ph\":\"" << phase << "\",\"ts\":"
+                 << static_cast<double>(stamped.first - origin) / 1e3
+                 << ",\"pid\":" << file.pid << ",\"tid\":" << record.thread;
+            if (phase == "i")
+            {
+                json << ",\"s\":\"t\"";
+            }
+            json << ",\"args\":{\"segment\":\"" << segment_id
+                 << "\",\"action\":\"" << action_name(action) << "\"}}";
+            nb_events++;
+        }
+    }
+    json << "\n]}\n";
+    return nb_events;
+}
+
+}  // namespace o80
@@ -0,0 +1,162 @@
+#include "o80/transport.hpp"
+#include <map>
+
+namespace o80
+{
+namespace internal
+{
+InProcessSegment::InProcessSegment()
+    : nb_iterations_(0),
+      requested_(0),
+      done_(0),
+      released_(false),
+      retired_(false)
+{
+}
+
+InProcessSegment::~InProcessSegment()
+{
+    release();
+}
+
+void InProcessSegment::burst(int nb_iterations)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (released_)
+    {
+        return;
+    }
+    nb_iterations_ = nb_iterations;
+    requested_++;
+    long int request = requested_;
+    condition_.notify_all();
+    condition_.wait(lock, [this, request]() {
+        return done_ >= request || released_;
+    });
+}
+
+void InProcessSegment::final_burst()
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    // the standalone runs one more iteration, then exits
+    nb_iterations_ = 1;
+    released_ = true;
+    condition_.notify_all();
+}
+
+long int InProcessSegment::get_bursting()
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    long int nb_iterations = nb_iterations_;
+    nb_iterations_ = 0;
+    return nb_iterations;
+}
+
+void InProcessSegment::reset_bursting()
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    nb_iterations_ = 0;
+}
+
+bool InProcessSegment::wait_for_burst()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    // reporting the latest burst as done
+    done_ = requested_;
+    condition_.notify_all();
+    condition_.wait(lock, [this]() { return requested_ > done_ || released_; });
+    return !released_;
+}
+
+void InProcessSegment::release()
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    released_ = true;
+    condition_.notify_all();
+}
+
+void InProcessSegment::retire()
+{
+    retired_ = true;
+}
+
+bool InProcessSegment::retired() const
+{
+    return retired_;
+}
+
+typedef std::map<std::string, std::shared_ptr<InProcessSegment>>
+    InProcessSegments;
+
+// never destroyed, as backends owned by static instances (e.g. standalones
+// started via start_standalone) may unregister during static destruction
+static std::mutex& in_process_segments_mutex()
+{
+    static std::mutex* mutex = new std::mutex;
+    return *mutex;
+}
+
+static InProcessSegments& in_process_segments()
+{
+    static InProcessSegments* segments = new InProcessSegments;
+    return *segments;
+}
+
+void register_in_process_segment(const std::string& segment_id,
+                                 std::shared_ptr<InProcessSegment> segment)
+{
+    std::lock_guard<std::mutex> guard(in_process_segments_mutex());
+    InProcessSegments& segments = in_process_segments();
+    if (segments.find(segment_id) != segments.end())
+    {
+        std::string error("o80: an in process backend of segment id ");
+        error += segment_id;
+        error += std::string(" already exists");
+        throw std::runtime_error(error);
+    }
+    segments[segment_id] = segment;
+}
+
+std::shared_ptr<InProcessSegment> get_in_process_segment(
+    const std::string& segment_id)
+{
+    std::lock_guard<std::mutex> guard(in_process_segments_mutex());
+    InProcessSegments& segments = in_process_segments();
+    auto it = segments.find(segment_id);
+    if (it == segments.end())
+    {
+        return nullptr;
+    }
+    return it->second;
+}
+
+void unregister_in_process_segment(const std::string& segment_id)
+{
+    std::shared_ptr<InProcessSegment> segment;
+    {
+        std::lock_guard<std::mutex> guard(in_process_segments_mutex());
+        InProcessSegments& segments = in_process_segments();
+        auto it = segments.find(segment_id);
+        if (it == segments.end())
+        {
+            return;
+        }
+        segment = it->second;
+        segments.erase(it);
+    }
+    segment->retire();
+    segment->release();
+}
+
+void release_in_process_segment(const std::string& segment_id)
+{
+    std::shared_ptr<InProcessSegment> segment =
+        get_in_process_segment(segment_id);
+    if (segment != nullptr)
+    {
+        segment->release();
+    }
+}
+
+}  // namespace internal
+}  // namespace o80
@@ -0,0 +1,98 @@
+// Copyright (C) 2019 Max Planck Gesellschaft
+// Author : Vincent Berenz
+
+#include "o80_internal/worker_pool.hpp"
+
+namespace o80
+{
+namespace internal
+{
+WorkerPool::WorkerPool(int nb_workers)
+    : task_(nullptr),
+      nb_tasks_(0),
+      next_task_(0),
+      nb_done_(0),
+      error_(nullptr),
+      stopping_(false)
+{
+    for (int worker = 0; worker < nb_workers; worker++)
+    {
+        workers_.emplace_back(&WorkerPool::work, this);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(mutex_);
+        stopping_ = true;
+    }
+    task_condition_.notify_all();
+    for (std::thread& worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+int WorkerPool::size() const
+{
+    return workers_.size();
+}
+
+void WorkerPool::run(int nb_tasks, const std::function<void(int)>& task)
+{
+    // a batch must not be overwritten by another one before completion
+    std::lock_guard<std::mutex> run_guard(run_mutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
+    task_ = &task;
+    nb_tasks_ = nb_tasks;
+    next_task_ = 0;
+    nb_done_ = 0;
+    error_ = nullptr;
+    task_condition_.notify_all();
+    done_condition_.wait(lock, [this]() { return nb_done_ == nb_tasks_; });
+    task_ = nullptr;
+    nb_tasks_ = 0;
+    if (error_)
+    {
+        std::rethrow_exception(error_);
+    }
+}
+
+void WorkerPool::work()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        task_condition_.wait(
+            lock, [this]() { return stopping_ || next_task_ < nb_tasks_; });
+        if (stopping_)
+        {
+            return;
+        }
+        int index = next_task_++;
+        const std::function<void(int)>& task = *task_;
+        lock.unlock();
+        std::exception_ptr error = nullptr;
+        try
+        {
+            task(index);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        lock.lock();
+        if (error && !error_)
+        {
+            error_ = error;
+        }
+        nb_done_++;
+        if (nb_done_ == nb_tasks_)
+        {
+            done_condition_.notify_all();
+        }
+    }
+}
+}  // namespace internal
+}  // namespace o80
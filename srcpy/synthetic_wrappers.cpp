@@ -0,0 +1,32 @@
+#include "o80/pybind11_helper.hpp"
+#include "o80/synthetic_standalone.hpp"
+
+// bindings of SyntheticStandalone, for 1, 8 and 32 actuators
+// (submodules actuators_1, actuators_8 and actuators_32).
+// SyntheticDriverConfig and State1d are bound in the o80 module.
+
+#define QUEUE_SIZE 20000
+
+using namespace o80;
+
+template <int NB_ACTUATORS, typename... EXCLUDED_CLASSES>
+void add_submodule(pybind11::module& m)
+{
+    typedef SyntheticStandalone<QUEUE_SIZE, NB_ACTUATORS> standalone;
+    pybind11::module sub =
+        m.def_submodule(("actuators_" + std::to_string(NB_ACTUATORS)).c_str());
+    create_python_bindings<standalone, NO_STATE, EXCLUDED_CLASSES...>(sub);
+    create_standalone_python_bindings<SyntheticDriver,
+                                      standalone,
+                                      SyntheticDriverConfig>(sub);
+}
+
+PYBIND11_MODULE(o80_synthetic, m)
+{
+    pybind11::module::import("o80");
+    // the extended state and the introspector do not depend on the
+    // number of actuators, so they are bound only once
+    add_submodule<1>(m);
+    add_submodule<8, NO_EXTENDED_STATE, NO_INTROSPECTOR>(m);
+    add_submodule<32, NO_EXTENDED_STATE, NO_INTROSPECTOR>(m);
+}
@@ -1,17 +1,26 @@
 #include "o80/back_end.hpp"
 #include "o80/bool_state.hpp"
 #include "o80/burster.hpp"
+#include "o80/command_trace.hpp"
 #include "o80/command_types.hpp"
 #include "o80/frequency_manager.hpp"
 #include "o80/frequency_measure.hpp"
+#include "o80/introspection_event.hpp"
 #include "o80/item3d_state.hpp"
 #include "o80/memory_clearing.hpp"
+#include "o80/readiness.hpp"
+#include "o80/real_time_config.hpp"
+#include "o80/segment_join.hpp"
+#include "o80/segment_layout.hpp"
 #include "o80/pybind11_helper.hpp"
 #include "o80/state1d.hpp"
 #include "o80/state2d.hpp"
 #include "o80/state3d.hpp"
 #include "o80/state6d.hpp"
+#include "o80/synthetic_driver.hpp"
 #include "o80/time.hpp"
+#include "o80/tracer.hpp"
+#include "o80/transport.hpp"
 
 // are wrapped here only the non templated class if o80.
 // For bindings of templated classes, see o80/pybind_helper.hpp
@@ -28,17 +37,24 @@ PYBIND11_MODULE(o80, m)
         return time_diff(before, after);
     });
 
+    // opaque, see snapshot_standalone and restore_standalone
+    pybind11::class_<o80::internal::StandaloneSnapshotInterface,
+                     std::shared_ptr<o80::internal::StandaloneSnapshotInterface>>(
+        m, "StandaloneSnapshot");
+
     pybind11::class_<o80::Burster>(m, "Burster")
         .def(pybind11::init<std::string>())
-        .def("pulse", &Burster::pulse)
+        .def("pulse", &Burster::pulse, internal::release_gil())
         .def("clear_memory", &Burster::clear_memory)
         .def("turn_on", &Burster::turn_on)
         .def("turn_off", &Burster::turn_off);
 
     pybind11::class_<o80::BursterClient>(m, "BursterClient")
         .def(pybind11::init<std::string>())
-        .def("burst", &BursterClient::burst)
-        .def("final_burst", &BursterClient::final_burst);
+        .def("burst", &BursterClient::burst, internal::release_gil())
+        .def("final_burst",
+             &BursterClient::final_burst,
+             internal::release_gil());
 
     pybind11::class_<o80::BoolState>(m, "BoolState")
         .def(pybind11::init<bool>())
@@ -70,6 +86,135 @@ PYBIND11_MODULE(o80, m)
         .value("QUEUE", o80::QUEUE)
         .value("OVERWRITE", o80::OVERWRITE);
 
+    pybind11::enum_<o80::TransportType>(m, "TransportType")
+        .value("SHARED_MEMORY", o80::SHARED_MEMORY)
+        .value("IN_PROCESS", o80::IN_PROCESS)
+        .value("SHARED_REGION", o80::SHARED_REGION);
+
+    pybind11::enum_<o80::ReadinessEvent>(
+        m, "ReadinessEvent", pybind11::arithmetic())
+        .value("OBSERVATION", o80::READY_OBSERVATION)
+        .value("COMPLETION", o80::READY_COMPLETION)
+        .value("BURST", o80::READY_BURST);
+
+    pybind11::enum_<o80::JoinMode>(m, "JoinMode")
+        .value("NEAREST_SAMPLE", o80::NEAREST_SAMPLE)
+        .value("INTERPOLATED", o80::INTERPOLATED);
+
+    pybind11::class_<o80::SegmentLayout>(m, "SegmentLayout")
+        .def(pybind11::init<>())
+        .def(pybind11::init<std::size_t>())
+        .def(pybind11::init<std::size_t, std::size_t, std::size_t, std::size_t>())
+        .def(pybind11::init<std::size_t,
+                            std::size_t,
+                            std::size_t,
+                            std::size_t,
+                            std::size_t>())
+        .def_readwrite("commands_size", &SegmentLayout::commands_size)
+        .def_readwrite("observations_size", &SegmentLayout::observations_size)
+        .def_readwrite("completed_size", &SegmentLayout::completed_size)
+        .def_readwrite("introspection_size",
+                       &SegmentLayout::introspection_size)
+        .def_readwrite("trace_size", &SegmentLayout::trace_size)
+        .def_readwrite("huge_pages", &SegmentLayout::huge_pages)
+        .def_readwrite("prefault", &SegmentLayout::prefault)
+        .def("has_introspection", &SegmentLayout::has_introspection)
+        .def("has_traces", &SegmentLayout::has_traces)
+        .def("__str__", &SegmentLayout::to_string);
+
+    pybind11::enum_<o80::CommandEvent>(m, "CommandEvent")
+        .value("SHARED", o80::COMMAND_SHARED)
+        .value("RECEIVED", o80::COMMAND_RECEIVED)
+        .value("STARTING", o80::COMMAND_STARTING)
+        .value("COMPLETED", o80::COMMAND_COMPLETED)
+        .value("WAITED_FOR", o80::COMMAND_WAITED_FOR)
+        .value("REPORTED", o80::COMMAND_REPORTED);
+
+    pybind11::enum_<o80::IntrospectionFormat>(m, "IntrospectionFormat")
+        .value("CSV", o80::INTROSPECTION_CSV)
+        .value("BINARY", o80::INTROSPECTION_BINARY);
+
+    pybind11::class_<o80::IntrospectionEvent>(m, "IntrospectionEvent")
+        .def(pybind11::init<>())
+        .def_readonly("timestamp_ms", &IntrospectionEvent::timestamp_ms)
+        .def_readonly("command_id", &IntrospectionEvent::command_id)
+        .def_readonly("event", &IntrospectionEvent::event)
+        .def_readonly("actuator", &IntrospectionEvent::actuator)
+        .def_static("read_file", &IntrospectionEvent::read_file)
+        .def("__str__", &IntrospectionEvent::to_string);
+
+    pybind11::class_<o80::CommandTrace>(m, "CommandTrace")
+        .def(pybind11::init<>())
+        .def_readonly("command_id", &CommandTrace::command_id)
+        .def_property_readonly("event", &CommandTrace::get_event)
+        .def_readonly("iteration", &CommandTrace::iteration)
+        .def_readonly("stamp_ns", &CommandTrace::stamp_ns)
+        .def("__str__", &CommandTrace::to_string);
+
+    pybind11::class_<o80::LatencyStats>(m, "LatencyStats")
+        .def(pybind11::init<std::vector<double>>())
+        .def_readonly("count", &LatencyStats::count)
+        .def_readonly("min", &LatencyStats::min)
+        .def_readonly("mean", &LatencyStats::mean)
+        .def_readonly("median", &LatencyStats::median)
+        .def_readonly("p90", &LatencyStats::p90)
+        .def_readonly("p99", &LatencyStats::p99)
+        .def_readonly("max", &LatencyStats::max)
+        .def("__str__", &LatencyStats::to_string);
+
+    pybind11::class_<o80::CommandLatencies>(m, "CommandLatencies")
+        .def(pybind11::init<const std::vector<CommandTrace>&>())
+        .def("nb_commands", &CommandLatencies::nb_commands)
+        .def("pickup", &CommandLatencies::pickup)
+        .def("queueing", &CommandLatencies::queueing)
+        .def("start", &CommandLatencies::start)
+        .def("execution", &CommandLatencies::execution)
+        .def("total", &CommandLatencies::total)
+        .def("__str__", &CommandLatencies::to_string);
+
+    pybind11::class_<o80::TraceReader>(m, "TraceReader")
+        .def(pybind11::init<std::string>())
+        .def("read", &TraceReader::read)
+        .def("collect", &TraceReader::collect)
+        .def("nb_dropped", &TraceReader::nb_dropped);
+
+    pybind11::enum_<o80::SchedulingPolicy>(m, "SchedulingPolicy")
+        .value("FIFO", o80::FIFO_POLICY)
+        .value("ROUND_ROBIN", o80::ROUND_ROBIN_POLICY)
+        .value("OTHER", o80::OTHER_POLICY);
+
+    pybind11::class_<o80::RealTimeConfig>(m, "RealTimeConfig")
+        .def(pybind11::init<>())
+        .def_readwrite("cpus", &RealTimeConfig::cpus)
+        .def_readwrite("policy", &RealTimeConfig::policy)
+        .def_readwrite("priority", &RealTimeConfig::priority)
+        .def_readwrite("lock_memory", &RealTimeConfig::lock_memory)
+        .def_readwrite("stack_prefault_size",
+                       &RealTimeConfig::stack_prefault_size)
+        .def_readwrite("touch_segments", &RealTimeConfig::touch_segments)
+        .def_readwrite("pipelined_io", &RealTimeConfig::pipelined_io)
+        .def_static("touch_segment_pages",
+                    &RealTimeConfig::touch_segment_pages);
+
+    pybind11::enum_<o80::JitterDistribution>(m, "JitterDistribution")
+        .value("NO_JITTER", o80::NO_JITTER)
+        .value("UNIFORM_JITTER", o80::UNIFORM_JITTER)
+        .value("NORMAL_JITTER", o80::NORMAL_JITTER)
+        .value("EXPONENTIAL_JITTER", o80::EXPONENTIAL_JITTER);
+
+    pybind11::class_<o80::SyntheticDriverConfig>(m, "SyntheticDriverConfig")
+        .def(pybind11::init<>())
+        .def_readwrite("get_us", &SyntheticDriverConfig::get_us)
+        .def_readwrite("set_us", &SyntheticDriverConfig::set_us)
+        .def_readwrite("jitter", &SyntheticDriverConfig::jitter)
+        .def_readwrite("jitter_us", &SyntheticDriverConfig::jitter_us)
+        .def_readwrite("stall_probability",
+                       &SyntheticDriverConfig::stall_probability)
+        .def_readwrite("stall_us", &SyntheticDriverConfig::stall_us)
+        .def_readwrite("busy_wait", &SyntheticDriverConfig::busy_wait)
+        .def_readwrite("seed", &SyntheticDriverConfig::seed)
+        .def("__str__", &SyntheticDriverConfig::to_string);
+
     pybind11::enum_<o80::Type>(m, "Type")
         .value("DURATION", o80::DURATION)
         .value("SPEED", o80::SPEED)
@@ -89,13 +234,25 @@ PYBIND11_MODULE(o80, m)
         .value("BACKEND_WRITE_REAPPLY", o80::BACKEND_WRITE_REAPPLY)
         .value("BACKEND_WRITE_NEW", o80::BACKEND_WRITE_NEW);
 
+    pybind11::class_<o80::Tracer>(m, "Tracer")
+        .def_static("start",
+                    &Tracer::start,
+                    pybind11::arg("path"),
+                    pybind11::arg("ring_size") = 65536,
+                    pybind11::arg("period_ms") = 10.)
+        .def_static("stop", &Tracer::stop, internal::release_gil())
+        .def_static("is_running", &Tracer::is_running)
+        .def_static("nb_records", &Tracer::nb_records)
+        .def_static("nb_dropped", &Tracer::nb_dropped)
+        .def_static("export_chrome_trace", &Tracer::export_chrome_trace);
+
     pybind11::class_<o80::FrequencyMeasure>(m, "FrequencyMeasure")
         .def(pybind11::init<>())
         .def("tick", &FrequencyMeasure::tick);
 
     pybind11::class_<o80::FrequencyManager>(m, "FrequencyManager")
         .def(pybind11::init<double>())
-        .def("wait", &FrequencyManager::wait);
+        .def("wait", &FrequencyManager::wait, internal::release_gil());
 
     pybind11::class_<o80::State1d>(m, "State1d")
         .def(pybind11::init<>())